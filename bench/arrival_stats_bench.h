@@ -0,0 +1,40 @@
+#pragma once
+
+#include "bench.h"
+#include "captures.h"
+#include "ld2410_arrival_stats.h"
+
+using namespace ld2410;
+
+namespace bench {
+    // Frames per second read_from_reader_many decodes from capture with observer.
+    template <typename TObserver>
+    double observed_throughput(const std::vector<uint8_t> &capture, TObserver &observer) {
+        size_t frames = 0;
+        double seconds = 0;
+        Stopwatch watch;
+        do {
+            BufferReader reader{capture.data(), capture.size()};
+            while(!reader.overrun()) {
+                auto frame = read_from_reader_many<EngineeringModeDataFrame, ReportingDataFrame>(reader, observer);
+                if (frame.has_value()) ++frames;
+                keep(frame);
+            }
+            seconds = watch.seconds();
+        } while(seconds < 0.5);
+        return frames / seconds;
+    }
+}
+
+LD2410_BENCH(arrival_stats_overhead) {
+    std::vector<uint8_t> capture = bench::mixed_capture(10000);
+
+    NullDecoderObserver none;
+    double plain = bench::observed_throughput(capture, none);
+    std::printf("  no observer      %14.0f frames/s\n", plain);
+
+    ArrivalTracker<> tracker;
+    double tracked = bench::observed_throughput(capture, tracker);
+    std::printf("  ArrivalTracker   %14.0f frames/s %6.2fx\n", tracked, tracked / plain);
+    bench::keep(tracker.jitter());
+}
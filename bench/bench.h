@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// A minimal benchmark registry, host only. A benchmark is a function that
+// times what it wants with Stopwatch and prints its results with report():
+//
+//   LD2410_BENCH(decode_reporting_frames) {
+//       Stopwatch watch;
+//       ...
+//       report("frames", frames, watch.seconds());
+//   }
+//
+// bench_main.cpp runs all of them or those named on the command line.
+
+namespace bench {
+    struct Benchmark {
+        const char *name;
+        void (*run)();
+    };
+
+    inline std::vector<Benchmark> &benchmarks() {
+        static std::vector<Benchmark> all;
+        return all;
+    }
+
+    struct Registrar {
+        Registrar(const char *name, void (*run)()) {
+            benchmarks().push_back({name, run});
+        }
+    };
+
+    class Stopwatch {
+        std::chrono::steady_clock::time_point m_started = std::chrono::steady_clock::now();
+
+    public:
+        double seconds() const {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_started).count();
+        }
+    };
+
+    // one result line, items per second and the time per item
+    inline void report(const char *what, double items, double seconds) {
+        std::printf("  %-40s %14.0f /s %12.1f ns\n", what, items / seconds, seconds * 1e9 / items);
+    }
+
+    // Calls f() until at least min_seconds passed, returns calls per second.
+    template <typename F>
+    double repeat(F f, double min_seconds = 0.5) {
+        Stopwatch watch;
+        size_t calls = 0;
+        do {
+            for(int i = 0; i < 64; ++i) f();
+            calls += 64;
+        } while(watch.seconds() < min_seconds);
+        return calls / watch.seconds();
+    }
+
+    // keeps the compiler from dropping a computed value
+    template <typename T>
+    void keep(const T &value) {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+}
+
+#define LD2410_BENCH(name) \
+static void bench_##name(); \
+static bench::Registrar bench_registrar_##name{#name, bench_##name}; \
+static void bench_##name()
@@ -0,0 +1,42 @@
+// Benchmarks of the host side of the library, see bench.h.
+//
+//   g++ -std=gnu++17 -O2 -pthread -DLD2410_NO_ARDUINO -Iinclude -Itest bench/bench_main.cpp -o ld2410_bench
+//   ./ld2410_bench                            # all of them
+//   ./ld2410_bench sharded_runtime_scaling   # only those named
+//
+// With liburing 2.6 or newer add -luring to compare io_uring against epoll.
+//
+// Numbers depend on the machine, compare runs on the same one.
+
+#include <cstring>
+
+#include "arrival_stats_bench.h"
+#include "bench.h"
+#include "broadcast_ring_bench.h"
+#include "decode_pipeline_bench.h"
+#include "discovery_bench.h"
+#include "dispatch_bench.h"
+#include "fleet_config_bench.h"
+#include "gate_bounds_bench.h"
+#include "packet_views_bench.h"
+#include "reader_bench.h"
+#include "serial_transport_bench.h"
+#include "serialize_bench.h"
+#include "shared_frames_bench.h"
+#include "sharded_runtime_bench.h"
+#include "subscription_bench.h"
+#include "zones_bench.h"
+
+int main(int argc, char **argv) {
+    for(const auto &benchmark : bench::benchmarks()) {
+        bool selected = argc < 2;
+        for(int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], benchmark.name) == 0) selected = true;
+        }
+        if (!selected) continue;
+
+        std::printf("%s\n", benchmark.name);
+        benchmark.run();
+    }
+    return 0;
+}
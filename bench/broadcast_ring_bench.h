@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "ld2410_broadcast_ring.h"
+#include "ld2410_packets.h"
+
+using namespace ld2410;
+
+namespace bench {
+    const uint32_t ring_frames = 400000;
+
+    struct StampedFrame {
+        int64_t published_ns;
+        ReportingDataFrame frame;
+    };
+
+    inline int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // value at p of sorted samples, p from 0 to 1
+    inline double percentile(std::vector<int64_t> &samples, double p) {
+        if (samples.empty()) return 0;
+        size_t at = std::min(samples.size() - 1, (size_t)(p * samples.size()));
+        std::nth_element(samples.begin(), samples.begin() + at, samples.end());
+        return (double)samples[at];
+    }
+
+    // One producer publishing to consumers reading concurrently, as fast as it
+    // can with a rate of 0 or rate frames per second otherwise.
+    inline void broadcast_ring_run(size_t consumers, double rate) {
+        BroadcastRing<StampedFrame, 1024> ring;
+        std::atomic<bool> done{false};
+        std::vector<std::vector<int64_t>> latencies(consumers);
+        std::vector<uint32_t> lost(consumers);
+
+        std::vector<std::thread> threads;
+        std::atomic<size_t> ready{0};
+        for(size_t c = 0; c < consumers; ++c) {
+            threads.emplace_back([&, c]() {
+                auto consumer = ring.consumer();
+                auto &samples = latencies[c];
+                samples.reserve(ring_frames);
+                ready.fetch_add(1);
+
+                StampedFrame stamped;
+                while(true) {
+                    if (consumer.read(stamped)) {
+                        samples.push_back(now_ns() - stamped.published_ns);
+                        continue;
+                    }
+                    if (done.load(std::memory_order_acquire) && consumer.pending() == 0) break;
+                    std::this_thread::yield();
+                }
+                lost[c] = consumer.lost();
+            });
+        }
+        while(ready.load() < consumers) std::this_thread::yield();
+
+        StampedFrame stamped{};
+        stamped.frame.target_state(1);
+        Stopwatch watch;
+        for(uint32_t i = 0; i < ring_frames; ++i) {
+            while(rate != 0 && watch.seconds() * rate < i) std::this_thread::yield();
+            stamped.frame.movement_target_distance((uint16_t)i);
+            stamped.published_ns = now_ns();
+            ring.publish(stamped);
+        }
+        double seconds = watch.seconds();
+        done.store(true, std::memory_order_release);
+        for(auto &thread : threads) {
+            thread.join();
+        }
+
+        std::vector<int64_t> all;
+        size_t total_lost = 0;
+        for(size_t c = 0; c < consumers; ++c) {
+            all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+            total_lost += lost[c];
+        }
+        double p99 = percentile(all, 0.99);
+        double p999 = percentile(all, 0.999);
+        std::printf("  %zu consumers %10.0f frames/s   p99 %10.0f ns   p999 %10.0f ns   lost %5.1f %%\n",
+            consumers, ring_frames / seconds, p99, p999, 100.0 * total_lost / ((double)ring_frames * consumers));
+    }
+}
+
+LD2410_BENCH(broadcast_ring_fan_out) {
+    // a gateway of many sensors, then a producer that never pauses
+    for(double rate : {100000.0, 0.0}) {
+        std::printf("  %s\n", rate != 0 ? "paced at 100000 frames/s" : "unpaced");
+        for(size_t consumers : {1, 2, 4, 8}) {
+            bench::broadcast_ring_run(consumers, rate);
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Recorded bytes the benchmarks feed to the decoder.
+
+namespace bench {
+    // the 23 bytes of a reporting frame
+    const uint8_t reporting_frame[] = {0xF4, 0xF3, 0xF2, 0xF1, 0x0D, 0x00, 0x02, 0xAA,
+        0x01, 0x96, 0x00, 0x20, 0x00, 0x00, 0x00, 0x10, 0x00, 0x55, 0x00,
+        0xF8, 0xF7, 0xF6, 0xF5};
+
+    // the 45 bytes of an engineering mode frame with 9 gates
+    const uint8_t engineering_frame[] = {0xF4, 0xF3, 0xF2, 0xF1, 0x23, 0x00, 0x01, 0xAA,
+        0x03, 0x1E, 0x00, 0x3C, 0x00, 0x00, 0x39, 0x00, 0x00, 0x08, 0x08, 0x3C,
+        0x22, 0x05, 0x03, 0x03, 0x04, 0x03, 0x06, 0x05, 0x00, 0x00, 0x39, 0x10,
+        0x13, 0x06, 0x06, 0x08, 0x04, 0x03, 0x05, 0x55, 0x00, 0xF8, 0xF7, 0xF6,
+        0xF5};
+
+    // the reporting frame, batch times
+    inline std::vector<uint8_t> reporting_frames(size_t batch) {
+        std::vector<uint8_t> bytes;
+        for(size_t i = 0; i < batch; ++i) bytes.insert(bytes.end(), reporting_frame, reporting_frame + sizeof(reporting_frame));
+        return bytes;
+    }
+
+    // pairs of both frames with a few bytes of line noise in between
+    inline std::vector<uint8_t> mixed_capture(size_t pairs) {
+        const uint8_t noise[] = {0x00, 0xF4, 0xF3, 0x13};
+        std::vector<uint8_t> bytes;
+        bytes.reserve(pairs * (sizeof(reporting_frame) + sizeof(noise) + sizeof(engineering_frame)));
+        for(size_t i = 0; i < pairs; ++i) {
+            bytes.insert(bytes.end(), reporting_frame, reporting_frame + sizeof(reporting_frame));
+            bytes.insert(bytes.end(), noise, noise + sizeof(noise));
+            bytes.insert(bytes.end(), engineering_frame, engineering_frame + sizeof(engineering_frame));
+        }
+        return bytes;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <algorithm>
+#include <thread>
+
+#include "bench.h"
+#include "captures.h"
+#include "ld2410_decode_pipeline.h"
+
+using namespace ld2410;
+
+LD2410_BENCH(decode_parallel_scaling) {
+    // about 29 MB, 800000 frames
+    const size_t pairs = 400000;
+    std::vector<uint8_t> capture = bench::mixed_capture(pairs);
+
+    // the sequential pull parser as the baseline
+    bench::Stopwatch watch;
+    BufferReader reader{capture.data(), capture.size()};
+    size_t frames = 0;
+    while(!reader.overrun()) {
+        auto frame = read_from_reader_many<EngineeringModeDataFrame, ReportingDataFrame>(reader);
+        if (frame.has_value()) ++frames;
+        bench::keep(frame);
+    }
+    double sequential = frames / watch.seconds();
+    std::printf("  read_from_reader_many     %14.0f frames/s\n", sequential);
+
+    size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+    for(size_t threads = 1; threads <= std::max<size_t>(cores, 8); threads *= 2) {
+        DecodePipelineOptions options;
+        options.threads = threads;
+        bench::Stopwatch parallel_watch;
+        auto decoded = decode_parallel<EngineeringModeDataFrame, ReportingDataFrame>(capture.data(), capture.size(), options);
+        double rate = decoded.size() / parallel_watch.seconds();
+        std::printf("  %2zu threads %14.0f frames/s %6.2fx\n", threads, rate, rate / sequential);
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <deque>
+
+#include "bench.h"
+#include "ld2410_discovery.h"
+#include "pty_sensor.h"
+
+using namespace ld2410;
+
+LD2410_BENCH(discovery_cold_start) {
+    // modules reporting at 10 Hz behind ptys, every fourth one at the second rate tried
+    for(size_t count : {8, 32, 128}) {
+        std::deque<PtySensorPort> ports(count);
+        for(size_t i = 0; i < count; ++i) {
+            if (i % 4 == 3) ports[i].sensor.baud = watchdog_rescan_order[1];
+        }
+        PtySensorServer server{ports};
+
+        bench::Stopwatch watch;
+        auto sensors = discover_sensors(ports, count);
+        double seconds = watch.seconds();
+
+        size_t found = 0;
+        for(const auto &sensor : sensors) {
+            if (sensor.found) ++found;
+        }
+        std::printf("  %3zu ports, %3zu found %10.0f ms\n", count, found, seconds * 1000);
+    }
+}
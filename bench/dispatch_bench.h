@@ -0,0 +1,73 @@
+#pragma once
+
+#include <variant>
+
+#include "bench.h"
+#include "captures.h"
+#include "ld2410_dispatch.h"
+
+using namespace ld2410;
+
+namespace bench {
+    // Frames per second read_frame(reader, sum) handles from capture, sum
+    // collects a field of every frame.
+    template <typename F>
+    double dispatch_throughput(const std::vector<uint8_t> &capture, F read_frame) {
+        size_t frames = 0;
+        uint32_t sum = 0;
+        double seconds = 0;
+        Stopwatch watch;
+        do {
+            BufferReader reader{capture.data(), capture.size()};
+            while(!reader.overrun()) {
+                if (read_frame(reader, sum)) ++frames;
+            }
+            seconds = watch.seconds();
+        } while(seconds < 0.5);
+        keep(sum);
+        return frames / seconds;
+    }
+}
+
+LD2410_BENCH(dispatch_vs_variant) {
+    std::vector<uint8_t> capture = bench::mixed_capture(10000);
+
+    // what applications wrote before the dispatcher
+    double variant = bench::dispatch_throughput(capture, [](BufferReader &reader, uint32_t &sum) {
+        auto frame = read_from_reader_many<ReportingDataFrame, EngineeringModeDataFrame>(reader);
+        if (!frame.has_value()) return false;
+        if (std::holds_alternative<ReportingDataFrame>(*frame)) {
+            ReportingDataFrame reporting = std::get<ReportingDataFrame>(*frame);
+            sum += reporting.movement_target_distance();
+        } else if (std::holds_alternative<EngineeringModeDataFrame>(*frame)) {
+            EngineeringModeDataFrame engineering = std::get<EngineeringModeDataFrame>(*frame);
+            sum += engineering.detection_distance();
+        }
+        return true;
+    });
+    std::printf("  variant, holds_alternative  %14.0f frames/s\n", variant);
+
+    double visited = bench::dispatch_throughput(capture, [](BufferReader &reader, uint32_t &sum) {
+        auto frame = read_from_reader_many<ReportingDataFrame, EngineeringModeDataFrame>(reader);
+        if (!frame.has_value()) return false;
+        std::visit([&](const auto &packet) {
+            if constexpr (std::is_same<std::decay_t<decltype(packet)>, ReportingDataFrame>::value) {
+                sum += packet.movement_target_distance();
+            } else {
+                sum += packet.detection_distance();
+            }
+        }, *frame);
+        return true;
+    });
+    std::printf("  variant, std::visit         %14.0f frames/s %6.2fx\n", visited, visited / variant);
+
+    uint32_t dispatched_sum = 0;
+    auto dispatcher = make_dispatcher(
+        [&](const ReportingDataFrame &frame) { dispatched_sum += frame.movement_target_distance(); },
+        [&](const EngineeringModeDataFrame &frame) { dispatched_sum += frame.detection_distance(); });
+    double dispatched = bench::dispatch_throughput(capture, [&](BufferReader &reader, uint32_t &) {
+        return dispatcher.read(reader);
+    });
+    bench::keep(dispatched_sum);
+    std::printf("  PacketDispatcher            %14.0f frames/s %6.2fx\n", dispatched, dispatched / variant);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <thread>
+
+#include "bench.h"
+#include "ld2410_fleet_config.h"
+#include "simulated_sensor.h"
+
+using namespace ld2410;
+
+namespace bench {
+    const size_t fleet_sensors = 200;
+    // from writing a command to its ack, UART and module included
+    const std::chrono::milliseconds fleet_ack_latency{5};
+
+    // A simulated sensor whose every command takes fleet_ack_latency to be answered.
+    class LaggingSensor {
+        SimulatedSensor m_sensor;
+
+    public:
+        class Writer {
+            SimulatedSensor *m_sensor;
+
+        public:
+            explicit Writer(SimulatedSensor &sensor): m_sensor(&sensor) {
+
+            }
+
+            // a command arrives in several writes, the one completing it waits
+            void operator()(const uint8_t *data, size_t size) {
+                size_t commands = m_sensor->received_commands.size();
+                m_sensor->write(data, size);
+                if (m_sensor->received_commands.size() != commands) std::this_thread::sleep_for(fleet_ack_latency);
+            }
+        };
+
+        SimulatedSensor::Reader reader() {
+            return m_sensor.reader();
+        }
+
+        Writer writer() {
+            return Writer{m_sensor};
+        }
+
+        SimulatedSensor &sensor() {
+            return m_sensor;
+        }
+    };
+
+    // the parameters of a simulated sensor, with three of them changed
+    inline SensorConfig retuned(SimulatedSensor &sensor) {
+        SensorConfig config;
+        config.maximum_moving_distance_gate = sensor.max_moving_gate;
+        config.maximum_static_distance_gate = sensor.max_static_gate;
+        config.no_one_duration = 30;
+        for(size_t i = 0; i < config_gate_count; ++i) {
+            config.motion_sensitivity[i] = sensor.motion_sensitivity[i];
+            config.static_sensitivity[i] = sensor.static_sensitivity[i];
+        }
+        config.motion_sensitivity[2] = 25;
+        config.static_sensitivity[6] = 35;
+        return config;
+    }
+}
+
+LD2410_BENCH(fleet_retune) {
+    std::printf("  %zu sensors, %lld ms per command\n", bench::fleet_sensors, (long long)bench::fleet_ack_latency.count());
+    double one_by_one = 0;
+    for(size_t concurrency : {1, 8, 32, 64, 200}) {
+        std::deque<bench::LaggingSensor> sensors(bench::fleet_sensors);
+        SensorConfig desired = bench::retuned(sensors[0].sensor());
+
+        FleetOptions options;
+        options.concurrency = concurrency;
+        bench::Stopwatch watch;
+        FleetReport report = apply_fleet_config(sensors, sensors.size(), desired, options);
+        double seconds = watch.seconds();
+        if (concurrency == 1) one_by_one = seconds;
+
+        std::printf("  concurrency %3zu %8.2f s %7.1fx  %zu of %zu applied\n", concurrency, seconds, one_by_one / seconds,
+            report.count(FleetOutcome::applied), report.sensors.size());
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "bench.h"
+#include "captures.h"
+#include "ld2410_packet_reader.h"
+
+using namespace ld2410;
+
+namespace bench {
+    // the engineering frame with its movement gate count replaced by count
+    inline std::vector<uint8_t> engineering_frame_with_gate_count(uint8_t count) {
+        std::vector<uint8_t> bytes(engineering_frame, engineering_frame + sizeof(engineering_frame));
+        bytes[17] = count;
+        return bytes;
+    }
+}
+
+LD2410_BENCH(gate_bounds_worst_case) {
+    std::printf("  sizeof(EngineeringModeDataFrame)  %zu bytes, no allocation for any gate count\n", sizeof(EngineeringModeDataFrame));
+
+    // a whole frame from the wire, once with 8 gates and once with a corrupted count
+    for(uint8_t count : {uint8_t(8), uint8_t(0x20), uint8_t(0xff)}) {
+        std::vector<uint8_t> bytes = bench::engineering_frame_with_gate_count(count);
+        size_t decoded = 0;
+        double per_second = bench::repeat([&] {
+            BufferReader reader{bytes.data(), bytes.size()};
+            auto frame = read_from_reader_many<EngineeringModeDataFrame>(reader);
+            if (frame.has_value()) ++decoded;
+            bench::keep(frame);
+        });
+        std::printf("  gate count %3u  %s  %14.0f frames/s %8.1f ns\n", count,
+            decoded ? "decoded " : "rejected", per_second, 1e9 / per_second);
+    }
+
+    // a corrupted frame in every pair costs no more than a good one
+    std::vector<uint8_t> corrupted = bench::engineering_frame_with_gate_count(0xff);
+    std::vector<uint8_t> capture;
+    for(int i = 0; i < 10000; ++i) {
+        capture.insert(capture.end(), bench::engineering_frame, bench::engineering_frame + sizeof(bench::engineering_frame));
+        capture.insert(capture.end(), corrupted.begin(), corrupted.end());
+    }
+    size_t frames = 0;
+    size_t passes = 0;
+    bench::Stopwatch watch;
+    do {
+        BufferReader reader{capture.data(), capture.size()};
+        while(!reader.overrun()) {
+            auto frame = read_from_reader_many<EngineeringModeDataFrame>(reader);
+            if (frame.has_value()) ++frames;
+            bench::keep(frame);
+        }
+        ++passes;
+    } while(watch.seconds() < 0.5);
+    double seconds = watch.seconds();
+    bench::report("frames, every 2nd corrupted", passes * 20000, seconds);
+    std::printf("  %zu of %zu frames decoded\n", frames, passes * 20000);
+}
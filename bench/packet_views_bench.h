@@ -0,0 +1,69 @@
+#pragma once
+
+#include "bench.h"
+#include "captures.h"
+#include "ld2410_packet_views.h"
+
+using namespace ld2410;
+
+namespace bench {
+    // Frames per second of read_frame(reader, sum) over capture, sum collects what was read.
+    template <typename F>
+    double view_throughput(const std::vector<uint8_t> &capture, F read_frame) {
+        size_t frames = 0;
+        uint32_t sum = 0;
+        double seconds = 0;
+        Stopwatch watch;
+        do {
+            BufferReader reader{capture.data(), capture.size()};
+            while(!reader.overrun()) {
+                if (read_frame(reader, sum)) ++frames;
+            }
+            seconds = watch.seconds();
+        } while(seconds < 0.5);
+        keep(sum);
+        return frames / seconds;
+    }
+}
+
+LD2410_BENCH(packet_views_vs_decode) {
+    std::vector<uint8_t> capture;
+    for(int i = 0; i < 10000; ++i) {
+        capture.insert(capture.end(), bench::engineering_frame, bench::engineering_frame + sizeof(bench::engineering_frame));
+    }
+
+    // the distance and every gate energy
+    double decoded = bench::view_throughput(capture, [](BufferReader &reader, uint32_t &sum) {
+        auto frame = read_from_reader_many<EngineeringModeDataFrame>(reader);
+        if (!frame.has_value()) return false;
+        const auto &engineering = std::get<EngineeringModeDataFrame>(*frame);
+        sum += engineering.detection_distance();
+        for(uint8_t energy : engineering.movement_distance_gate_energy_value()) sum += energy;
+        for(uint8_t energy : engineering.static_distance_gate_energy_value()) sum += energy;
+        return true;
+    });
+    std::printf("  decode, all fields       %14.0f frames/s\n", decoded);
+
+    double viewed = bench::view_throughput(capture, [](BufferReader &reader, uint32_t &sum) {
+        auto frame = read_raw_frame<EngineeringModeDataFrame>(reader);
+        if (!frame.has_value()) return false;
+        EngineeringModeDataFrameView view{*frame};
+        if (!view.valid()) return false;
+        sum += view.detection_distance();
+        for(size_t gate = 0; gate < view.movement_gate_count(); ++gate) sum += view.movement_distance_gate_energy_value(gate);
+        for(size_t gate = 0; gate < view.static_gate_count(); ++gate) sum += view.static_distance_gate_energy_value(gate);
+        return true;
+    });
+    std::printf("  view, all fields         %14.0f frames/s %6.2fx\n", viewed, viewed / decoded);
+
+    // what presence logic usually needs
+    double target = bench::view_throughput(capture, [](BufferReader &reader, uint32_t &sum) {
+        auto frame = read_raw_frame<EngineeringModeDataFrame>(reader);
+        if (!frame.has_value()) return false;
+        EngineeringModeDataFrameView view{*frame};
+        if (!view.valid()) return false;
+        sum += view.target_state();
+        return true;
+    });
+    std::printf("  view, target state only  %14.0f frames/s %6.2fx\n", target, target / decoded);
+}
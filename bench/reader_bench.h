@@ -0,0 +1,45 @@
+#pragma once
+
+#include <functional>
+
+#include "bench.h"
+#include "captures.h"
+#include "ld2410_packet_reader.h"
+
+using namespace ld2410;
+
+namespace bench {
+    // Frames per second read_from_reader_many decodes from capture through a
+    // reader made by make_reader(BufferReader &).
+    template <typename F>
+    double reader_throughput(const std::vector<uint8_t> &capture, F make_reader) {
+        size_t frames = 0;
+        double seconds = 0;
+        // a few passes, the capture itself is small enough to stay in cache
+        Stopwatch watch;
+        do {
+            BufferReader buffer{capture.data(), capture.size()};
+            auto &&reader = make_reader(buffer);
+            while(!buffer.overrun()) {
+                auto frame = read_from_reader_many<EngineeringModeDataFrame, ReportingDataFrame>(reader);
+                if (frame.has_value()) ++frames;
+                keep(frame);
+            }
+            seconds = watch.seconds();
+        } while(seconds < 0.5);
+        return frames / seconds;
+    }
+}
+
+LD2410_BENCH(reader_type_erasure) {
+    std::vector<uint8_t> capture = bench::mixed_capture(10000);
+
+    double templated = bench::reader_throughput(capture, [](BufferReader &buffer) -> BufferReader & { return buffer; });
+    std::printf("  BufferReader, templated      %14.0f frames/s\n", templated);
+
+    double reference = bench::reader_throughput(capture, [](BufferReader &buffer) { return ReaderRef{buffer}; });
+    std::printf("  ReaderRef                    %14.0f frames/s %6.2fx\n", reference, reference / templated);
+
+    double function = bench::reader_throughput(capture, [](BufferReader &buffer) { return std::function<uint8_t()>{std::ref(buffer)}; });
+    std::printf("  std::function                %14.0f frames/s %6.2fx\n", function, function / templated);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "bench.h"
+#include "captures.h"
+#include "ld2410_frame_assembler.h"
+#include "ld2410_serial_transport.h"
+#include "raw_pty.h"
+
+using namespace ld2410;
+
+namespace bench {
+    const size_t transport_ports = 64;
+    const size_t transport_bytes_per_port = 1 << 20;
+
+    struct TransportRate {
+        double bytes;
+        double frames;
+    };
+
+    // Bytes and frames per second one transport reads and assembles from many
+    // ptys written at once.
+    template <typename TTransport>
+    TransportRate transport_throughput(TTransport &transport) {
+        std::vector<std::unique_ptr<RawPty>> ptys;
+        for(size_t i = 0; i < transport_ports; ++i) {
+            ptys.emplace_back(new RawPty);
+            if (!ptys.back()->valid() || transport.add(ptys.back()->master) < 0) return {0, 0};
+        }
+        std::vector<FrameAssembler<ReportingDataFrame>> assemblers(transport_ports);
+
+        // whole frames, the ptys still split them anywhere
+        std::vector<uint8_t> chunk = reporting_frames(22);
+        Stopwatch watch;
+        std::thread feeder([&]() {
+            for(size_t sent = 0; sent < transport_bytes_per_port; sent += chunk.size()) {
+                for(auto &pty : ptys) {
+                    if (::write(pty->slave, chunk.data(), chunk.size()) < 0) return;
+                }
+            }
+        });
+
+        size_t expected = transport_ports * transport_bytes_per_port;
+        size_t received = 0;
+        size_t frames = 0;
+        auto count = [&](const ReportingDataFrame &) { ++frames; };
+        while(received < expected && watch.seconds() < 30) {
+            int calls = transport.poll(100, [&](size_t sensor, const uint8_t *data, size_t size) {
+                received += size;
+                assemblers[sensor].push(data, size, count);
+            });
+            if (calls < 0) break;
+        }
+        double seconds = watch.seconds();
+        if (received < expected) {
+            // the feeder blocks on full ptys otherwise
+            for(auto &pty : ptys) {
+                close(pty->master);
+                pty->master = -1;
+            }
+        }
+        feeder.join();
+        return {received / seconds, frames / seconds};
+    }
+}
+
+LD2410_BENCH(serial_transport_epoll_vs_uring) {
+    {
+        EpollSerialTransport transport;
+        bench::TransportRate rate = transport.init() ? bench::transport_throughput(transport) : bench::TransportRate{0, 0};
+        std::printf("  epoll    %3zu ports %14.0f bytes/s %12.0f frames/s\n", bench::transport_ports, rate.bytes, rate.frames);
+    }
+#ifdef LD2410_HAS_IO_URING
+    UringSerialTransport transport;
+    if (transport.init()) {
+        bench::TransportRate rate = bench::transport_throughput(transport);
+        std::printf("  io_uring %3zu ports %14.0f bytes/s %12.0f frames/s\n", bench::transport_ports, rate.bytes, rate.frames);
+    } else {
+        std::printf("  io_uring not available on this kernel\n");
+    }
+#else
+    std::printf("  io_uring not built, needs liburing 2.6 and -luring\n");
+#endif
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "bench.h"
+#include "ld2410_serialize.h"
+
+using namespace ld2410;
+
+namespace bench {
+    inline EngineeringModeDataFrame serialize_frame() {
+        EngineeringModeDataFrame frame{};
+        frame.target_state(3);
+        frame.movement_target_distance(300);
+        frame.exercise_target_energy_value(60);
+        frame.stationary_target_distance(57);
+        frame.stationary_target_energy_value(100);
+        frame.detection_distance(57);
+        frame.maximum_moving_distance_gate_n(8);
+        frame.maximum_static_distance_gate_n(8);
+        frame.movement_distance_gate_energy_value({60, 34, 5, 3, 3, 4, 3, 6, 5});
+        frame.static_distance_gate_energy_value({0, 0, 57, 16, 19, 6, 6, 8, 4});
+        return frame;
+    }
+}
+
+LD2410_BENCH(serialize_engineering_mode_frame) {
+    EngineeringModeDataFrame frame = bench::serialize_frame();
+
+    char json[512];
+    size_t json_size = write_json(frame, json, sizeof(json));
+    double json_rate = bench::repeat([&]() {
+        bench::keep(frame);
+        bench::keep(write_json(frame, json, sizeof(json)));
+    });
+    std::printf("  json        %4zu bytes %14.0f frames/s %8.1f ns\n", json_size, json_rate, 1e9 / json_rate);
+
+    uint8_t msgpack[512];
+    size_t msgpack_size = write_msgpack(frame, msgpack, sizeof(msgpack));
+    double msgpack_rate = bench::repeat([&]() {
+        bench::keep(frame);
+        bench::keep(write_msgpack(frame, msgpack, sizeof(msgpack)));
+    });
+    std::printf("  msgpack     %4zu bytes %14.0f frames/s %8.1f ns\n", msgpack_size, msgpack_rate, 1e9 / msgpack_rate);
+}
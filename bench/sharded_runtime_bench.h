@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "bench.h"
+#include "captures.h"
+#include "ld2410_sharded_runtime.h"
+#include "raw_pty.h"
+
+using namespace ld2410;
+
+namespace bench {
+    const size_t runtime_sensors = 256;
+    const size_t runtime_frames_per_sensor = 2000;
+    const size_t runtime_feeders = 4;
+
+    struct NullFrameHandler {
+        template <typename T>
+        void operator()(size_t, const T &frame) {
+            keep(frame);
+        }
+    };
+
+    // Frames decoded per second by shards threads, all sensors sending at once.
+    // Every pty is fed by one of a few threads playing the sensors.
+    inline double sharded_runtime_throughput(size_t shards) {
+        std::vector<std::unique_ptr<RawPty>> ptys;
+        for(size_t i = 0; i < runtime_sensors; ++i) {
+            ptys.emplace_back(new RawPty);
+            if (!ptys.back()->valid()) return 0;
+        }
+
+        ShardedRuntimeOptions options;
+        options.shards = shards;
+        ShardedRuntime<NullFrameHandler, ReportingDataFrame> runtime{NullFrameHandler{}, options};
+        if (!runtime.start()) return 0;
+        for(auto &pty : ptys) {
+            runtime.add(pty->master);
+        }
+
+        const size_t batch = 8;
+        std::vector<uint8_t> frames = reporting_frames(batch);
+        Stopwatch watch;
+        std::vector<std::thread> feeders;
+        for(size_t f = 0; f < runtime_feeders; ++f) {
+            feeders.emplace_back([&, f]() {
+                for(size_t sent = 0; sent < runtime_frames_per_sensor; sent += batch) {
+                    for(size_t i = f; i < ptys.size(); i += runtime_feeders) {
+                        if (::write(ptys[i]->slave, frames.data(), frames.size()) < 0) return;
+                    }
+                }
+            });
+        }
+        for(auto &feeder : feeders) {
+            feeder.join();
+        }
+
+        size_t expected = runtime_sensors * runtime_frames_per_sensor;
+        size_t decoded = 0;
+        while(decoded < expected && watch.seconds() < 30) {
+            decoded = 0;
+            for(size_t i = 0; i < runtime_sensors; ++i) {
+                decoded += runtime.frames(i);
+            }
+            std::this_thread::yield();
+        }
+        double seconds = watch.seconds();
+        runtime.stop();
+        return decoded / seconds;
+    }
+}
+
+LD2410_BENCH(sharded_runtime_scaling) {
+    size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+    for(size_t shards = 1; shards <= std::max<size_t>(cores, 8); shards *= 2) {
+        double frames_per_second = bench::sharded_runtime_throughput(shards);
+        std::printf("  %3zu sensors, %2zu shards %14.0f frames/s\n", bench::runtime_sensors, shards, frames_per_second);
+    }
+}
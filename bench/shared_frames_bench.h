@@ -0,0 +1,166 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "broadcast_ring_bench.h"
+#include "ld2410_shared_frames.h"
+
+using namespace ld2410;
+
+namespace bench {
+    const uint32_t shared_frames = 20000;
+    const size_t max_reader_processes = 8;
+
+    // what a reader process reports back
+    struct SharedReaderResult {
+        double p50_ns;
+        double p99_ns;
+        uint64_t reads;
+        uint64_t frames;
+    };
+
+    // anonymous shared memory the benchmark itself uses between processes
+    struct SharedFramesControl {
+        std::atomic<uint32_t> ready;
+        std::atomic<bool> done;
+        SharedReaderResult results[max_reader_processes];
+        int64_t published_ns[shared_frames];
+    };
+
+    using shared_bench_region_t = SharedFrameRegion<1>;
+
+    // Runs in a forked reader process, polls the latest frame until the publisher is done.
+    inline void shared_frames_reader(const char *name, SharedFramesControl &control, size_t index) {
+        SharedMemory<shared_bench_region_t> shm;
+        if (!shm.open(name)) _exit(1);
+        std::vector<int64_t> latencies;
+        latencies.reserve(shared_frames);
+        control.ready.fetch_add(1);
+
+        uint64_t reads = 0;
+        uint32_t last = 0;
+        uint32_t sum = 0;
+        while(!control.done.load(std::memory_order_acquire)) {
+            uint8_t target_state = 0;
+            uint32_t sequence = shm->read(0, [&](const shared_data_frame_t &frame) {
+                target_state = std::get<ReportingDataFrame>(frame).target_state();
+            });
+            ++reads;
+            if (sequence == 0 || (sequence & 1) || sequence == last) {
+                sched_yield();
+                continue;
+            }
+            sum += target_state;
+            last = sequence;
+            latencies.push_back(now_ns() - control.published_ns[sequence / 2 - 1]);
+        }
+        keep(sum);
+
+        control.results[index] = {percentile(latencies, 0.5), percentile(latencies, 0.99), reads, latencies.size()};
+        _exit(0);
+    }
+
+    // One process publishing rate frames per second to readers processes.
+    inline void shared_frames_run(size_t readers, double rate) {
+        std::string name = "/ld2410-bench-" + std::to_string(getpid());
+        SharedMemory<shared_bench_region_t> shm;
+        if (!shm.create(name.c_str())) {
+            std::printf("  cannot create %s\n", name.c_str());
+            return;
+        }
+        void *mapped = mmap(nullptr, sizeof(SharedFramesControl), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mapped == MAP_FAILED) return;
+        SharedFramesControl &control = *new (mapped) SharedFramesControl();
+
+        std::vector<pid_t> children;
+        for(size_t r = 0; r < readers; ++r) {
+            pid_t child = fork();
+            if (child == 0) shared_frames_reader(name.c_str(), control, r);
+            if (child > 0) children.push_back(child);
+        }
+        while(control.ready.load() < children.size()) sched_yield();
+
+        Stopwatch watch;
+        for(uint32_t i = 0; i < shared_frames; ++i) {
+            while(watch.seconds() * rate < i) sched_yield();
+            control.published_ns[i] = now_ns();
+            shm->publish_in_place(0, [&](shared_data_frame_t &frame) {
+                auto &reporting = frame.emplace<ReportingDataFrame>();
+                reporting.target_state(1);
+                reporting.movement_target_distance((uint16_t)i);
+            });
+        }
+        double seconds = watch.seconds();
+        control.done.store(true, std::memory_order_release);
+
+        bool failed = false;
+        for(pid_t child : children) {
+            int status = 0;
+            waitpid(child, &status, 0);
+            failed |= !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+        }
+        SharedMemory<shared_bench_region_t>::unlink(name.c_str());
+
+        double p50 = 0, p99 = 0;
+        uint64_t reads = 0, frames = 0;
+        for(size_t r = 0; r < children.size(); ++r) {
+            p50 = std::max(p50, control.results[r].p50_ns);
+            p99 = std::max(p99, control.results[r].p99_ns);
+            reads += control.results[r].reads;
+            frames += control.results[r].frames;
+        }
+        std::printf("  %zu readers %s  %12.0f reads/s   seen %5.1f %%   p50 %9.0f ns   p99 %9.0f ns\n",
+            readers, failed ? "(failed)" : "", reads / seconds, 100.0 * frames / ((double)shared_frames * readers), p50, p99);
+        munmap(mapped, sizeof(SharedFramesControl));
+    }
+}
+
+LD2410_BENCH(shared_frames_processes) {
+    // cost of one read and one publish, in a single process
+    std::string name = "/ld2410-bench-" + std::to_string(getpid());
+    SharedMemory<bench::shared_bench_region_t> shm;
+    if (!shm.create(name.c_str())) return;
+    SharedMemory<bench::shared_bench_region_t>::unlink(name.c_str());
+    shm->publish(0, ReportingDataFrame{});
+
+    shared_data_frame_t copy;
+    double loads = bench::repeat([&] {
+        bench::keep(shm->load(0, copy));
+    });
+    bench::report("load(), copying the frame out", loads, 1);
+
+    double reads = bench::repeat([&] {
+        uint8_t target_state = 0;
+        bench::keep(shm->read(0, [&](const shared_data_frame_t &frame) {
+            target_state = std::get<ReportingDataFrame>(frame).target_state();
+        }));
+        bench::keep(target_state);
+    });
+    bench::report("read(), one field in place", reads, 1);
+
+    ReportingDataFrame frame{};
+    double publishes = bench::repeat([&] {
+        shm->publish(0, frame);
+    });
+    bench::report("publish(), copying the frame in", publishes, 1);
+
+    double in_place = bench::repeat([&] {
+        shm->publish_in_place(0, [](shared_data_frame_t &latest) {
+            std::get<ReportingDataFrame>(latest).target_state(1);
+        });
+    });
+    bench::report("publish_in_place(), one field", in_place, 1);
+
+    // forked readers polling what the publisher process stores
+    std::printf("  publisher paced at 10000 frames/s, %u frames\n", bench::shared_frames);
+    for(size_t readers : {1, 2, 4, 8}) {
+        bench::shared_frames_run(readers, 10000);
+    }
+}
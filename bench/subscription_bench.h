@@ -0,0 +1,67 @@
+#pragma once
+
+#include "bench.h"
+#include "captures.h"
+#include "ld2410_subscription.h"
+
+using namespace ld2410;
+
+namespace bench {
+    // engineering mode frames of a quiet room, every tenth one with a moving gate energy changed
+    inline std::vector<uint8_t> quiet_capture(size_t frames) {
+        std::vector<uint8_t> bytes;
+        for(size_t i = 0; i < frames; ++i) {
+            bytes.insert(bytes.end(), engineering_frame, engineering_frame + sizeof(engineering_frame));
+            // gate 3 movement energy
+            if (i % 10 == 0) bytes[bytes.size() - sizeof(engineering_frame) + 22] = (uint8_t)(i / 10 % 100);
+        }
+        return bytes;
+    }
+
+    // Frames per second read from capture with read(reader), which returns the
+    // frame passed on or nullopt. delivered is the share passed on.
+    template <typename F>
+    double delivery_throughput(const std::vector<uint8_t> &capture, size_t frames_in_capture, F read, double &delivered) {
+        size_t frames = 0;
+        size_t passed = 0;
+        double seconds = 0;
+        Stopwatch watch;
+        do {
+            BufferReader reader{capture.data(), capture.size()};
+            while(!reader.overrun()) {
+                auto frame = read(reader);
+                if (frame.has_value()) ++passed;
+                keep(frame);
+            }
+            frames += frames_in_capture;
+            seconds = watch.seconds();
+        } while(seconds < 0.5);
+        delivered = (double)passed / frames;
+        return frames / seconds;
+    }
+}
+
+LD2410_BENCH(subscription_on_change) {
+    const size_t frames = 10000;
+    std::vector<uint8_t> capture = bench::quiet_capture(frames);
+    double delivered = 0;
+
+    double decoded = bench::delivery_throughput(capture, frames, [](BufferReader &reader) {
+        return read_from_reader_many<EngineeringModeDataFrame, ReportingDataFrame>(reader);
+    }, delivered);
+    std::printf("  decode every frame   %14.0f frames/s %5.1f %% delivered\n", decoded, delivered * 100);
+
+    FrameSubscription every{};
+    double passed = bench::delivery_throughput(capture, frames, [&](BufferReader &reader) {
+        return read_subscribed<EngineeringModeDataFrame, ReportingDataFrame>(reader, every, 0);
+    }, delivered);
+    std::printf("  subscribed, all      %14.0f frames/s %5.1f %% delivered %6.2fx\n", passed, delivered * 100, passed / decoded);
+
+    DeliveryPolicy policy;
+    policy.on_change = true;
+    FrameSubscription changes{policy};
+    double changed = bench::delivery_throughput(capture, frames, [&](BufferReader &reader) {
+        return read_subscribed<EngineeringModeDataFrame, ReportingDataFrame>(reader, changes, 0);
+    }, delivered);
+    std::printf("  subscribed, changes  %14.0f frames/s %5.1f %% delivered %6.2fx\n", changed, delivered * 100, changed / decoded);
+}
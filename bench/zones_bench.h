@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+
+#include "bench.h"
+#include "ld2410_zones.h"
+
+using namespace ld2410;
+
+namespace bench {
+    const size_t zones_sensors = 64;
+
+    // a target walking from gate to gate, every frame moves some zones
+    inline std::vector<EngineeringModeDataFrame> walking_frames() {
+        std::vector<EngineeringModeDataFrame> frames;
+        for(size_t target = 0; target < config_gate_count; ++target) {
+            EngineeringModeDataFrame frame{};
+            frame.target_state(3);
+            frame.maximum_moving_distance_gate_n(8);
+            frame.maximum_static_distance_gate_n(8);
+            gate_values_t movement, stationary;
+            movement.resize(config_gate_count);
+            stationary.resize(config_gate_count);
+            movement[target] = 90;
+            stationary[(target + 4) % config_gate_count] = 90;
+            frame.movement_distance_gate_energy_value(movement);
+            frame.static_distance_gate_energy_value(stationary);
+            frames.push_back(frame);
+        }
+        return frames;
+    }
+
+    // Frames per second of zones_sensors trackers sharing a map of zones zones.
+    inline double zones_throughput(size_t zones) {
+        // zones of one to three gates all over the range
+        std::vector<Zone> layout(zones);
+        for(size_t z = 0; z < zones; ++z) {
+            layout[z].first_gate = z % config_gate_count;
+            layout[z].last_gate = std::min<size_t>(layout[z].first_gate + z % 3, config_gate_count - 1);
+            layout[z].stationary = z % 2 == 0;
+        }
+        SensorConfig thresholds;
+        thresholds.motion_sensitivity = {50, 50, 40, 30, 20, 15, 15, 15, 15};
+        thresholds.static_sensitivity = {0, 0, 40, 40, 30, 30, 20, 20, 20};
+        ZoneMap map{layout, thresholds};
+
+        std::vector<ZoneTracker> trackers(zones_sensors, ZoneTracker{map});
+        std::vector<EngineeringModeDataFrame> frames = walking_frames();
+        size_t transitions = 0;
+        size_t step = 0;
+        double rounds = repeat([&]() {
+            const auto &frame = frames[step++ % frames.size()];
+            for(auto &tracker : trackers) {
+                tracker.update(frame, [&](size_t, bool) { ++transitions; });
+            }
+        });
+        keep(transitions);
+        return rounds * zones_sensors;
+    }
+}
+
+LD2410_BENCH(zones_update) {
+    for(size_t zones : {64, 1024, 4096}) {
+        double frames_per_second = bench::zones_throughput(zones);
+        std::printf("  %4zu zones, %2zu sensors %14.0f frames/s %8.0f frames/ms\n", zones, bench::zones_sensors, frames_per_second, frames_per_second / 1000);
+    }
+}
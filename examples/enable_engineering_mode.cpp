@@ -27,17 +27,14 @@ void setup(void) {
 
 
 void loop(void) {
-  auto packet = read_from_reader<ReportingDataFrame, EngineeringModeDataFrame>(r);
-
-  if (packet.has_value()) {
-    // check packet name
-    if (std::holds_alternative<EngineeringModeDataFrame>(*packet)) {
-      return;
-    }
-
-    // access values
-    auto reporting_frame = std::get<ReportingDataFrame>(*packet);
-    Serial.println(reporting_frame.detection_distance());
-  }
+  // one handler per packet type, the frame is decoded straight into the matching one
+  read_and_dispatch(r,
+    [](const ReportingDataFrame &reporting_frame) {
+      // access values
+      Serial.println(reporting_frame.detection_distance());
+    },
+    [](const EngineeringModeDataFrame &) {
+      // ignored in this example
+    });
 }
 
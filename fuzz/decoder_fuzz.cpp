@@ -0,0 +1,96 @@
+// Fuzz target for the frame decoder, host only.
+//
+// libFuzzer:
+//   clang++ -std=gnu++17 -g -O1 -fsanitize=fuzzer,address,undefined -DLD2410_NO_ARDUINO -Iinclude fuzz/decoder_fuzz.cpp -o decoder_fuzz
+//   ./decoder_fuzz
+//
+// AFL++ or any driver feeding one input on stdin:
+//   afl-clang-fast++ -std=gnu++17 -DLD2410_NO_ARDUINO -DLD2410_FUZZ_STDIN -Iinclude fuzz/decoder_fuzz.cpp -o decoder_fuzz
+//   afl-fuzz -i corpus -o findings ./decoder_fuzz
+//
+// Add -DLD2410_ZERO_ALLOC to fuzz the allocation free build.
+
+#include <cstdint>
+#include <cstdlib>
+#include <variant>
+
+#include "ld2410.h"
+#include "ld2410_packet_views.h"
+
+using namespace ld2410;
+
+namespace {
+    // aborts if the decoder reads more than one frame ahead of the last call
+    class CheckedReader {
+        BufferReader m_reader;
+
+    public:
+        size_t reads = 0;
+
+        CheckedReader(const uint8_t *data, size_t size): m_reader(data, size) {
+
+        }
+
+        uint8_t operator()() {
+            ++reads;
+            return m_reader();
+        }
+    };
+
+    const size_t max_frame_size = internal_helpers::frame_overhead + max_frame_data_size;
+
+    void decode_all(const uint8_t *data, size_t size) {
+        CheckedReader r{data, size};
+        while(r.reads < size) {
+            size_t before = r.reads;
+            read_from_reader_many<EngineeringModeDataFrame, ReportingDataFrame, EnableConfigurationCommandAck, EndConfigurationCommandAck,
+                MaximumDistanceGateandUnmannedDurationParameterConfigurationCommandAck, ReadParameterCommandAck, EnableEngineeringModeCommandAck,
+                CloseEngineeringModeCommandAck, RangeSensitivityConfigurationCommandAck, ReadFirmwareVersionCommandAck, SetSerialPortBaudRateAck,
+                FactoryResetAck, RestartModuleAck>(r);
+            if (r.reads - before > max_frame_size) abort();
+        }
+    }
+
+    void inspect_raw(const uint8_t *data, size_t size) {
+        CheckedReader r{data, size};
+        while(r.reads < size) {
+            size_t before = r.reads;
+            auto frame = read_raw_frame<EngineeringModeDataFrame, ReportingDataFrame>(r);
+            if (r.reads - before > max_frame_size) abort();
+            if (!frame.has_value()) continue;
+
+            if (frame->is<EngineeringModeDataFrame>()) {
+                EngineeringModeDataFrameView view{*frame};
+                if (!view.valid()) continue;
+
+                volatile uint32_t sum = view.target_state() + view.detection_distance();
+                for(size_t gate = 0; gate < view.movement_gate_count(); ++gate) sum = sum + view.movement_distance_gate_energy_value(gate);
+                for(size_t gate = 0; gate < view.static_gate_count(); ++gate) sum = sum + view.static_distance_gate_energy_value(gate);
+            } else {
+                ReportingDataFrameView view{*frame};
+                if (!view.valid()) continue;
+
+                volatile uint32_t sum = view.target_state() + view.detection_distance();
+                (void)sum;
+            }
+        }
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    decode_all(data, size);
+    inspect_raw(data, size);
+    return 0;
+}
+
+#ifdef LD2410_FUZZ_STDIN
+#include <cstdio>
+#include <vector>
+
+int main() {
+    std::vector<uint8_t> input;
+    int c;
+    while((c = getchar()) != EOF) input.push_back(c);
+    return LLVMFuzzerTestOneInput(input.data(), input.size());
+}
+#endif
@@ -3,4 +3,5 @@
 #include "ld2410_framework_switch.h"
 #include "ld2410_packet_reader.h"
 #include "ld2410_packet_writer.h"
-#include "ld2410_packet_write_and_read_ack.h"
\ No newline at end of file
+#include "ld2410_packet_write_and_read_ack.h"
+#include "ld2410_dispatch.h"
\ No newline at end of file
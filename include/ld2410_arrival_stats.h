@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+
+#include "ld2410_packet_reader.h"
+
+#ifndef LD2410_MILLIS
+#define LD2410_MILLIS millis()
+#endif
+
+// Receive time and update rate of one sensor. Pass an ArrivalTracker as
+// observer to read_from_reader_many(), or combine it with other observers via
+// observe_all(). Times come from a clock callable returning a monotonic
+// uint32_t, intervals are computed modulo 2^32 so the clock may wrap.
+
+namespace ld2410 {
+    struct MillisClock {
+        uint32_t operator()() const {
+            return LD2410_MILLIS;
+        }
+    };
+
+    // Only data frames are tracked, acks arrive on request and say nothing about the update rate.
+    template <typename TClock = MillisClock>
+    class ArrivalTracker: public NullDecoderObserver {
+        mutable TClock m_clock;
+        uint32_t m_frame_started = 0;
+        uint32_t m_last_frame_time = m_clock();
+        uint32_t m_frames = 0;
+        uint32_t m_last_interval = 0;
+        uint32_t m_min_interval = 0;
+        uint32_t m_max_interval = 0;
+        // both scaled by 16 to keep the fraction of the 1/16 smoothing
+        uint32_t m_mean_interval16 = 0;
+        uint32_t m_jitter16 = 0;
+
+        void record(uint32_t time) {
+            if (m_frames > 0) {
+                uint32_t interval = time - m_last_frame_time;
+
+                if (m_frames == 1) {
+                    m_min_interval = interval;
+                    m_max_interval = interval;
+                    m_mean_interval16 = interval * 16;
+                } else {
+                    // interarrival jitter as in RFC 3550, J += (|D| - J) / 16
+                    uint32_t d = interval > m_last_interval ? interval - m_last_interval : m_last_interval - interval;
+                    m_jitter16 = m_jitter16 + d - m_jitter16 / 16;
+                    m_mean_interval16 = m_mean_interval16 + interval - m_mean_interval16 / 16;
+                    if (interval < m_min_interval) m_min_interval = interval;
+                    if (interval > m_max_interval) m_max_interval = interval;
+                }
+                m_last_interval = interval;
+            }
+
+            m_last_frame_time = time;
+            ++m_frames;
+        }
+
+    public:
+        ArrivalTracker() = default;
+
+        explicit ArrivalTracker(TClock clock): m_clock(clock) {
+
+        }
+
+        void frame_begin() {
+            m_frame_started = m_clock();
+        }
+
+        template <typename T>
+        void frame_decoded(const T &) {
+            if (T::definition_header.val.val == ReportingDataHeader) record(m_frame_started);
+        }
+
+        void frame_received(const RawFrame &frame) {
+            if (frame.data_frame()) record(m_frame_started);
+        }
+
+        // arrival of the first header byte of the last data frame
+        uint32_t last_frame_time() const {
+            return m_last_frame_time;
+        }
+
+        uint32_t frames() const {
+            return m_frames;
+        }
+
+        uint32_t last_interval() const {
+            return m_last_interval;
+        }
+
+        uint32_t min_interval() const {
+            return m_min_interval;
+        }
+
+        uint32_t max_interval() const {
+            return m_max_interval;
+        }
+
+        // exponentially smoothed inter-arrival time
+        uint32_t mean_interval() const {
+            return m_mean_interval16 / 16;
+        }
+
+        uint32_t jitter() const {
+            return m_jitter16 / 16;
+        }
+
+        // time since the last data frame, or since construction or reset() if there was none
+        uint32_t since_last_frame() const {
+            return m_clock() - m_last_frame_time;
+        }
+
+        void reset() {
+            *this = ArrivalTracker{m_clock};
+        }
+    };
+}
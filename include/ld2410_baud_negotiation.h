@@ -0,0 +1,202 @@
+#pragma once
+
+#include <array>
+
+#include "ld2410_packet_write_and_read_ack.h"
+
+#ifndef LD2410_DELAY
+#define LD2410_DELAY(ms) delay(ms)
+#endif
+
+namespace ld2410 {
+    struct BaudNegotiationOptions {
+        // a rate is clean if at most this many of 1000 frames are damaged
+        uint16_t max_frame_loss_permille = 20;
+        decltype(LD2410_MILLIS) ack_timeout = default_ack_timeout;
+        uint8_t command_attempts = 3;
+        // a probe ends once this many frames were counted or after probe_timeout
+        uint16_t probe_frames = 20;
+        decltype(LD2410_MILLIS) probe_timeout = 3000;
+        // the module boots after a restart before it reports at the new rate
+        decltype(LD2410_MILLIS) restart_settle = 500;
+    };
+
+    struct BaudProbeResult {
+        bool probed = false;
+        uint16_t frames = 0;
+        uint16_t damaged_frames = 0;
+
+        // no frame header was seen, the line is idle or unreadable at this rate
+        bool silent() const {
+            return frames == 0 && damaged_frames == 0;
+        }
+
+        // 1000 if silent
+        uint16_t loss_permille() const {
+            uint32_t total = (uint32_t)frames + damaged_frames;
+            if (total == 0) return 1000;
+            return (uint16_t)((uint32_t)damaged_frames * 1000 / total);
+        }
+    };
+
+    // Finds the fastest serial speed at which a sensor delivers clean frames.
+    // set_local_baud(uint32_t bps) must switch the local UART to the given speed.
+    // Frame loss is measured by sampling reporting traffic in pieces of
+    // probe_buffer_size bytes and counting the frames whose header was seen
+    // but whose length, type or mfr did not match. The reader may return 0
+    // when nothing arrived, sampling is limited in time.
+    // A silent probe tells nothing about the link, the rate is kept then.
+    template <typename TWriter, typename TReader, typename TSetLocalBaud, std::size_t probe_buffer_size = 512>
+    class BaudRateNegotiator {
+        TWriter &m_writer;
+        TReader &m_reader;
+        TSetLocalBaud m_set_local_baud;
+        BaudRate m_current;
+        BaudNegotiationOptions m_options;
+        std::array<BaudProbeResult, 8> m_results;
+
+        static size_t index_of(BaudRate rate) {
+            return static_cast<uint16_t>(rate) - static_cast<uint16_t>(BaudRate::BaudRate_9600);
+        }
+
+        static BaudRate next_rate(BaudRate rate, int step) {
+            return static_cast<BaudRate>(static_cast<uint16_t>(rate) + step);
+        }
+
+        bool clean(const BaudProbeResult &result) const {
+            return !result.silent() && result.loss_permille() <= m_options.max_frame_loss_permille;
+        }
+
+        // lossy, not silent
+        bool lossy(const BaudProbeResult &result) const {
+            return !result.silent() && !clean(result);
+        }
+
+        // counts the frames and damaged frames in a sample of size bytes
+        static void count_frames(const uint8_t *buffer, size_t size, BaudProbeResult &result) {
+            using namespace internal_helpers;
+            static constexpr auto definitions = build_frame_definitions<ReportingDataFrame, EngineeringModeDataFrame>();
+            const to_bytes_union<uint32_t> header{ReportingDataHeader};
+
+            for(size_t pos = 0; pos + sizeof(uint32_t) <= size; ++pos) {
+                bool match = true;
+                for(size_t i = 0; match && i < sizeof(uint32_t); ++i) {
+                    match = buffer[pos + i] == header.val.u8[i];
+                }
+                if (!match) continue;
+                if (size - pos < frame_overhead + sizeof(uint16_t)) break;
+
+                size_t data_size = buffer[pos + 4] | (buffer[pos + 5] << 8);
+                // the sample ends within this frame, it is neither clean nor damaged
+                if (data_size <= max_frame_data_size && size - pos < frame_overhead + data_size) break;
+
+                size_t frame_size = frame_size_at(definitions, buffer, size, pos);
+                if (frame_size == 0) {
+                    ++result.damaged_frames;
+                    continue;
+                }
+
+                ++result.frames;
+                pos += frame_size - 1;
+            }
+        }
+
+        template <typename T>
+        bool command(const T &packet) {
+            for(uint8_t attempt = 0; attempt < m_options.command_attempts; ++attempt) {
+                auto ack = write_and_read_ack(m_writer, m_reader, packet, m_options.ack_timeout);
+                if (ack.has_value() && ack->status() == 0) return true;
+            }
+            return false;
+        }
+
+    public:
+        BaudRateNegotiator(TWriter &writer, TReader &reader, TSetLocalBaud set_local_baud, BaudRate current, const BaudNegotiationOptions &options = {}):
+            m_writer(writer), m_reader(reader), m_set_local_baud(set_local_baud), m_current(current), m_options(options), m_results() {
+
+        }
+
+        BaudRate current() const {
+            return m_current;
+        }
+
+        const BaudProbeResult &result(BaudRate rate) const {
+            return m_results[index_of(rate)];
+        }
+
+        // samples reporting traffic at the current rate
+        BaudProbeResult probe() {
+            BaudProbeResult result;
+            result.probed = true;
+
+            std::array<uint8_t, probe_buffer_size> buffer;
+            decltype(LD2410_MILLIS) started_on = LD2410_MILLIS;
+            while(result.frames + result.damaged_frames < m_options.probe_frames && LD2410_MILLIS - started_on < m_options.probe_timeout) {
+                // a reader blocking per byte can not hold the probe much past its deadline
+                size_t size = 0;
+                while(size < buffer.size() && LD2410_MILLIS - started_on < m_options.probe_timeout) {
+                    buffer[size++] = m_reader();
+                }
+
+                uint32_t counted = (uint32_t)result.frames + result.damaged_frames;
+                count_frames(buffer.data(), size, result);
+                // most likely an idle line, give the next frame time to arrive
+                if (result.frames + result.damaged_frames == counted) LD2410_DELAY(1);
+            }
+
+            m_results[index_of(m_current)] = result;
+            return result;
+        }
+
+        // Tells the sensor to use rate, restarts it and follows with the local UART.
+        bool switch_to(BaudRate rate) {
+            EnableConfigurationCommand enable_config;
+            enable_config.value(1);
+            if (!command(enable_config)) return false;
+
+            SetSerialPortBaudRate set_rate;
+            set_rate.baudRate_selection_index(rate);
+            if (!command(set_rate) || !command(RestartModule{})) {
+                command(EndConfigurationCommand{});
+                return false;
+            }
+
+            m_set_local_baud(baud_rate_to_bps(rate));
+            m_current = rate;
+            if (m_options.restart_settle != 0) LD2410_DELAY(m_options.restart_settle);
+            return true;
+        }
+
+        // Steps up from the current rate while frames stay clean, up to max_rate.
+        // Returns to the last clean rate if a faster one loses frames or is
+        // silent. If the way back fails too, it steps down as check_link() does,
+        // current() is the rate the sensor is talked to at either way.
+        BaudRate negotiate(BaudRate max_rate = BaudRate::BaudRate_460800) {
+            BaudProbeResult first = probe();
+            if (first.silent()) return m_current;
+            if (!clean(first)) return check_link();
+
+            while(m_current < max_rate) {
+                BaudRate clean_rate = m_current;
+                if (!switch_to(next_rate(m_current, 1))) break;
+                if (!clean(probe())) {
+                    if (!switch_to(clean_rate)) check_link();
+                    break;
+                }
+            }
+
+            return m_current;
+        }
+
+        // Re-probes the current rate and steps down until frames are clean again.
+        // Call it periodically to fall back when the link degrades. A silent
+        // sensor is left at its rate.
+        BaudRate check_link() {
+            while(lossy(probe()) && m_current > BaudRate::BaudRate_9600) {
+                if (!switch_to(next_rate(m_current, -1))) break;
+            }
+
+            return m_current;
+        }
+    };
+}
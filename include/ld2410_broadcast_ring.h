@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single producer, multi consumer fan-out of decoded frames.
+// The producer never waits for consumers. A consumer that falls more than
+// the ring capacity behind skips the overwritten frames and counts them as lost.
+
+namespace ld2410 {
+    // A value guarded by a sequence lock. The writer never blocks, readers retry
+    // or give up if the value changed while they copied it.
+    template <typename T>
+    class SeqlockSlot {
+        static_assert(std::is_trivially_copyable<T>::value, "seqlock values are copied bytewise and must be trivially copyable");
+
+        std::atomic<uint32_t> m_sequence{0};
+        T m_value{};
+
+    public:
+        // sequence is the even number readers see once the value is stored
+        void store(const T &value, uint32_t sequence) {
+            m_sequence.store(sequence - 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(static_cast<void *>(&m_value), &value, sizeof(T));
+            m_sequence.store(sequence, std::memory_order_release);
+        }
+
+        // Lets f(T &) change the value where it lies, sequence as for store().
+        template <typename F>
+        void write(F f, uint32_t sequence) {
+            m_sequence.store(sequence - 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            f(m_value);
+            m_sequence.store(sequence, std::memory_order_release);
+        }
+
+        // returns the sequence of the copied value or an odd number if a write was in progress
+        uint32_t load(T &value) const {
+            uint32_t before = m_sequence.load(std::memory_order_acquire);
+            if (before & 1) return before;
+
+            std::memcpy(static_cast<void *>(&value), &m_value, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            uint32_t after = m_sequence.load(std::memory_order_relaxed);
+            return before == after ? before : (after | 1);
+        }
+
+        // Calls f(const T &) on the value where it lies and returns like load().
+        // f may see a value being written, what it took from it only counts if
+        // an even sequence is returned.
+        template <typename F>
+        uint32_t read(F f) const {
+            uint32_t before = m_sequence.load(std::memory_order_acquire);
+            if (before & 1) return before;
+
+            f(m_value);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            uint32_t after = m_sequence.load(std::memory_order_relaxed);
+            return before == after ? before : (after | 1);
+        }
+
+        uint32_t sequence() const {
+            return m_sequence.load(std::memory_order_acquire);
+        }
+    };
+
+    template <typename T, std::size_t capacity = 64>
+    class BroadcastRing {
+        static_assert(capacity != 0 && (capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+        SeqlockSlot<T> m_slots[capacity];
+        std::atomic<uint32_t> m_head{0};
+
+        static uint32_t sequence_of(uint32_t position) {
+            return 2 * position + 2;
+        }
+
+    public:
+        class Consumer {
+            const BroadcastRing *m_ring;
+            uint32_t m_next;
+            uint32_t m_lost;
+
+        public:
+            explicit Consumer(const BroadcastRing &ring): m_ring(&ring), m_next(ring.head()), m_lost(0) {
+
+            }
+
+            // copies the next frame into value, returns false if there is none yet
+            bool read(T &value) {
+                while(true) {
+                    uint32_t head = m_ring->head();
+                    uint32_t pending = head - m_next;
+                    if (pending == 0) return false;
+
+                    if (pending > capacity) {
+                        m_lost += pending - capacity;
+                        m_next = head - capacity;
+                    }
+
+                    const SeqlockSlot<T> &slot = m_ring->m_slots[m_next & (capacity - 1)];
+                    if (slot.load(value) == sequence_of(m_next)) {
+                        ++m_next;
+                        return true;
+                    }
+
+                    // the producer lapped us while copying, skip ahead on the next round
+                    m_lost += 1;
+                    m_next += 1;
+                }
+            }
+
+            // number of frames overwritten before this consumer could read them
+            uint32_t lost() const {
+                return m_lost;
+            }
+
+            uint32_t pending() const {
+                uint32_t pending = m_ring->head() - m_next;
+                return pending > capacity ? capacity : pending;
+            }
+        };
+
+        void publish(const T &value) {
+            uint32_t position = m_head.load(std::memory_order_relaxed);
+            m_slots[position & (capacity - 1)].store(value, sequence_of(position));
+            m_head.store(position + 1, std::memory_order_release);
+        }
+
+        Consumer consumer() const {
+            return Consumer{*this};
+        }
+
+        uint32_t head() const {
+            return m_head.load(std::memory_order_acquire);
+        }
+    };
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "ld2410_config_sync.h"
+#include "ld2410_window.h"
+
+// Derives gate sensitivities from the background noise of an empty room. The
+// gate energies of engineering mode frames are collected per gate in fixed
+// size sketches, the sensitivity of a gate is then placed a margin above a
+// high percentile of its noise. A sensitivity is the energy a gate has to
+// exceed to report a target, so noise stays below it.
+//
+//   static NoiseCalibrator calibrator;                           // about 2 KB
+//   auto report = calibrate_sensor(writer, reader, calibrator);  // room must stay empty
+//
+// Recorded frames can be fed to a NoiseCalibrator directly instead.
+
+namespace ld2410 {
+    struct CalibrationOptions {
+        // noise percentile per gate the sensitivity is based on
+        uint8_t percentile = 99;
+        // added to the noise percentile
+        uint8_t margin = 10;
+        // engineering mode frames to capture, a minute at the usual 10 Hz
+        uint32_t frames = 600;
+        // capturing is given up after this long
+        decltype(LD2410_MILLIS) capture_timeout = 120000;
+        decltype(LD2410_MILLIS) ack_timeout = default_ack_timeout;
+    };
+
+    // The static sensitivity of the nearest gates can not be configured.
+    const size_t first_static_sensitivity_gate = 2;
+
+    // Collects gate energies, from add() or as decoder observer.
+    // 4 + 2 * (max_gate_n + 1) * sizeof(sketch_t) bytes, 2020 with 9 gates.
+    template <std::size_t max_gate_n = LD2410_MAX_GATE_N, std::size_t bucket_width = 2>
+    class BasicNoiseCalibrator: public NullDecoderObserver {
+    public:
+        using sketch_t = EnergySketch<bucket_width>;
+
+    private:
+        std::array<sketch_t, max_gate_n + 1> m_movement_energy{};
+        std::array<sketch_t, max_gate_n + 1> m_static_energy{};
+        uint32_t m_frames = 0;
+
+        static uint8_t sensitivity(const sketch_t &noise, const CalibrationOptions &options) {
+            return (uint8_t)std::min<uint32_t>((uint32_t)noise.percentile(options.percentile) + options.margin, sketch_t::energy_max);
+        }
+
+    public:
+        template <std::size_t frame_max_gate_n>
+        void add(const BasicEngineeringModeDataFrame<frame_max_gate_n> &frame) {
+            const auto &movement = frame.movement_distance_gate_energy_value();
+            const auto &stationary = frame.static_distance_gate_energy_value();
+            for(size_t gate = 0; gate < movement.size() && gate <= max_gate_n; ++gate) {
+                m_movement_energy[gate].add(movement[gate]);
+            }
+            for(size_t gate = 0; gate < stationary.size() && gate <= max_gate_n; ++gate) {
+                m_static_energy[gate].add(stationary[gate]);
+            }
+            ++m_frames;
+        }
+
+        template <typename T>
+        void frame_decoded(const T &) {
+
+        }
+
+        template <std::size_t frame_max_gate_n>
+        void frame_decoded(const BasicEngineeringModeDataFrame<frame_max_gate_n> &frame) {
+            add(frame);
+        }
+
+        uint32_t frames() const {
+            return m_frames;
+        }
+
+        const sketch_t &movement_energy(size_t gate) const {
+            return m_movement_energy[gate];
+        }
+
+        const sketch_t &static_energy(size_t gate) const {
+            return m_static_energy[gate];
+        }
+
+        // current with the sensitivities of every gate seen replaced
+        SensorConfig recommend(const SensorConfig &current, const CalibrationOptions &options = {}) const {
+            SensorConfig config = current;
+            for(size_t gate = 0; gate < config_gate_count && gate <= max_gate_n; ++gate) {
+                if (m_movement_energy[gate].count() != 0) {
+                    config.motion_sensitivity[gate] = sensitivity(m_movement_energy[gate], options);
+                }
+                if (gate >= first_static_sensitivity_gate && m_static_energy[gate].count() != 0) {
+                    config.static_sensitivity[gate] = sensitivity(m_static_energy[gate], options);
+                }
+            }
+            return config;
+        }
+
+        // in place, calibrate_sensor() calls it on a caller's instance to keep its stack small
+        void reset() {
+            for(size_t gate = 0; gate <= max_gate_n; ++gate) {
+                m_movement_energy[gate].reset();
+                m_static_energy[gate].reset();
+            }
+            m_frames = 0;
+        }
+    };
+
+    using NoiseCalibrator = BasicNoiseCalibrator<>;
+
+    struct CalibrationReport {
+        // the engineering mode frames were captured in time
+        bool captured = false;
+        uint32_t frames = 0;
+        // parameters written, valid if sync.read
+        SensorConfig recommended;
+        // the configuration session applying recommended
+        ConfigSyncReport sync;
+
+        bool success() const {
+            return captured && sync.success;
+        }
+    };
+
+    namespace internal_helpers {
+        // engineering mode on or off within its own configuration session
+        template <typename TWriter, typename TReader>
+        bool set_engineering_mode(TWriter &writer, TReader &reader, bool enabled, decltype(LD2410_MILLIS) ack_timeout) {
+            EnableConfigurationCommand enable_config;
+            enable_config.value(1);
+            if (!config_command(writer, reader, enable_config, ack_timeout)) return false;
+
+            bool acked = enabled
+                ? config_command(writer, reader, EnableEngineeringModeCommand{}, ack_timeout)
+                : config_command(writer, reader, CloseEngineeringModeCommand{}, ack_timeout);
+            return config_command(writer, reader, EndConfigurationCommand{}, ack_timeout) && acked;
+        }
+    }
+
+    // Switches to engineering mode, captures options.frames frames into
+    // calibrator and writes the recommended sensitivities in one configuration
+    // session, which also closes engineering mode again. The room must be empty
+    // meanwhile. calibrator is reset first and holds the noise afterwards.
+    template <typename TWriter, typename TReader, std::size_t max_gate_n, std::size_t bucket_width>
+    CalibrationReport calibrate_sensor(TWriter &writer, TReader &&reader, BasicNoiseCalibrator<max_gate_n, bucket_width> &calibrator, const CalibrationOptions &options = {}) {
+        using namespace internal_helpers;
+        CalibrationReport report;
+        calibrator.reset();
+
+        if (!set_engineering_mode(writer, reader, true, options.ack_timeout)) {
+            set_engineering_mode(writer, reader, false, options.ack_timeout);
+            return report;
+        }
+
+        decltype(LD2410_MILLIS) started_on = LD2410_MILLIS;
+        while(calibrator.frames() < options.frames && LD2410_MILLIS - started_on < options.capture_timeout) {
+            read_from_reader<EngineeringModeDataFrame>(reader, calibrator);
+        }
+        report.frames = calibrator.frames();
+        report.captured = report.frames >= options.frames;
+
+        if (!report.captured) {
+            set_engineering_mode(writer, reader, false, options.ack_timeout);
+            return report;
+        }
+
+        EnableConfigurationCommand enable_config;
+        enable_config.value(1);
+        if (!config_command(writer, reader, enable_config, options.ack_timeout)) {
+            set_engineering_mode(writer, reader, false, options.ack_timeout);
+            return report;
+        }
+
+        bool acked = sync_config_in_session(writer, reader, [&](const SensorConfig &current) {
+            report.recommended = calibrator.recommend(current, options);
+            return report.recommended;
+        }, options.ack_timeout, report.sync);
+        acked = config_command(writer, reader, CloseEngineeringModeCommand{}, options.ack_timeout) && acked;
+        bool ended = config_command(writer, reader, EndConfigurationCommand{}, options.ack_timeout);
+        report.sync.success = acked && ended;
+        return report;
+    }
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+
+#include "ld2410_packet_write_and_read_ack.h"
+
+// Brings the parameters of a sensor to a desired state with as few writes as
+// possible. The current parameters are read with ReadParameterCommand, only
+// the commands that change something are sent, all within one configuration
+// session.
+
+namespace ld2410 {
+    const size_t config_gate_count = LD2410_MAX_GATE_N + 1;
+
+    struct SensorConfig {
+        uint8_t maximum_moving_distance_gate = 0;
+        uint8_t maximum_static_distance_gate = 0;
+        uint16_t no_one_duration = 0;
+        std::array<uint8_t, config_gate_count> motion_sensitivity{};
+        std::array<uint8_t, config_gate_count> static_sensitivity{};
+
+        bool operator==(const SensorConfig &other) const {
+            return maximum_moving_distance_gate == other.maximum_moving_distance_gate
+                && maximum_static_distance_gate == other.maximum_static_distance_gate
+                && no_one_duration == other.no_one_duration
+                && motion_sensitivity == other.motion_sensitivity
+                && static_sensitivity == other.static_sensitivity;
+        }
+
+        bool operator!=(const SensorConfig &other) const {
+            return !(*this == other);
+        }
+    };
+
+    inline SensorConfig sensor_config_from(const ReadParameterCommandAck &ack) {
+        SensorConfig config;
+        config.maximum_moving_distance_gate = ack.configure_maximum_moving_distance_gate();
+        config.maximum_static_distance_gate = ack.configure_maximum_static_gate();
+        config.no_one_duration = ack.no_time_duration();
+
+        const auto &motion = ack.distance_gate_motion_sensitivity();
+        const auto &stationary = ack.distance_gate_rest_sensitivity();
+        for(size_t i = 0; i < config_gate_count && i < motion.size(); ++i) {
+            config.motion_sensitivity[i] = motion[i];
+        }
+        for(size_t i = 0; i < config_gate_count && i < stationary.size(); ++i) {
+            config.static_sensitivity[i] = stationary[i];
+        }
+        return config;
+    }
+
+    struct ConfigDiff {
+        // maximum gates or no one duration differ
+        bool distances = false;
+        // bit i is set if the sensitivities of gate i differ
+        uint16_t gates = 0;
+
+        bool empty() const {
+            return !distances && gates == 0;
+        }
+
+        bool all_gates() const {
+            return gates == (1 << config_gate_count) - 1;
+        }
+    };
+
+    static_assert(config_gate_count <= 16, "ConfigDiff::gates has one bit per gate");
+
+    inline ConfigDiff diff_config(const SensorConfig &current, const SensorConfig &desired) {
+        ConfigDiff diff;
+        diff.distances = current.maximum_moving_distance_gate != desired.maximum_moving_distance_gate
+            || current.maximum_static_distance_gate != desired.maximum_static_distance_gate
+            || current.no_one_duration != desired.no_one_duration;
+
+        for(size_t i = 0; i < config_gate_count; ++i) {
+            if (current.motion_sensitivity[i] != desired.motion_sensitivity[i] || current.static_sensitivity[i] != desired.static_sensitivity[i]) {
+                diff.gates |= 1 << i;
+            }
+        }
+        return diff;
+    }
+
+    struct ConfigSyncReport {
+        // the current parameters could be read
+        bool read = false;
+        // every needed command was acked, the sensor now has the desired config
+        bool success = false;
+        ConfigDiff changed;
+        // number of parameter commands sent
+        uint8_t writes = 0;
+        // parameters before the sync
+        SensorConfig previous;
+    };
+
+    namespace internal_helpers {
+        template <typename TWriter, typename TReader, typename T>
+        bool config_command(TWriter &writer, TReader &reader, const T &packet, decltype(LD2410_MILLIS) timeout) {
+            auto ack = write_and_read_ack(writer, reader, packet, timeout);
+            return ack.has_value() && ack->status() == 0;
+        }
+
+        inline RangeSensitivityConfigurationCommand range_sensitivity_command(uint32_t gate, uint8_t motion, uint8_t stationary) {
+            RangeSensitivityConfigurationCommand command;
+            command.distance_gate_word(0x0000);
+            command.distance_gate_value(gate);
+            command.motion_sensitivity_word(0x0001);
+            command.motion_sensitivity_value(motion);
+            command.static_sensitivity_word(0x0002);
+            command.static_sensitivity_value(stationary);
+            return command;
+        }
+
+        inline bool uniform(const std::array<uint8_t, config_gate_count> &values) {
+            for(uint8_t v : values) {
+                if (v != values[0]) return false;
+            }
+            return true;
+        }
+
+        // The part of a sync within configuration mode. desired_of(previous)
+        // gives the desired config for the parameters read. False if reading
+        // failed or a command was not acked.
+        template <typename TWriter, typename TReader, typename F>
+        bool sync_config_in_session(TWriter &writer, TReader &reader, F desired_of, decltype(LD2410_MILLIS) ack_timeout, ConfigSyncReport &report) {
+            auto parameters = write_and_read_ack(writer, reader, ReadParameterCommand{}, ack_timeout);
+            if (!parameters.has_value() || parameters->status() != 0) return false;
+
+            report.read = true;
+            report.previous = sensor_config_from(*parameters);
+            const SensorConfig desired = desired_of(report.previous);
+            report.changed = diff_config(report.previous, desired);
+            bool acked = true;
+
+            if (report.changed.distances) {
+                MaximumDistanceGateandUnmannedDurationParameterConfigurationCommand command;
+                command.maximum_moving_distance_word(0x0000);
+                command.maximum_moving_distance_parameter(desired.maximum_moving_distance_gate);
+                command.maximum_static_distance_door_word(0x0001);
+                command.maximum_static_distance_door_parameter(desired.maximum_static_distance_gate);
+                command.no_person_duration(0x0002);
+                command.section_unattended_duration(desired.no_one_duration);
+                acked = config_command(writer, reader, command, ack_timeout) && acked;
+                ++report.writes;
+            }
+
+            // one command for all gates if they end up alike
+            if (report.changed.all_gates() && uniform(desired.motion_sensitivity) && uniform(desired.static_sensitivity)) {
+                auto command = range_sensitivity_command(0xffff, desired.motion_sensitivity[0], desired.static_sensitivity[0]);
+                acked = config_command(writer, reader, command, ack_timeout) && acked;
+                ++report.writes;
+            } else {
+                for(size_t i = 0; i < config_gate_count; ++i) {
+                    if ((report.changed.gates & (1 << i)) == 0) continue;
+
+                    auto command = range_sensitivity_command(i, desired.motion_sensitivity[i], desired.static_sensitivity[i]);
+                    acked = config_command(writer, reader, command, ack_timeout) && acked;
+                    ++report.writes;
+                }
+            }
+            return acked;
+        }
+    }
+
+    // Reads the parameters, writes what differs from desired and leaves configuration mode.
+    template <typename TWriter, typename TReader>
+    ConfigSyncReport sync_config(TWriter &writer, TReader &&reader, const SensorConfig &desired, decltype(LD2410_MILLIS) ack_timeout = default_ack_timeout) {
+        using namespace internal_helpers;
+        ConfigSyncReport report;
+
+        EnableConfigurationCommand enable_config;
+        enable_config.value(1);
+        if (!config_command(writer, reader, enable_config, ack_timeout)) return report;
+
+        bool acked = sync_config_in_session(writer, reader, [&](const SensorConfig &) { return desired; }, ack_timeout, report);
+        bool ended = config_command(writer, reader, EndConfigurationCommand{}, ack_timeout);
+        report.success = acked && ended;
+        return report;
+    }
+}
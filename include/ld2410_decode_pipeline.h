@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "ld2410_packet_reader.h"
+
+// Offline decoding of large recorded captures on all cores.
+// This header needs std::thread and is therefore not part of ld2410.h.
+
+namespace ld2410 {
+    namespace internal_helpers {
+        // Runs func(i) for every i < task_count. Workers claim the next unprocessed
+        // task themselves, so a slow task never holds up the remaining ones.
+        template <typename F>
+        void parallel_for(size_t task_count, size_t thread_count, F func) {
+            if (thread_count > task_count) thread_count = task_count;
+            if (thread_count <= 1) {
+                for(size_t i = 0; i < task_count; ++i) func(i);
+                return;
+            }
+
+            std::atomic<size_t> next{0};
+            auto worker = [&]() {
+                while(true) {
+                    size_t i = next.fetch_add(1, std::memory_order_relaxed);
+                    if (i >= task_count) return;
+                    func(i);
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(thread_count - 1);
+            for(size_t t = 1; t < thread_count; ++t) {
+                threads.emplace_back(worker);
+            }
+            worker();
+            for(auto &t : threads) {
+                t.join();
+            }
+        }
+    }
+
+    struct DecodePipelineOptions {
+        // 0 selects std::thread::hardware_concurrency()
+        size_t threads = 0;
+        size_t chunk_size = 64 * 1024;
+        size_t frames_per_task = 256;
+    };
+
+    // Finds the start offsets of all complete frames of the given types in data.
+    // Header candidates are searched per chunk in parallel and only accepted if
+    // type and mfr match, overlapping candidates are dropped in order afterwards.
+    template <typename ...T>
+    std::vector<size_t> find_frame_offsets(const uint8_t *data, size_t size, const DecodePipelineOptions &options = {}) {
+        using namespace internal_helpers;
+        static constexpr auto definitions = build_frame_definitions<T...>();
+
+        size_t threads = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+        size_t chunk_size = options.chunk_size != 0 ? options.chunk_size : size;
+        size_t chunk_count = size == 0 ? 0 : (size + chunk_size - 1) / chunk_size;
+
+        // bytes a header can start with, everything else is skipped cheaply
+        std::array<bool, 256> header_start{};
+        for(const auto &d : definitions) {
+            header_start[d.definition_header.val.u8[0]] = true;
+        }
+
+        std::vector<std::vector<std::pair<size_t, size_t>>> candidates(chunk_count);
+        parallel_for(chunk_count, threads, [&](size_t chunk) {
+            size_t begin = chunk * chunk_size;
+            size_t end = std::min(size, begin + chunk_size);
+            auto &found = candidates[chunk];
+
+            for(size_t pos = begin; pos < end; ++pos) {
+                if (!header_start[data[pos]]) continue;
+                size_t frame_size = frame_size_at(definitions, data, size, pos);
+                if (frame_size != 0) {
+                    found.push_back({pos, frame_size});
+                }
+            }
+        });
+
+        std::vector<size_t> offsets;
+        size_t next_free = 0;
+        for(const auto &found : candidates) {
+            for(const auto &candidate : found) {
+                if (candidate.first < next_free) continue;
+                offsets.push_back(candidate.first);
+                next_free = candidate.first + candidate.second;
+            }
+        }
+
+        return offsets;
+    }
+
+    // Decodes all frames of the given types in a recorded capture using multiple
+    // threads. The result is in the same order as the frames in the capture.
+    template <typename ...T>
+    std::vector<std::variant<T...>> decode_parallel(const uint8_t *data, size_t size, const DecodePipelineOptions &options = {}) {
+        using namespace internal_helpers;
+
+        size_t threads = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+        size_t frames_per_task = options.frames_per_task != 0 ? options.frames_per_task : 1;
+
+        std::vector<size_t> offsets = find_frame_offsets<T...>(data, size, options);
+        // decoded in place, frames that fail to decode are dropped afterwards
+        std::vector<std::variant<T...>> result(offsets.size());
+        std::vector<uint8_t> decoded(offsets.size(), 0);
+        size_t task_count = (offsets.size() + frames_per_task - 1) / frames_per_task;
+
+        parallel_for(task_count, threads, [&](size_t task) {
+            size_t begin = task * frames_per_task;
+            size_t end = std::min(offsets.size(), begin + frames_per_task);
+
+            for(size_t i = begin; i < end; ++i) {
+                BufferReader reader{data + offsets[i], size - offsets[i]};
+                auto frame = read_from_reader_many<T...>(reader);
+                if (!frame.has_value()) continue;
+                result[i] = std::move(*frame);
+                decoded[i] = 1;
+            }
+        });
+
+        size_t kept = 0;
+        for(size_t i = 0; i < result.size(); ++i) {
+            if (!decoded[i]) continue;
+            if (kept != i) result[kept] = std::move(result[i]);
+            ++kept;
+        }
+        result.resize(kept);
+
+        return result;
+    }
+}
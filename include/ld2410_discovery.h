@@ -0,0 +1,126 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "ld2410_decode_pipeline.h"
+#include "ld2410_packet_write_and_read_ack.h"
+#include "ld2410_watchdog.h"
+
+// Finds out which serial port has a sensor attached and at which rate, for
+// all candidate ports at once. Each port is tried rate by rate, factory
+// default first. At every rate the traffic is sniffed for data frames, which
+// costs no command round trip, then the module is asked for its firmware
+// version. A module that does not report, e.g. because it was left in
+// configuration mode, is still found by the command.
+// Readers must return, with 0 or the like if nothing arrived, sniffing and
+// waiting for acks are limited in time, not in bytes.
+// This header needs std::thread and is therefore not part of ld2410.h.
+
+namespace ld2410 {
+    struct DiscoveryOptions {
+        // ports probed at the same time
+        size_t concurrency = 32;
+        // sniffing a rate is given up after this long, a reporting module sends a frame every 100 ms
+        decltype(LD2410_MILLIS) sniff_timeout = 250;
+        // shorter than default_ack_timeout, most ports tried have no sensor at that rate
+        decltype(LD2410_MILLIS) ack_timeout = 100;
+        // ask for the firmware version of sensors found by sniffing as well
+        bool read_firmware = true;
+        // rates to try, in this order
+        std::vector<BaudRate> baud_rates{watchdog_rescan_order.begin(), watchdog_rescan_order.end()};
+    };
+
+    struct DiscoveredSensor {
+        bool found = false;
+        BaudRate baud_rate = BaudRate::BaudRate_256000;
+        // data frames were seen, the module is reporting
+        bool reporting = false;
+        bool engineering_mode = false;
+        std::optional<ReadFirmwareVersionCommandAck> firmware;
+        // rates tried, including the one the sensor was found at
+        uint8_t rates_tried = 0;
+    };
+
+    namespace internal_helpers {
+        // the first data frame read within timeout
+        template <typename TReader>
+        std::optional<std::variant<ReportingDataFrame, EngineeringModeDataFrame>> sniff_data_frame(TReader &reader, decltype(LD2410_MILLIS) timeout) {
+            // readers return 0 if nothing arrived, an attempt reading nothing else waits a bit
+            bool heard = false;
+            auto listen = [&]() {
+                uint8_t b = reader();
+                heard |= b != 0;
+                return b;
+            };
+
+            decltype(LD2410_MILLIS) started_on = LD2410_MILLIS;
+            while(LD2410_MILLIS - started_on < timeout) {
+                heard = false;
+                auto frame = read_from_reader_many<ReportingDataFrame, EngineeringModeDataFrame>(listen);
+                if (frame.has_value()) return frame;
+                if (!heard) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return std::nullopt;
+        }
+
+        // firmware version, enabling and ending configuration mode around it
+        template <typename TWriter, typename TReader>
+        std::optional<ReadFirmwareVersionCommandAck> query_firmware(TWriter &writer, TReader &reader, decltype(LD2410_MILLIS) timeout) {
+            EnableConfigurationCommand enable_config;
+            enable_config.value(1);
+            auto enabled = write_and_read_ack(writer, reader, enable_config, timeout);
+            if (!enabled.has_value() || enabled->status() != 0) return std::nullopt;
+
+            auto firmware = write_and_read_ack(writer, reader, ReadFirmwareVersionCommand{}, timeout);
+            write_and_read_ack(writer, reader, EndConfigurationCommand{}, timeout);
+            return firmware;
+        }
+    }
+
+    // Probes one port. port provides writer(), reader() and set_local_baud(uint32_t bps).
+    // The local UART is left at the rate the sensor was found at.
+    template <typename TPort>
+    DiscoveredSensor discover_sensor(TPort &port, const DiscoveryOptions &options = {}) {
+        using namespace internal_helpers;
+        DiscoveredSensor result;
+        auto writer = port.writer();
+        auto reader = port.reader();
+
+        for(BaudRate rate : options.baud_rates) {
+            ++result.rates_tried;
+            port.set_local_baud(baud_rate_to_bps(rate));
+
+            auto frame = sniff_data_frame(reader, options.sniff_timeout);
+            if (frame.has_value()) {
+                result.reporting = true;
+                result.engineering_mode = std::holds_alternative<EngineeringModeDataFrame>(*frame);
+            }
+            if (frame.has_value() && !options.read_firmware) {
+                result.found = true;
+                result.baud_rate = rate;
+                return result;
+            }
+
+            result.firmware = query_firmware(writer, reader, options.ack_timeout);
+            if (frame.has_value() || result.firmware.has_value()) {
+                result.found = true;
+                result.baud_rate = rate;
+                return result;
+            }
+        }
+        return result;
+    }
+
+    // Probes ports[i] for i < count concurrently. Element i of the result belongs to ports[i].
+    template <typename TPorts>
+    std::vector<DiscoveredSensor> discover_sensors(TPorts &ports, size_t count, const DiscoveryOptions &options = {}) {
+        std::vector<DiscoveredSensor> sensors(count);
+        internal_helpers::parallel_for(count, options.concurrency, [&](size_t i) {
+            sensors[i] = discover_sensor(ports[i], options);
+        });
+        return sensors;
+    }
+}
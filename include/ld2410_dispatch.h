@@ -0,0 +1,139 @@
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+
+#include "ld2410_packet_reader.h"
+
+// Decoding straight into handlers, one callable per packet type:
+//
+//   read_and_dispatch(reader,
+//       [](const ReportingDataFrame &frame) { ... },
+//       [](const EngineeringModeDataFrame &frame) { ... });
+//
+// The packet types are taken from the parameter of each handler, the frame is
+// decoded into a packet of the matching type on the stack and passed to its
+// handler. No variant or optional of the packets is built. Handlers must take
+// exactly one parameter, may not be generic lambdas and take distinct types.
+
+namespace ld2410 {
+    namespace internal_helpers {
+        template <typename F>
+        struct callable_traits: callable_traits<decltype(&F::operator())> {
+
+        };
+
+        template <typename R, typename ...A>
+        struct callable_traits<R(A...)> {
+            using arguments = std::tuple<A...>;
+        };
+
+        template <typename R, typename ...A>
+        struct callable_traits<R(*)(A...)>: callable_traits<R(A...)> {
+
+        };
+
+        template <typename C, typename R, typename ...A>
+        struct callable_traits<R(C::*)(A...)>: callable_traits<R(A...)> {
+
+        };
+
+        template <typename C, typename R, typename ...A>
+        struct callable_traits<R(C::*)(A...) const>: callable_traits<R(A...)> {
+
+        };
+
+        template <typename F>
+        using handler_arguments_t = typename callable_traits<std::remove_pointer_t<std::decay_t<F>>>::arguments;
+
+        // the packet type a handler takes
+        template <typename F>
+        using handler_packet_t = std::decay_t<std::tuple_element_t<0, handler_arguments_t<F>>>;
+
+        // no type is listed twice
+        template <typename ...T>
+        struct distinct_types: std::true_type {
+
+        };
+
+        template <typename T, typename ...Rest>
+        struct distinct_types<T, Rest...>: std::integral_constant<bool, !(std::is_same<T, Rest>::value || ...) && distinct_types<Rest...>::value> {
+
+        };
+    }
+
+    template <typename ...THandlers>
+    class PacketDispatcher {
+        static_assert(sizeof...(THandlers) != 0, "at least one handler is needed");
+        static_assert(((std::tuple_size<internal_helpers::handler_arguments_t<THandlers>>::value == 1) && ...), "a handler takes exactly one packet");
+        // a second handler of a type would never be called
+        static_assert(internal_helpers::distinct_types<internal_helpers::handler_packet_t<THandlers>...>::value, "every packet type has one handler at most");
+
+        std::tuple<THandlers...> m_handlers;
+
+    public:
+        explicit PacketDispatcher(THandlers ...handlers): m_handlers(std::forward<THandlers>(handlers)...) {
+
+        }
+
+        // Decodes frame and calls the handler of its type. False if no handler
+        // takes the type or the data does not fit it.
+        template <typename TObserver>
+        bool dispatch(const RawFrame &frame, TObserver &observer) {
+            using namespace internal_helpers;
+            bool matched = false;
+            bool handled = false;
+
+            for_([&](auto i){
+                using packet_t = nth_element<i.value, handler_packet_t<THandlers>...>;
+                if (matched || !frame.is<packet_t>()) return;
+                matched = true;
+
+                packet_t packet;
+                observer.decode_begin();
+                if (!decode_frame_into(frame, packet)) {
+                    observer.malformed_frame();
+                    return;
+                }
+                observer.frame_decoded(packet);
+                std::get<i.value>(m_handlers)(packet);
+                handled = true;
+            }, std::make_index_sequence<sizeof...(THandlers)>());
+
+            return handled;
+        }
+
+        bool dispatch(const RawFrame &frame) {
+            NullDecoderObserver observer;
+            return dispatch(frame, observer);
+        }
+
+        // Reads the next frame any handler takes and dispatches it. False if
+        // none was read, like read_from_reader_many() returning nothing.
+        template <typename TReader, typename TObserver>
+        bool read(TReader &&reader, TObserver &observer) {
+            static_assert(is_reader<TReader>::value, "a reader must be callable as uint8_t reader()");
+
+            std::optional<RawFrame> frame = internal_helpers::read_frame<internal_helpers::handler_packet_t<THandlers>...>(reader, observer);
+            return frame.has_value() && dispatch(*frame, observer);
+        }
+
+        template <typename TReader>
+        bool read(TReader &&reader) {
+            NullDecoderObserver observer;
+            return read(reader, observer);
+        }
+    };
+
+    // A dispatcher owning copies of handlers.
+    template <typename ...THandlers>
+    PacketDispatcher<THandlers...> make_dispatcher(THandlers ...handlers) {
+        return PacketDispatcher<THandlers...>(std::move(handlers)...);
+    }
+
+    // Reads the next frame and passes it to the handler taking its type.
+    template <typename TReader, typename ...THandlers>
+    bool read_and_dispatch(TReader &&reader, THandlers &&...handlers) {
+        return PacketDispatcher<THandlers &...>(handlers...).read(reader);
+    }
+}
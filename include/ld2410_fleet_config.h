@@ -0,0 +1,118 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "ld2410_config_sync.h"
+#include "ld2410_decode_pipeline.h"
+
+// Applies a configuration plan to many sensors at once. Every sensor is
+// brought to its desired config with sync_config(), on a bounded number of
+// threads. A sensor whose sync keeps failing after some parameters were
+// written is put back to the parameters it had before.
+// This header needs std::thread and is therefore not part of ld2410.h.
+
+namespace ld2410 {
+    struct FleetOptions {
+        // sensors configured at the same time, 0 or 1 configures one after the other
+        size_t concurrency = 8;
+        // further sync_config() attempts after a failed one
+        uint8_t retries = 2;
+        // restore the previous parameters of a sensor that could not be configured
+        bool rollback = true;
+        decltype(LD2410_MILLIS) ack_timeout = default_ack_timeout;
+    };
+
+    enum class FleetOutcome {
+        // already had the desired config
+        unchanged,
+        applied,
+        // nothing was written, or rollback is disabled
+        failed,
+        // configuring failed and the previous parameters were restored
+        rolled_back,
+        // configuring failed and so did restoring, the parameters are unknown
+        rollback_failed
+    };
+
+    struct FleetSensorReport {
+        FleetOutcome outcome = FleetOutcome::failed;
+        // sync_config() calls, including those of the rollback
+        uint8_t attempts = 0;
+        // parameter commands sent
+        uint16_t writes = 0;
+        // parameters before the first write, if they could be read
+        std::optional<SensorConfig> previous;
+    };
+
+    struct FleetReport {
+        std::vector<FleetSensorReport> sensors;
+
+        size_t count(FleetOutcome outcome) const {
+            size_t n = 0;
+            for(const auto &sensor : sensors) {
+                if (sensor.outcome == outcome) ++n;
+            }
+            return n;
+        }
+
+        // every sensor has its desired config
+        bool success() const {
+            return count(FleetOutcome::unchanged) + count(FleetOutcome::applied) == sensors.size();
+        }
+    };
+
+    namespace internal_helpers {
+        // sync_config() with retries, counted into report
+        template <typename TWriter, typename TReader>
+        ConfigSyncReport sync_config_retrying(TWriter &writer, TReader &reader, const SensorConfig &desired, const FleetOptions &options, FleetSensorReport &report) {
+            ConfigSyncReport sync;
+            for(size_t attempt = 0; attempt <= options.retries; ++attempt) {
+                sync = sync_config(writer, reader, desired, options.ack_timeout);
+                ++report.attempts;
+                report.writes += sync.writes;
+                if (sync.read && !report.previous.has_value()) report.previous = sync.previous;
+                if (sync.success) break;
+            }
+            return sync;
+        }
+
+        template <typename TSensor>
+        FleetSensorReport configure_fleet_sensor(TSensor &sensor, const SensorConfig &desired, const FleetOptions &options) {
+            FleetSensorReport report;
+            auto writer = sensor.writer();
+            auto reader = sensor.reader();
+
+            if (sync_config_retrying(writer, reader, desired, options, report).success) {
+                report.outcome = *report.previous == desired ? FleetOutcome::unchanged : FleetOutcome::applied;
+                return report;
+            }
+
+            if (!options.rollback || report.writes == 0 || !report.previous.has_value()) return report;
+
+            SensorConfig previous = *report.previous;
+            bool restored = sync_config_retrying(writer, reader, previous, options, report).success;
+            report.outcome = restored ? FleetOutcome::rolled_back : FleetOutcome::rollback_failed;
+            return report;
+        }
+    }
+
+    // Brings sensors[i] to plan[i]. Sensors provide writer() and reader() like
+    // a serial port wrapper would, each one is only used by one thread at a time.
+    template <typename TSensors>
+    FleetReport apply_fleet_config(TSensors &sensors, const std::vector<SensorConfig> &plan, const FleetOptions &options = {}) {
+        FleetReport report;
+        report.sensors.resize(plan.size());
+
+        internal_helpers::parallel_for(plan.size(), options.concurrency, [&](size_t i) {
+            report.sensors[i] = internal_helpers::configure_fleet_sensor(sensors[i], plan[i], options);
+        });
+        return report;
+    }
+
+    // Brings all sensors to the same config.
+    template <typename TSensors>
+    FleetReport apply_fleet_config(TSensors &sensors, size_t count, const SensorConfig &desired, const FleetOptions &options = {}) {
+        return apply_fleet_config(sensors, std::vector<SensorConfig>(count, desired), options);
+    }
+}
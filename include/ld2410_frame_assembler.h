@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+
+#include "ld2410_packet_reader.h"
+
+// Decoding of bytes pushed in as they arrive, for transports that hand out
+// filled buffers instead of being polled byte by byte. Bytes of a frame
+// split across buffers are kept until the rest arrives.
+//
+//   FrameAssembler<ReportingDataFrame, EngineeringModeDataFrame> assembler;
+//   assembler.push(data, size, [](const auto &frame) { ... });
+
+namespace ld2410 {
+    template <typename ...T>
+    class FrameAssembler {
+        static constexpr auto definitions = internal_helpers::build_frame_definitions<T...>();
+        static constexpr size_t header_size = sizeof(uint32_t) + sizeof(uint16_t);
+
+        std::array<uint8_t, internal_helpers::frame_overhead + max_frame_data_size> m_buffer{};
+        size_t m_size = 0;
+
+        // the first n buffered bytes could start one of the frames
+        bool header_prefix(size_t n) const {
+            for(const auto &d : definitions) {
+                if (std::memcmp(m_buffer.data(), d.definition_header.val.u8, n) == 0) return true;
+            }
+            return false;
+        }
+
+        void consume(size_t n) {
+            m_size -= n;
+            std::memmove(m_buffer.data(), m_buffer.data() + n, m_size);
+        }
+
+        // drops bytes up to the next possible frame start
+        template <typename TObserver>
+        void skip_garbage(TObserver &observer) {
+            size_t n = m_size < sizeof(uint32_t) ? m_size : sizeof(uint32_t);
+            size_t dropped = 0;
+            while(m_size > 0 && !header_prefix(n)) {
+                consume(1);
+                ++dropped;
+                if (m_size < n) n = m_size;
+            }
+            if (dropped != 0) observer.resync(dropped);
+        }
+
+        template <typename TObserver, typename F>
+        size_t assemble(TObserver &observer, F &on_frame) {
+            size_t frames = 0;
+            while(true) {
+                skip_garbage(observer);
+                if (m_size < header_size) return frames;
+
+                size_t data_size = m_buffer[4] | (m_buffer[5] << 8);
+                if (data_size < sizeof(uint16_t) || data_size > max_frame_data_size) {
+                    observer.malformed_frame();
+                    consume(1);
+                    continue;
+                }
+
+                size_t frame_size = internal_helpers::frame_overhead + data_size;
+                if (m_size < frame_size) return frames;
+
+                // type or mfr do not match, the header was part of something else
+                if (internal_helpers::frame_size_at(definitions, m_buffer.data(), m_size, 0) == 0) {
+                    observer.malformed_frame();
+                    consume(1);
+                    continue;
+                }
+
+                BufferReader reader{m_buffer.data(), frame_size};
+                std::optional<std::variant<T...>> frame = read_from_reader_many<T...>(reader, observer);
+                consume(frame_size);
+                if (frame.has_value()) {
+                    std::visit(on_frame, *frame);
+                    ++frames;
+                }
+            }
+        }
+
+    public:
+        // Feeds size bytes and calls on_frame with every packet completed by them.
+        // Returns the number of packets passed to on_frame.
+        template <typename TObserver, typename F>
+        size_t push(const uint8_t *data, size_t size, TObserver &observer, F &&on_frame) {
+            size_t frames = 0;
+            while(size > 0) {
+                size_t n = m_buffer.size() - m_size;
+                if (n > size) n = size;
+                std::memcpy(m_buffer.data() + m_size, data, n);
+                m_size += n;
+                data += n;
+                size -= n;
+                frames += assemble(observer, on_frame);
+            }
+            return frames;
+        }
+
+        template <typename F>
+        size_t push(const uint8_t *data, size_t size, F &&on_frame) {
+            NullDecoderObserver observer;
+            return push(data, size, observer, on_frame);
+        }
+
+        // bytes of an incomplete frame waiting for the rest
+        size_t buffered() const {
+            return m_size;
+        }
+
+        void reset() {
+            m_size = 0;
+        }
+    };
+}
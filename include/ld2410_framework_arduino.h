@@ -53,14 +53,28 @@ public:
 
 template<std::size_t buffer_size = 64>
 class StreamReader {
+#ifdef LD2410_ZERO_ALLOC
+  // reader_t only references the reader, so the state can live inline
+  StreamReaderState<buffer_size> state;
+  StreamReaderState<buffer_size> &current_state() { return state; }
+#else
+  // copies, e.g. into a std::function reader_t, share one buffer so no byte is lost or read twice
   std::shared_ptr<StreamReaderState<buffer_size>> state;
+  StreamReaderState<buffer_size> &current_state() { return *state; }
+#endif
   Stream *read_stream;
   
 
 public:
+#ifdef LD2410_ZERO_ALLOC
+    explicit StreamReader(Stream *read_stream): state(), read_stream(read_stream) {
+
+    }
+#else
     explicit StreamReader(Stream *read_stream): state(std::shared_ptr<StreamReaderState<buffer_size>>(new StreamReaderState<buffer_size>())), read_stream(read_stream) {
 
     }
+#endif
     StreamReader(): StreamReader(&Serial) {
 
     }
@@ -68,15 +82,16 @@ public:
     uint8_t operator()() {
         if (read_stream == nullptr) return 0;
 
-        if (state->restSize == 0) {
-            auto red = read_stream->readBytes(state->data.data(), state->data.size());
-            state->restSize = red;
-            if (state->restSize == 0) return 0;
-            state->index = 0;
+        StreamReaderState<buffer_size> &s = current_state();
+        if (s.restSize == 0) {
+            auto red = read_stream->readBytes(s.data.data(), s.data.size());
+            s.restSize = red;
+            if (s.restSize == 0) return 0;
+            s.index = 0;
         }
 
-        --state->restSize;
-        return state->data[state->index++];
+        --s.restSize;
+        return s.data[s.index++];
     }
 };
 }
\ No newline at end of file
@@ -1,5 +1,46 @@
 #pragma once
 
+#if !defined(LD2410_MILLIS) && defined(__unix__)
+#include <time.h>
+
+namespace ld2410 {
+    inline unsigned long host_millis() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (unsigned long)ts.tv_sec * 1000ul + (unsigned long)ts.tv_nsec / 1000000ul;
+    }
+}
+
+#define LD2410_MILLIS ld2410::host_millis()
+#endif
+
+#if !defined(LD2410_MICROS) && defined(__unix__)
+#include <time.h>
+
+namespace ld2410 {
+    inline unsigned long host_micros() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (unsigned long)ts.tv_sec * 1000000ul + (unsigned long)ts.tv_nsec / 1000ul;
+    }
+}
+
+#define LD2410_MICROS ld2410::host_micros()
+#endif
+
+#if !defined(LD2410_DELAY) && defined(__unix__)
+#include <time.h>
+
+namespace ld2410 {
+    inline void host_delay(unsigned long ms) {
+        timespec ts{(time_t)(ms / 1000), (long)(ms % 1000) * 1000000l};
+        nanosleep(&ts, nullptr);
+    }
+}
+
+#define LD2410_DELAY(ms) ld2410::host_delay(ms)
+#endif
+
 namespace ld2410 {
 class StreamWriter {
 };
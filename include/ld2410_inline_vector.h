@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+
+namespace ld2410 {
+    // Fixed capacity replacement for std::vector that never allocates.
+    // Resizing beyond the capacity is clamped to the capacity.
+    template <typename T, std::size_t capacity>
+    class InlineVector {
+        std::array<T, capacity> m_data{};
+        std::size_t m_size = 0;
+
+    public:
+        InlineVector() = default;
+
+        InlineVector(std::initializer_list<T> values) {
+            for(const T &v : values) push_back(v);
+        }
+
+        void resize(std::size_t size) {
+            m_size = size < capacity ? size : capacity;
+        }
+
+        void push_back(const T &v) {
+            if (m_size < capacity) m_data[m_size++] = v;
+        }
+
+        void clear() {
+            m_size = 0;
+        }
+
+        std::size_t size() const {
+            return m_size;
+        }
+
+        static constexpr std::size_t max_size() {
+            return capacity;
+        }
+
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        T *data() { return m_data.data(); }
+        const T *data() const { return m_data.data(); }
+        T *begin() { return m_data.data(); }
+        T *end() { return m_data.data() + m_size; }
+        const T *begin() const { return m_data.data(); }
+        const T *end() const { return m_data.data() + m_size; }
+
+        T &operator[](std::size_t i) { return m_data[i]; }
+        const T &operator[](std::size_t i) const { return m_data[i]; }
+
+        bool operator==(const InlineVector &other) const {
+            if (m_size != other.m_size) return false;
+            for(std::size_t i = 0; i < m_size; ++i) {
+                if (m_data[i] != other.m_data[i]) return false;
+            }
+            return true;
+        }
+
+        bool operator!=(const InlineVector &other) const {
+            return !(*this == other);
+        }
+    };
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include "ld2410_packet_reader.h"
+
+#ifndef LD2410_MICROS
+#define LD2410_MICROS micros()
+#endif
+
+// Decoder statistics per sensor. Pass a DecoderMetrics as observer to
+// read_from_reader_many() and write_and_read_ack().
+// Counting only happens if LD2410_METRICS is defined, otherwise DecoderMetrics
+// is empty and every hook compiles to nothing.
+
+namespace ld2410 {
+    const size_t packet_kind_count = 14;
+    const size_t latency_bucket_count = 16;
+
+    // slot of a readable packet type in the per type counters, unknown types share the last slot
+    constexpr size_t packet_kind_index(uint16_t definition_type) {
+        switch(definition_type) {
+            case 0xaa02: return 0;
+            case 0xaa01: return 1;
+            case 0x01ff: return 2;
+            case 0x01fe: return 3;
+            case 0x0160: return 4;
+            case 0x0161: return 5;
+            case 0x0162: return 6;
+            case 0x0163: return 7;
+            case 0x0164: return 8;
+            case 0x01a0: return 9;
+            case 0x01a1: return 10;
+            case 0x01a2: return 11;
+            case 0x01a3: return 12;
+            default: return packet_kind_count - 1;
+        }
+    }
+
+    inline const char *packet_kind_name(size_t index) {
+        static const char *names[packet_kind_count] = {
+            "reporting_data_frame",
+            "engineering_mode_data_frame",
+            "enable_configuration_command_ack",
+            "end_configuration_command_ack",
+            "maximum_distance_gate_and_unmanned_duration_parameter_configuration_command_ack",
+            "read_parameter_command_ack",
+            "enable_engineering_mode_command_ack",
+            "close_engineering_mode_command_ack",
+            "range_sensitivity_configuration_command_ack",
+            "read_firmware_version_command_ack",
+            "set_serial_port_baud_rate_ack",
+            "factory_reset_ack",
+            "restart_module_ack",
+            "unknown",
+        };
+        return index < packet_kind_count ? names[index] : "";
+    }
+
+    // Bucket i counts values up to latency_bucket_upper_bound(i), the last bucket everything above.
+    inline uint32_t latency_bucket_upper_bound(size_t index) {
+        return ((uint32_t)1 << index) - 1;
+    }
+
+    inline size_t latency_bucket_index(uint32_t value) {
+        size_t index = value == 0 ? 0 : 32 - __builtin_clz(value);
+        return index < latency_bucket_count ? index : latency_bucket_count - 1;
+    }
+
+    struct DecoderMetricsSnapshot {
+        std::array<uint32_t, packet_kind_count> frames{};
+        uint32_t resync_bytes = 0;
+        uint32_t malformed_frames = 0;
+        uint32_t ack_timeouts = 0;
+        std::array<uint32_t, latency_bucket_count> decode_latency_us{};
+        uint64_t decode_latency_us_sum = 0;
+        std::array<uint32_t, latency_bucket_count> ack_latency_ms{};
+        uint64_t ack_latency_ms_sum = 0;
+    };
+
+#ifdef LD2410_METRICS
+    class LatencyHistogram {
+        std::array<std::atomic<uint32_t>, latency_bucket_count> m_buckets{};
+        std::atomic<uint64_t> m_sum{0};
+
+    public:
+        void record(uint32_t value) {
+            m_buckets[latency_bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+            m_sum.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        void copy_to(std::array<uint32_t, latency_bucket_count> &buckets, uint64_t &sum) const {
+            for(size_t i = 0; i < latency_bucket_count; ++i) {
+                buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+            }
+            sum = m_sum.load(std::memory_order_relaxed);
+        }
+    };
+
+    // Counters are updated by the thread decoding the sensor and can be read from any thread.
+    class DecoderMetrics {
+        std::array<std::atomic<uint32_t>, packet_kind_count> m_frames{};
+        std::atomic<uint32_t> m_resync_bytes{0};
+        std::atomic<uint32_t> m_malformed_frames{0};
+        std::atomic<uint32_t> m_ack_timeouts{0};
+        LatencyHistogram m_decode_latency_us;
+        LatencyHistogram m_ack_latency_ms;
+        decltype(LD2410_MICROS) m_decode_started = 0;
+
+    public:
+        void frame_begin() {
+
+        }
+
+        // only decoding is timed, the frame bytes already arrived
+        void decode_begin() {
+            m_decode_started = LD2410_MICROS;
+        }
+
+        void resync(size_t bytes) {
+            m_resync_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        void malformed_frame() {
+            m_malformed_frames.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        template <typename T>
+        void frame_decoded(const T &) {
+            m_frames[packet_kind_index(T::definition_type.val.val)].fetch_add(1, std::memory_order_relaxed);
+            m_decode_latency_us.record(LD2410_MICROS - m_decode_started);
+        }
+
+        // raw frames are decoded later, if at all
+        void frame_received(const RawFrame &frame) {
+            m_frames[packet_kind_index(frame.type)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        template <typename T>
+        void ack_received(const T &, uint32_t elapsed_ms) {
+            m_ack_latency_ms.record(elapsed_ms);
+        }
+
+        void ack_timeout() {
+            m_ack_timeouts.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        DecoderMetricsSnapshot snapshot() const {
+            DecoderMetricsSnapshot s;
+            for(size_t i = 0; i < packet_kind_count; ++i) {
+                s.frames[i] = m_frames[i].load(std::memory_order_relaxed);
+            }
+            s.resync_bytes = m_resync_bytes.load(std::memory_order_relaxed);
+            s.malformed_frames = m_malformed_frames.load(std::memory_order_relaxed);
+            s.ack_timeouts = m_ack_timeouts.load(std::memory_order_relaxed);
+            m_decode_latency_us.copy_to(s.decode_latency_us, s.decode_latency_us_sum);
+            m_ack_latency_ms.copy_to(s.ack_latency_ms, s.ack_latency_ms_sum);
+            return s;
+        }
+    };
+#else
+    class DecoderMetrics: public NullDecoderObserver {
+    public:
+        DecoderMetricsSnapshot snapshot() const {
+            return {};
+        }
+    };
+#endif
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "ld2410_metrics.h"
+#include "ld2410_text_writer.h"
+
+// Renders decoder statistics and the last reported values of one or more
+// sensors in the OpenMetrics text format into a caller supplied buffer.
+// Nothing is allocated and no printf is involved.
+
+namespace ld2410 {
+    // Escapes label values, everything else is plain text.
+    class OpenMetricsWriter: public TextWriter {
+    public:
+        using TextWriter::TextWriter;
+
+        void write_label_value(const char *s) {
+            for(; *s; ++s) {
+                if (*s == '\\' || *s == '"') {
+                    write('\\');
+                    write(*s);
+                } else if (*s == '\n') {
+                    write("\\n");
+                } else {
+                    write(*s);
+                }
+            }
+        }
+    };
+
+    struct SensorMetricsView {
+        const char *name = "";
+        const DecoderMetricsSnapshot *decoder = nullptr;
+        const ReportingDataFrame *reporting = nullptr;
+        const EngineeringModeDataFrame *engineering = nullptr;
+    };
+
+    namespace internal_helpers {
+        inline void write_metric_family(OpenMetricsWriter &w, const char *name, const char *type, const char *help) {
+            w.write("# TYPE ");
+            w.write(name);
+            w.write(' ');
+            w.write(type);
+            w.write("\n# HELP ");
+            w.write(name);
+            w.write(' ');
+            w.write(help);
+            w.write('\n');
+        }
+
+        inline void write_metric_sample_begin(OpenMetricsWriter &w, const char *name, const char *suffix, const SensorMetricsView &sensor) {
+            w.write(name);
+            w.write(suffix);
+            w.write("{sensor=\"");
+            w.write_label_value(sensor.name);
+            w.write('"');
+        }
+
+        inline void write_metric_sample_end(OpenMetricsWriter &w, uint64_t value) {
+            w.write("} ");
+            w.write_uint(value);
+            w.write('\n');
+        }
+
+        inline void write_metric_sample(OpenMetricsWriter &w, const char *name, const char *suffix, const SensorMetricsView &sensor, uint64_t value) {
+            write_metric_sample_begin(w, name, suffix, sensor);
+            write_metric_sample_end(w, value);
+        }
+
+        inline void write_counter(OpenMetricsWriter &w, const char *name, const char *help, const SensorMetricsView *sensors, size_t sensor_count, uint32_t DecoderMetricsSnapshot::*field) {
+            write_metric_family(w, name, "counter", help);
+            for(size_t i = 0; i < sensor_count; ++i) {
+                if (sensors[i].decoder == nullptr) continue;
+                write_metric_sample(w, name, "_total", sensors[i], sensors[i].decoder->*field);
+            }
+        }
+
+        inline void write_histogram(OpenMetricsWriter &w, const char *name, const char *help, const SensorMetricsView *sensors, size_t sensor_count,
+                                    std::array<uint32_t, latency_bucket_count> DecoderMetricsSnapshot::*buckets, uint64_t DecoderMetricsSnapshot::*sum) {
+            write_metric_family(w, name, "histogram", help);
+            for(size_t i = 0; i < sensor_count; ++i) {
+                if (sensors[i].decoder == nullptr) continue;
+
+                uint32_t count = 0;
+                for(size_t b = 0; b < latency_bucket_count; ++b) {
+                    count += (sensors[i].decoder->*buckets)[b];
+
+                    write_metric_sample_begin(w, name, "_bucket", sensors[i]);
+                    w.write(",le=\"");
+                    if (b + 1 < latency_bucket_count) {
+                        w.write_uint(latency_bucket_upper_bound(b));
+                    } else {
+                        w.write("+Inf");
+                    }
+                    w.write('"');
+                    write_metric_sample_end(w, count);
+                }
+                write_metric_sample(w, name, "_count", sensors[i], count);
+                write_metric_sample(w, name, "_sum", sensors[i], sensors[i].decoder->*sum);
+            }
+        }
+
+        // calls f with the most detailed frame known for the sensor
+        template <typename F>
+        void with_last_frame(const SensorMetricsView &sensor, F f) {
+            if (sensor.engineering != nullptr) {
+                f(*sensor.engineering);
+            } else if (sensor.reporting != nullptr) {
+                f(*sensor.reporting);
+            }
+        }
+
+        template <typename F>
+        void write_frame_gauge(OpenMetricsWriter &w, const char *name, const char *help, const SensorMetricsView *sensors, size_t sensor_count, F value) {
+            write_metric_family(w, name, "gauge", help);
+            for(size_t i = 0; i < sensor_count; ++i) {
+                with_last_frame(sensors[i], [&](const auto &frame) {
+                    write_metric_sample(w, name, "", sensors[i], value(frame));
+                });
+            }
+        }
+
+        inline void write_gate_gauge(OpenMetricsWriter &w, const char *name, const char *help, const SensorMetricsView *sensors, size_t sensor_count, bool movement) {
+            write_metric_family(w, name, "gauge", help);
+            for(size_t i = 0; i < sensor_count; ++i) {
+                if (sensors[i].engineering == nullptr) continue;
+
+                const auto &energies = movement
+                    ? sensors[i].engineering->movement_distance_gate_energy_value()
+                    : sensors[i].engineering->static_distance_gate_energy_value();
+                for(size_t gate = 0; gate < energies.size(); ++gate) {
+                    write_metric_sample_begin(w, name, "", sensors[i]);
+                    w.write(",gate=\"");
+                    w.write_uint(gate);
+                    w.write('"');
+                    write_metric_sample_end(w, energies[gate]);
+                }
+            }
+        }
+    }
+
+    // Writes the exposition for all sensors into buffer and terminates it with a zero.
+    // Returns the length of the text or 0 if it did not fit.
+    inline size_t render_openmetrics(const SensorMetricsView *sensors, size_t sensor_count, char *buffer, size_t capacity) {
+        using namespace internal_helpers;
+        OpenMetricsWriter w{buffer, capacity};
+
+        write_metric_family(w, "ld2410_frames", "counter", "Decoded frames by packet type.");
+        for(size_t i = 0; i < sensor_count; ++i) {
+            if (sensors[i].decoder == nullptr) continue;
+            for(size_t kind = 0; kind < packet_kind_count; ++kind) {
+                if (sensors[i].decoder->frames[kind] == 0) continue;
+
+                write_metric_sample_begin(w, "ld2410_frames", "_total", sensors[i]);
+                w.write(",type=\"");
+                w.write(packet_kind_name(kind));
+                w.write('"');
+                write_metric_sample_end(w, sensors[i].decoder->frames[kind]);
+            }
+        }
+
+        write_counter(w, "ld2410_resync_bytes", "Bytes skipped while searching for a frame header.", sensors, sensor_count, &DecoderMetricsSnapshot::resync_bytes);
+        write_counter(w, "ld2410_malformed_frames", "Frames dropped because they can not be valid.", sensors, sensor_count, &DecoderMetricsSnapshot::malformed_frames);
+        write_counter(w, "ld2410_ack_timeouts", "Commands without an ack in time.", sensors, sensor_count, &DecoderMetricsSnapshot::ack_timeouts);
+        write_histogram(w, "ld2410_decode_latency_microseconds", "Time to decode a frame whose bytes arrived.", sensors, sensor_count,
+                        &DecoderMetricsSnapshot::decode_latency_us, &DecoderMetricsSnapshot::decode_latency_us_sum);
+        write_histogram(w, "ld2410_ack_latency_milliseconds", "Time from sending a command to its ack.", sensors, sensor_count,
+                        &DecoderMetricsSnapshot::ack_latency_ms, &DecoderMetricsSnapshot::ack_latency_ms_sum);
+
+        write_frame_gauge(w, "ld2410_target_state", "Target state of the last frame.", sensors, sensor_count,
+                          [](const auto &frame) { return frame.target_state(); });
+        write_frame_gauge(w, "ld2410_movement_target_distance_centimeters", "Distance of the moving target.", sensors, sensor_count,
+                          [](const auto &frame) { return frame.movement_target_distance(); });
+        write_frame_gauge(w, "ld2410_movement_target_energy", "Energy of the moving target.", sensors, sensor_count,
+                          [](const auto &frame) { return frame.exercise_target_energy_value(); });
+        write_frame_gauge(w, "ld2410_stationary_target_distance_centimeters", "Distance of the stationary target.", sensors, sensor_count,
+                          [](const auto &frame) { return frame.stationary_target_distance(); });
+        write_frame_gauge(w, "ld2410_stationary_target_energy", "Energy of the stationary target.", sensors, sensor_count,
+                          [](const auto &frame) { return frame.stationary_target_energy_value(); });
+        write_frame_gauge(w, "ld2410_detection_distance_centimeters", "Detection distance of the last frame.", sensors, sensor_count,
+                          [](const auto &frame) { return frame.detection_distance(); });
+        write_gate_gauge(w, "ld2410_movement_gate_energy", "Movement energy per distance gate.", sensors, sensor_count, true);
+        write_gate_gauge(w, "ld2410_static_gate_energy", "Static energy per distance gate.", sensors, sensor_count, false);
+
+        w.write("# EOF\n");
+        return w.finish();
+    }
+}
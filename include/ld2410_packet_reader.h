@@ -1,5 +1,9 @@
 #pragma once
 
+#include <array>
+#include <optional>
+#include <tuple>
+
 #include "ld2410_packets.h"
 
 namespace ld2410 {
@@ -10,17 +14,9 @@ namespace ld2410 {
             to_bytes_union<uint16_t> definition_type;
         };
         
-        template<typename T>
-        constexpr std::vector<read_from_reader_tmp_ids> build_ids() {
-            return { { false, T::definition_header, T::definition_type } };
-        }
-
-        template<typename T, typename T2, typename ...TArgs>
-        constexpr std::vector<read_from_reader_tmp_ids> build_ids() {
-            std::vector<read_from_reader_tmp_ids> v = build_ids<T>();
-            std::vector<read_from_reader_tmp_ids> vargs = build_ids<T2, TArgs...>();
-            v.insert(v.end(), vargs.begin(), vargs.end());
-            return v;
+        template<typename ...T>
+        constexpr std::array<read_from_reader_tmp_ids, sizeof...(T)> build_ids() {
+            return { { { false, T::definition_header, T::definition_type }... } };
         }
 
         template<std::size_t N>
@@ -51,73 +47,360 @@ namespace ld2410 {
 
         template <std::size_t I, typename ...Ts>
         using nth_element = typename nth_element_impl<I, Ts...>::definition_type;
+
+        struct frame_definition {
+            to_bytes_union<uint32_t> definition_header;
+            to_bytes_union<uint16_t> definition_type;
+            to_bytes_union<uint32_t> definition_mfr;
+        };
+
+        template <typename ...T>
+        constexpr std::array<frame_definition, sizeof...(T)> build_frame_definitions() {
+            return { { { T::definition_header, T::definition_type, T::definition_mfr }... } };
+        }
+
+        // size of header, data size and mfr surrounding the data of a frame
+        const size_t frame_overhead = sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint32_t);
+
+        template <std::size_t N>
+        size_t frame_size_at(const std::array<frame_definition, N> &definitions, const uint8_t *data, size_t size, size_t pos) {
+            if (size - pos < frame_overhead + sizeof(uint16_t)) return 0;
+
+            const uint8_t *frame = data + pos;
+            const size_t data_size = frame[4] | (frame[5] << 8);
+            const size_t frame_size = frame_overhead + data_size;
+            if (data_size < sizeof(uint16_t) || size - pos < frame_size) return 0;
+
+            for(size_t k = 0; k < N; ++k) {
+                const frame_definition &d = definitions[k];
+                bool match = true;
+                for(size_t i = 0; match && i < sizeof(uint32_t); ++i) {
+                    match = frame[i] == d.definition_header.val.u8[i]
+                        && frame[frame_size - sizeof(uint32_t) + i] == d.definition_mfr.val.u8[i];
+                }
+                for(size_t i = 0; match && i < sizeof(uint16_t); ++i) {
+                    match = frame[6 + i] == d.definition_type.val.u8[i];
+                }
+                if (match) return frame_size;
+            }
+
+            return 0;
+        }
+    }
+
+    // largest data size any LD2410 frame announces
+    const size_t max_frame_data_size = 64;
+
+    // A complete frame whose data was read but not decoded. Comparing or
+    // copying it is cheap, decode() turns it into a packet on demand.
+    struct RawFrame {
+        uint32_t header = 0;
+        uint16_t type = 0;
+        // bytes in payload, the data following the type
+        uint8_t size = 0;
+        std::array<uint8_t, max_frame_data_size - sizeof(uint16_t)> payload{};
+
+        template <typename T>
+        bool is() const {
+            return header == T::definition_header.val.val && type == T::definition_type.val.val;
+        }
+
+        bool data_frame() const {
+            return header == ReportingDataHeader;
+        }
+
+        // decodes without checking that the data fits T, see decode_raw_frame()
+        template <typename T>
+        T decode() const {
+            BufferReader reader{payload.data(), size};
+            T v;
+            v.read(reader);
+            return v;
+        }
+    };
+
+    // Receives events from the decoder, e.g. to collect statistics per sensor.
+    // The default observer does nothing and is optimized away completely.
+    struct NullDecoderObserver {
+        // the first header byte of a frame arrived
+        void frame_begin() {}
+        // the whole frame arrived and is decoded next
+        void decode_begin() {}
+        // bytes were consumed without yielding a frame
+        void resync(size_t) {}
+        // header and type matched, but the frame can not be valid
+        void malformed_frame() {}
+        template <typename T>
+        void frame_decoded(const T &) {}
+        // a frame was read by read_raw_frame(), it may never be decoded
+        void frame_received(const RawFrame &) {}
+        template <typename T>
+        void ack_received(const T &, uint32_t) {}
+        void ack_timeout() {}
+    };
+
+    // Forwards every decoder event to several observers.
+    template <typename ...TObservers>
+    class DecoderObserverList {
+        std::tuple<TObservers &...> m_observers;
+
+    public:
+        explicit DecoderObserverList(TObservers &...observers): m_observers(observers...) {
+
+        }
+
+        void frame_begin() {
+            std::apply([](auto &...o) { (o.frame_begin(), ...); }, m_observers);
+        }
+
+        void decode_begin() {
+            std::apply([](auto &...o) { (o.decode_begin(), ...); }, m_observers);
+        }
+
+        void resync(size_t bytes) {
+            std::apply([&](auto &...o) { (o.resync(bytes), ...); }, m_observers);
+        }
+
+        void malformed_frame() {
+            std::apply([](auto &...o) { (o.malformed_frame(), ...); }, m_observers);
+        }
+
+        template <typename T>
+        void frame_decoded(const T &frame) {
+            std::apply([&](auto &...o) { (o.frame_decoded(frame), ...); }, m_observers);
+        }
+
+        void frame_received(const RawFrame &frame) {
+            std::apply([&](auto &...o) { (o.frame_received(frame), ...); }, m_observers);
+        }
+
+        template <typename T>
+        void ack_received(const T &ack, uint32_t elapsed_ms) {
+            std::apply([&](auto &...o) { (o.ack_received(ack, elapsed_ms), ...); }, m_observers);
+        }
+
+        void ack_timeout() {
+            std::apply([](auto &...o) { (o.ack_timeout(), ...); }, m_observers);
+        }
+    };
+
+    template <typename ...TObservers>
+    DecoderObserverList<TObservers...> observe_all(TObservers &...observers) {
+        return DecoderObserverList<TObservers...>{observers...};
     }
 
     const size_t max_size_t = ~((size_t)0);
-    template <typename ...T>
-    std::optional<std::variant<T...>> read_from_reader_many(const ld2410::reader_t &reader) {
-        using namespace internal_helpers;
-        std::vector<read_from_reader_tmp_ids> ids = build_ids<T...>();
-        
-        for(size_t i = 0; i < sizeof(uint32_t); i++) {
-            bool found = false;
-            auto b = reader();
-            for(size_t k = 0; k < ids.size(); ++k) {
-                if (ids[k].removed) {
-                    continue;
+
+    namespace internal_helpers {
+        struct frame_start {
+            // position of the matching type in the type list
+            size_t index;
+            uint16_t data_size;
+        };
+
+        // Reads header, data size and type of the next frame of one of the types T.
+        template <typename ...T, typename TReader, typename TObserver>
+        std::optional<frame_start> read_frame_start(TReader &reader, TObserver &observer) {
+            std::array<read_from_reader_tmp_ids, sizeof...(T)> ids = build_ids<T...>();
+
+            for(size_t i = 0; i < sizeof(uint32_t); i++) {
+                bool found = false;
+                auto b = reader();
+                for(size_t k = 0; k < ids.size(); ++k) {
+                    if (ids[k].removed) {
+                        continue;
+                    }
+                    if (b == ids[k].definition_header.val.u8[i]) {
+                        found = true;
+                    } else {
+                        ids[k].removed = true;
+                    }
                 }
-                if (b == ids[k].definition_header.val.u8[i]) {
-                    found = true;
-                } else {
-                    ids[k].removed = true;
+                if (!found) {
+                    observer.resync(i + 1);
+                    return std::nullopt;
                 }
+                if (i == 0) observer.frame_begin();
             }
-            if (!found) return std::nullopt;
-        }
 
-        ld2410::readUint16(reader); // just ignore data size
+            uint16_t data_size = ld2410::readUint16(reader);
 
-        for(size_t i = 0; i < sizeof(uint16_t); i++) {
-            bool found = false;
-            auto b = reader();
-            for(size_t k = 0; k < ids.size(); ++k) {
-                if (ids[k].removed) {
-                    continue;
+            for(size_t i = 0; i < sizeof(uint16_t); i++) {
+                bool found = false;
+                auto b = reader();
+                for(size_t k = 0; k < ids.size(); ++k) {
+                    if (ids[k].removed) {
+                        continue;
+                    }
+                    if (b == ids[k].definition_type.val.u8[i]) {
+                        found = true;
+                    } else {
+                        ids[k].removed = true;
+                    }
                 }
-                if (b == ids[k].definition_type.val.u8[i]) {
-                    found = true;
-                } else {
-                    ids[k].removed = true;
+                if (!found) {
+                    observer.resync(sizeof(uint32_t) + sizeof(uint16_t) + i + 1);
+                    return std::nullopt;
                 }
             }
-            if (!found) return std::nullopt;
+
+            if (data_size < sizeof(uint16_t) || data_size > max_frame_data_size) {
+                observer.malformed_frame();
+                return std::nullopt;
+            }
+
+            for(size_t k = 0; k < ids.size(); ++k) {
+                if (!ids[k].removed) return frame_start{k, data_size};
+            }
+            return std::nullopt;
+        }
+
+        // packets with gate arrays tell if their gate counts fit, all others always fit
+        template <typename T>
+        auto packet_within_bounds(const T &packet, int) -> decltype(packet.within_bounds()) {
+            return packet.within_bounds();
+        }
+
+        template <typename T>
+        bool packet_within_bounds(const T &, long) {
+            return true;
+        }
+
+        // Decodes the data of frame into packet, false if the data does not fit T.
+        template <typename T>
+        bool decode_frame_into(const RawFrame &frame, T &packet) {
+            BufferReader data{frame.payload.data(), frame.size};
+            packet.read(data);
+            return !data.overrun() && packet_within_bounds(packet, 0);
         }
 
+        // Decodes the data of frame as T, nothing if the data does not fit T.
+        template <typename T>
+        std::optional<T> decode_frame(const RawFrame &frame) {
+            T packet;
+            if (!decode_frame_into(frame, packet)) return std::nullopt;
+            return packet;
+        }
+
+        // Reads a whole frame of one of the types T. Never reads past the mfr
+        // of the frame and drops frames whose mfr does not match.
+        template <typename ...T, typename TReader, typename TObserver>
+        std::optional<RawFrame> read_frame(TReader &reader, TObserver &observer) {
+            static constexpr auto definitions = build_frame_definitions<T...>();
+
+            std::optional<frame_start> start = read_frame_start<T...>(reader, observer);
+            if (!start.has_value()) return std::nullopt;
+
+            const frame_definition &definition = definitions[start->index];
+            RawFrame frame;
+            frame.header = definition.definition_header.val.val;
+            frame.type = definition.definition_type.val.val;
+            frame.size = start->data_size - sizeof(uint16_t);
+            for(size_t i = 0; i < frame.size; ++i) {
+                frame.payload[i] = reader();
+            }
+
+            for(size_t i = 0; i < sizeof(uint32_t); ++i) {
+                if (reader() != definition.definition_mfr.val.u8[i]) {
+                    observer.malformed_frame();
+                    return std::nullopt;
+                }
+            }
+
+            return frame;
+        }
+    }
+
+    template <typename ...T, typename TReader, typename TObserver>
+    std::optional<std::variant<T...>> read_from_reader_many(TReader &&reader, TObserver &observer) {
+        static_assert(is_reader<TReader>::value, "a reader must be callable as uint8_t reader()");
+        using namespace internal_helpers;
+
+        std::optional<RawFrame> frame = read_frame<T...>(reader, observer);
+        if (!frame.has_value()) return std::nullopt;
+
         std::optional<std::variant<T...>> result = std::nullopt;
 
         for_([&](auto i){
-            if (!ids[i.value].removed) {
-                auto v = nth_element<i.value, T...>{};
-                v.read(reader);
+            using packet_t = nth_element<i.value, T...>;
+            if (!result.has_value() && frame->is<packet_t>()) {
+                // decoding only sees the data of this frame
+                observer.decode_begin();
+                std::optional<packet_t> v = decode_frame<packet_t>(*frame);
+                if (!v.has_value()) {
+                    observer.malformed_frame();
+                    return;
+                }
+                observer.frame_decoded(*v);
 
-                result = {v};
+                result = {*v};
             }
         }, std::make_index_sequence<sizeof...(T)>());
 
         return result;
     }
 
-    template <typename T>
-    std::optional<T> read_from_reader(const ld2410::reader_t &reader) {
+    // Reads the next frame of one of the types T without decoding it.
+    template <typename ...T, typename TReader, typename TObserver>
+    std::optional<RawFrame> read_raw_frame(TReader &&reader, TObserver &observer) {
+        static_assert(is_reader<TReader>::value, "a reader must be callable as uint8_t reader()");
+
+        std::optional<RawFrame> frame = internal_helpers::read_frame<T...>(reader, observer);
+        if (frame.has_value()) observer.frame_received(*frame);
+        return frame;
+    }
+
+    template <typename ...T, typename TReader>
+    std::optional<RawFrame> read_raw_frame(TReader &&reader) {
+        NullDecoderObserver observer;
+        return read_raw_frame<T...>(reader, observer);
+    }
+
+    // Decodes frame if it is one of the types T and its data fits that type.
+    template <typename ...T>
+    std::optional<std::variant<T...>> decode_raw_frame(const RawFrame &frame) {
+        std::optional<std::variant<T...>> result = std::nullopt;
+
+        internal_helpers::for_([&](auto i){
+            using packet_t = internal_helpers::nth_element<i.value, T...>;
+            if (!result.has_value() && frame.is<packet_t>()) {
+                std::optional<packet_t> v = internal_helpers::decode_frame<packet_t>(frame);
+                if (v.has_value()) result = {*v};
+            }
+        }, std::make_index_sequence<sizeof...(T)>());
+
+        return result;
+    }
+
+    template <typename ...T, typename TReader>
+    std::optional<std::variant<T...>> read_from_reader_many(TReader &&reader) {
+        NullDecoderObserver observer;
+        return read_from_reader_many<T...>(reader, observer);
+    }
+
+    template <typename T, typename TReader>
+    std::optional<T> read_from_reader(TReader &&reader) {
         std::optional<std::variant<T>> res = read_from_reader_many<T>(reader);
         if (!res.has_value()) return std::nullopt;
         return std::get<T>(*res);
     }
 
-    template <typename T1, typename T2, typename ...T>
-    std::optional<std::variant<T1, T2, T...>> read_from_reader(const ld2410::reader_t &reader) {
+    template <typename T1, typename T2, typename ...T, typename TReader>
+    std::optional<std::variant<T1, T2, T...>> read_from_reader(TReader &&reader) {
         return read_from_reader_many<T1, T2, T...>(reader);
     }
 
+    template <typename T, typename TReader, typename TObserver>
+    std::optional<T> read_from_reader(TReader &&reader, TObserver &observer) {
+        std::optional<std::variant<T>> res = read_from_reader_many<T>(reader, observer);
+        if (!res.has_value()) return std::nullopt;
+        return std::get<T>(*res);
+    }
+
+    template <typename T1, typename T2, typename ...T, typename TReader, typename TObserver>
+    std::optional<std::variant<T1, T2, T...>> read_from_reader(TReader &&reader, TObserver &observer) {
+        return read_from_reader_many<T1, T2, T...>(reader, observer);
+    }
+
     
 }
\ No newline at end of file
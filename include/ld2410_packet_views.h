@@ -0,0 +1,184 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "ld2410_packet_reader.h"
+
+// Read-only views over the payload of a data frame. Fields are loaded on
+// access from offsets computed at compile time from the field types, so a
+// frame can be inspected and dropped without decoding it.
+//
+//   auto frame = read_raw_frame<ReportingDataFrame, EngineeringModeDataFrame>(reader);
+//   ReportingDataFrameView view{*frame};
+//   if (view.valid() && view.target_state() != 0) ...
+
+namespace ld2410 {
+    // Fields of type Fields... packed one after the other.
+    template <typename ...Fields>
+    struct PayloadLayout {
+        static constexpr std::array<size_t, sizeof...(Fields) + 1> offsets() {
+            std::array<size_t, sizeof...(Fields) + 1> result{};
+            const size_t sizes[] = {sizeof(Fields)...};
+            for(size_t i = 0; i < sizeof...(Fields); ++i) {
+                result[i + 1] = result[i] + sizes[i];
+            }
+            return result;
+        }
+
+        template <size_t I>
+        using field_t = internal_helpers::nth_element<I, Fields...>;
+
+        template <size_t I>
+        static constexpr size_t offset = offsets()[I];
+
+        // bytes taken by all fields
+        static constexpr size_t size = offsets()[sizeof...(Fields)];
+
+        template <size_t I>
+        static field_t<I> get(const uint8_t *payload) {
+            field_t<I> v;
+            std::memcpy(&v, payload + offset<I>, sizeof(v));
+            return v;
+        }
+    };
+
+#define LD2410_FIELD_TYPE(packet, x) std::decay_t<decltype(std::declval<const packet &>().x())>
+
+    // Fixed fields both data frames start with, typed as the packets declare
+    // them: the target fields up to detection_distance, then two single bytes,
+    // tail and check of a reporting frame or the gate counts of an engineering
+    // mode frame.
+    using DataFrameLayout = PayloadLayout<
+        LD2410_FIELD_TYPE(ReportingDataFrame, target_state),
+        LD2410_FIELD_TYPE(ReportingDataFrame, movement_target_distance),
+        LD2410_FIELD_TYPE(ReportingDataFrame, exercise_target_energy_value),
+        LD2410_FIELD_TYPE(ReportingDataFrame, stationary_target_distance),
+        LD2410_FIELD_TYPE(ReportingDataFrame, stationary_target_energy_value),
+        LD2410_FIELD_TYPE(ReportingDataFrame, detection_distance),
+        LD2410_FIELD_TYPE(ReportingDataFrame, tail),
+        LD2410_FIELD_TYPE(ReportingDataFrame, check)>;
+
+    static_assert(std::is_same<DataFrameLayout, PayloadLayout<
+        LD2410_FIELD_TYPE(EngineeringModeDataFrame, target_state),
+        LD2410_FIELD_TYPE(EngineeringModeDataFrame, movement_target_distance),
+        LD2410_FIELD_TYPE(EngineeringModeDataFrame, exercise_target_energy_value),
+        LD2410_FIELD_TYPE(EngineeringModeDataFrame, stationary_target_distance),
+        LD2410_FIELD_TYPE(EngineeringModeDataFrame, stationary_target_energy_value),
+        LD2410_FIELD_TYPE(EngineeringModeDataFrame, detection_distance),
+        LD2410_FIELD_TYPE(EngineeringModeDataFrame, maximum_moving_distance_gate_n),
+        LD2410_FIELD_TYPE(EngineeringModeDataFrame, maximum_static_distance_gate_n)>>::value,
+        "both data frames start with the same fixed fields");
+
+    using ReportingDataFrameLayout = DataFrameLayout;
+    using EngineeringModeDataFrameLayout = DataFrameLayout;
+
+    // Fields both data frames start with.
+    template <typename TLayout>
+    class DataFrameView {
+    protected:
+        const uint8_t *m_payload;
+        size_t m_size;
+
+        template <size_t I>
+        typename TLayout::template field_t<I> field() const {
+            return TLayout::template get<I>(m_payload);
+        }
+
+    public:
+        using layout = TLayout;
+
+        DataFrameView(const uint8_t *payload, size_t size): m_payload(payload), m_size(size) {
+
+        }
+
+        explicit DataFrameView(const RawFrame &frame): m_payload(frame.payload.data()), m_size(frame.size) {
+
+        }
+
+        // the payload holds all fixed fields, accessors must not be used otherwise
+        bool valid() const {
+            return m_size >= TLayout::size;
+        }
+
+        uint8_t target_state() const {
+            return field<0>();
+        }
+
+        uint16_t movement_target_distance() const {
+            return field<1>();
+        }
+
+        uint8_t exercise_target_energy_value() const {
+            return field<2>();
+        }
+
+        uint16_t stationary_target_distance() const {
+            return field<3>();
+        }
+
+        uint8_t stationary_target_energy_value() const {
+            return field<4>();
+        }
+
+        uint16_t detection_distance() const {
+            return field<5>();
+        }
+    };
+
+    class ReportingDataFrameView: public DataFrameView<ReportingDataFrameLayout> {
+    public:
+        using packet_t = ReportingDataFrame;
+        using DataFrameView::DataFrameView;
+
+        uint8_t tail() const {
+            return field<6>();
+        }
+
+        uint8_t check() const {
+            return field<7>();
+        }
+    };
+
+    class EngineeringModeDataFrameView: public DataFrameView<EngineeringModeDataFrameLayout> {
+    public:
+        using packet_t = EngineeringModeDataFrame;
+        using DataFrameView::DataFrameView;
+
+        uint8_t maximum_moving_distance_gate_n() const {
+            return field<6>();
+        }
+
+        uint8_t maximum_static_distance_gate_n() const {
+            return field<7>();
+        }
+
+        // fixed fields and both gate arrays are in the payload
+        bool valid() const {
+            return DataFrameView::valid() && m_size >= gates_end();
+        }
+
+        size_t movement_gate_count() const {
+            return (size_t)maximum_moving_distance_gate_n() + 1;
+        }
+
+        size_t static_gate_count() const {
+            return (size_t)maximum_static_distance_gate_n() + 1;
+        }
+
+        uint8_t movement_distance_gate_energy_value(size_t gate) const {
+            return m_payload[layout::size + gate];
+        }
+
+        uint8_t static_distance_gate_energy_value(size_t gate) const {
+            return m_payload[layout::size + movement_gate_count() + gate];
+        }
+
+        // offset of the first byte after the gate energies
+        size_t gates_end() const {
+            return layout::size + movement_gate_count() + static_gate_count();
+        }
+    };
+}
@@ -1,27 +1,43 @@
 #pragma once
 
+#include "ld2410_packet_writer.h"
+#include "ld2410_packet_reader.h"
+
 #ifndef LD2410_MILLIS 
 #define LD2410_MILLIS millis()
 #endif
 
-#include "ld2410_packet_writer.h"
-#include "ld2410_packet_reader.h"
-
 namespace ld2410 {
-    
-    template<typename T, typename TWriter>
-    std::optional<typename T::ack_t> write_and_read_ack(TWriter &writer, const reader_t &reader, const T &packet, const decltype(LD2410_MILLIS) timeout = 5000) {
+    // how long a command waits for its ack unless told otherwise, here and in
+    // the command sequences built on write_and_read_ack()
+    const decltype(LD2410_MILLIS) default_ack_timeout = 5000;
+
+    template<typename T, typename TWriter, typename TReader, typename TObserver>
+    std::optional<typename T::ack_t> write_and_read_ack(TWriter &writer, TReader &&reader, const T &packet, const decltype(LD2410_MILLIS) timeout, TObserver &observer) {
         write_to_writer(writer, packet);
 
-        decltype(LD2410_MILLIS) timeout_on = LD2410_MILLIS + timeout;
+        decltype(LD2410_MILLIS) started_on = LD2410_MILLIS;
+        decltype(LD2410_MILLIS) timeout_on = started_on + timeout;
         
         while(true) {
-            if (LD2410_MILLIS >= timeout_on) return std::nullopt;
+            if (LD2410_MILLIS >= timeout_on) {
+                observer.ack_timeout();
+                return std::nullopt;
+            }
 
-            std::optional<typename T::ack_t> result = read_from_reader<typename T::ack_t>(reader);
-            if (result.has_value()) return result;
+            std::optional<typename T::ack_t> result = read_from_reader<typename T::ack_t>(reader, observer);
+            if (result.has_value()) {
+                observer.ack_received(*result, LD2410_MILLIS - started_on);
+                return result;
+            }
         }
         
     }
+
+    template<typename T, typename TWriter, typename TReader>
+    std::optional<typename T::ack_t> write_and_read_ack(TWriter &writer, TReader &&reader, const T &packet, const decltype(LD2410_MILLIS) timeout = default_ack_timeout) {
+        NullDecoderObserver observer;
+        return write_and_read_ack(writer, reader, packet, timeout, observer);
+    }
     
 }
\ No newline at end of file
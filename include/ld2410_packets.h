@@ -4,11 +4,16 @@
 #include <vector>
 #include <variant>
 
+#include "ld2410_inline_vector.h"
 #include "ld2410_reader.h"
 #include "ld2410_writer.h"
 
+#ifndef LD2410_MAX_GATE_N
+#define LD2410_MAX_GATE_N 8
+#endif
 
-#define LD2410_GETTER(x) decltype(m_##x) x() const { return m_##x; }
+
+#define LD2410_GETTER(x) const decltype(m_##x) &x() const { return m_##x; }
 #define LD2410_SETTER(x) void x(decltype(m_##x) v) { m_##x = v; }
 
 #define LD2410_PROP(t, x) protected:\
@@ -22,13 +27,21 @@ LD2410_SETTER(x)
 #define LD2410_WRITE_SHORT(x) write_any<decltype(m_##x)>(writer, x())
 #define LD2410_WRITE_SWAPPED_SHORT(x) x(write_any_swapped<decltype(m_##x)>(writer))
 
+#define LD2410_VISIT_SHORT(x) visitor(#x, x())
+
 #define LD2410_PACKET class 
 
 namespace ld2410 {
     const uint32_t CommandHeader = 0xfafbfcfd;
     const uint32_t CommandMFR = 0x01020304;
     const uint32_t ReportingDataHeader = 0xf1f2f3f4;
-    const uint32_t ReportingDataMFR = 0x04060708;
+    const uint32_t ReportingDataMFR = 0xf5f6f7f8;
+
+    // Gate values are stored inline, a frame announcing more than max_gate_n
+    // gates is rejected before any gate is read.
+    template <std::size_t max_gate_n>
+    using basic_gate_values_t = InlineVector<uint8_t, max_gate_n + 1>;
+    using gate_values_t = basic_gate_values_t<LD2410_MAX_GATE_N>;
 
     template<typename T>
     class to_bytes_union {
@@ -47,7 +60,8 @@ namespace ld2410 {
     };
 
 
-    LD2410_PACKET EngineeringModeDataFrame {
+    template <std::size_t max_gate_n = LD2410_MAX_GATE_N>
+    LD2410_PACKET BasicEngineeringModeDataFrame {
         LD2410_PROP(uint8_t, target_state)
         LD2410_PROP(uint16_t, movement_target_distance)
         LD2410_PROP(uint8_t, exercise_target_energy_value)
@@ -56,15 +70,21 @@ namespace ld2410 {
         LD2410_PROP(uint16_t, detection_distance)
         LD2410_PROP(uint8_t, maximum_moving_distance_gate_n)
         LD2410_PROP(uint8_t, maximum_static_distance_gate_n)
-        LD2410_PROP(std::vector<uint8_t>, movement_distance_gate_energy_value)
-        LD2410_PROP(std::vector<uint8_t>, static_distance_gate_energy_value)
+        LD2410_PROP(basic_gate_values_t<max_gate_n>, movement_distance_gate_energy_value)
+        LD2410_PROP(basic_gate_values_t<max_gate_n>, static_distance_gate_energy_value)
 
     public:
         static inline constexpr to_bytes_union<uint32_t> definition_header{ReportingDataHeader};
         static inline constexpr to_bytes_union<uint32_t> definition_mfr{ReportingDataMFR};
         static inline constexpr to_bytes_union<uint16_t> definition_type{0xaa01};
 
-        void read(const ld2410::reader_t &reader) {
+        // the gate counts fit the storage, read() stops early otherwise
+        bool within_bounds() const {
+            return m_maximum_moving_distance_gate_n <= max_gate_n && m_maximum_static_distance_gate_n <= max_gate_n;
+        }
+
+        template <typename TReader>
+        void read(TReader &reader) {
             LD2410_READ_SHORT(target_state);
             LD2410_READ_SHORT(movement_target_distance);
             LD2410_READ_SHORT(exercise_target_energy_value);
@@ -73,8 +93,9 @@ namespace ld2410 {
             LD2410_READ_SHORT(detection_distance);
             LD2410_READ_SHORT(maximum_moving_distance_gate_n);
             LD2410_READ_SHORT(maximum_static_distance_gate_n);
+            if (!within_bounds()) return;
 
-            std::vector<uint8_t> b;
+            basic_gate_values_t<max_gate_n> b;
             b.resize(maximum_moving_distance_gate_n()+1);
             for(size_t i = 0; i < b.size(); ++i) {
                 b[i] = reader();
@@ -87,8 +108,58 @@ namespace ld2410 {
             }
             static_distance_gate_energy_value(b);
         }
+
+        template <typename TWriter>
+        void write(TWriter &writer) const {
+            LD2410_WRITE_SHORT(target_state);
+            LD2410_WRITE_SHORT(movement_target_distance);
+            LD2410_WRITE_SHORT(exercise_target_energy_value);
+            LD2410_WRITE_SHORT(stationary_target_distance);
+            LD2410_WRITE_SHORT(stationary_target_energy_value);
+            LD2410_WRITE_SHORT(detection_distance);
+            LD2410_WRITE_SHORT(maximum_moving_distance_gate_n);
+            LD2410_WRITE_SHORT(maximum_static_distance_gate_n);
+            for(uint8_t v : movement_distance_gate_energy_value()) {
+                write_any(writer, v);
+            }
+            for(uint8_t v : static_distance_gate_energy_value()) {
+                write_any(writer, v);
+            }
+        }
+
+        // calls visitor(name, value) for every field, in wire order
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(target_state);
+            LD2410_VISIT_SHORT(movement_target_distance);
+            LD2410_VISIT_SHORT(exercise_target_energy_value);
+            LD2410_VISIT_SHORT(stationary_target_distance);
+            LD2410_VISIT_SHORT(stationary_target_energy_value);
+            LD2410_VISIT_SHORT(detection_distance);
+            LD2410_VISIT_SHORT(maximum_moving_distance_gate_n);
+            LD2410_VISIT_SHORT(maximum_static_distance_gate_n);
+            LD2410_VISIT_SHORT(movement_distance_gate_energy_value);
+            LD2410_VISIT_SHORT(static_distance_gate_energy_value);
+        }
+
+        size_t size() const {
+            size_t size_ = 0;
+            size_ += sizeof(BasicEngineeringModeDataFrame::m_target_state);
+            size_ += sizeof(BasicEngineeringModeDataFrame::m_movement_target_distance);
+            size_ += sizeof(BasicEngineeringModeDataFrame::m_exercise_target_energy_value);
+            size_ += sizeof(BasicEngineeringModeDataFrame::m_stationary_target_distance);
+            size_ += sizeof(BasicEngineeringModeDataFrame::m_stationary_target_energy_value);
+            size_ += sizeof(BasicEngineeringModeDataFrame::m_detection_distance);
+            size_ += sizeof(BasicEngineeringModeDataFrame::m_maximum_moving_distance_gate_n);
+            size_ += sizeof(BasicEngineeringModeDataFrame::m_maximum_static_distance_gate_n);
+            size_ += m_movement_distance_gate_energy_value.size();
+            size_ += m_static_distance_gate_energy_value.size();
+            return size_;
+        }
     };
 
+    using EngineeringModeDataFrame = BasicEngineeringModeDataFrame<>;
+
     LD2410_PACKET ReportingDataFrame {
         LD2410_PROP(uint8_t, target_state)
         LD2410_PROP(uint16_t, movement_target_distance)
@@ -104,7 +175,8 @@ namespace ld2410 {
         static inline constexpr to_bytes_union<uint32_t> definition_mfr{ReportingDataMFR};
         static inline constexpr to_bytes_union<uint16_t> definition_type{0xaa02};
 
-        void read(const ld2410::reader_t &reader) {
+        template <typename TReader>
+        void read(TReader &reader) {
             LD2410_READ_SHORT(target_state);
             LD2410_READ_SHORT(movement_target_distance);
             LD2410_READ_SHORT(exercise_target_energy_value);
@@ -114,6 +186,42 @@ namespace ld2410 {
             LD2410_READ_SHORT(tail);
             LD2410_READ_SHORT(check);
         }
+
+        template <typename TWriter>
+        void write(TWriter &writer) const {
+            LD2410_WRITE_SHORT(target_state);
+            LD2410_WRITE_SHORT(movement_target_distance);
+            LD2410_WRITE_SHORT(exercise_target_energy_value);
+            LD2410_WRITE_SHORT(stationary_target_distance);
+            LD2410_WRITE_SHORT(stationary_target_energy_value);
+            LD2410_WRITE_SHORT(detection_distance);
+            LD2410_WRITE_SHORT(tail);
+            LD2410_WRITE_SHORT(check);
+        }
+
+        // tail and check frame the values and are not visited
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(target_state);
+            LD2410_VISIT_SHORT(movement_target_distance);
+            LD2410_VISIT_SHORT(exercise_target_energy_value);
+            LD2410_VISIT_SHORT(stationary_target_distance);
+            LD2410_VISIT_SHORT(stationary_target_energy_value);
+            LD2410_VISIT_SHORT(detection_distance);
+        }
+
+        static const size_t size() {
+            size_t size_ = 0;
+            size_ += sizeof(ReportingDataFrame::m_target_state);
+            size_ += sizeof(ReportingDataFrame::m_movement_target_distance);
+            size_ += sizeof(ReportingDataFrame::m_exercise_target_energy_value);
+            size_ += sizeof(ReportingDataFrame::m_stationary_target_distance);
+            size_ += sizeof(ReportingDataFrame::m_stationary_target_energy_value);
+            size_ += sizeof(ReportingDataFrame::m_detection_distance);
+            size_ += sizeof(ReportingDataFrame::m_tail);
+            size_ += sizeof(ReportingDataFrame::m_check);
+            return size_;
+        }
     };
 
     LD2410_PACKET EnableConfigurationCommandAck {
@@ -126,12 +234,27 @@ namespace ld2410 {
         static inline constexpr to_bytes_union<uint32_t> definition_mfr{CommandMFR};
         static inline constexpr to_bytes_union<uint16_t> definition_type{0x01ff};
 
-        void read(const ld2410::reader_t &reader) {
+        template <typename TReader>
+        void read(TReader &reader) {
             LD2410_READ_SHORT(status);
             LD2410_READ_SHORT(protocol_version);
             LD2410_READ_SHORT(buffer);
         }
 
+        template <typename TWriter>
+        void write(TWriter &writer) const {
+            LD2410_WRITE_SHORT(status);
+            LD2410_WRITE_SHORT(protocol_version);
+            LD2410_WRITE_SHORT(buffer);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(status);
+            LD2410_VISIT_SHORT(protocol_version);
+            LD2410_VISIT_SHORT(buffer);
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             size_ += sizeof(EnableConfigurationCommandAck::m_status);
@@ -155,6 +278,16 @@ namespace ld2410 {
             LD2410_WRITE_SHORT(value);
         }
 
+        template <typename TReader>
+        void read(TReader &reader) {
+            LD2410_READ_SHORT(value);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(value);
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             size_ += sizeof(EnableConfigurationCommand::m_value);
@@ -170,10 +303,21 @@ namespace ld2410 {
         static inline constexpr to_bytes_union<uint32_t> definition_mfr{CommandMFR};
         static inline constexpr to_bytes_union<uint16_t> definition_type{0x01fe};
 
-        void read(const ld2410::reader_t &reader) {
+        template <typename TReader>
+        void read(TReader &reader) {
             LD2410_READ_SHORT(status);
         }
 
+        template <typename TWriter>
+        void write(TWriter &writer) const {
+            LD2410_WRITE_SHORT(status);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(status);
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             size_ += sizeof(EndConfigurationCommandAck::m_status);
@@ -190,10 +334,20 @@ namespace ld2410 {
         using ack_t = EndConfigurationCommandAck;
 
         template <typename TWriter>
-        void write(TWriter &writer) const {
+        void write(TWriter &) const {
             
         }
 
+        template <typename TReader>
+        void read(TReader &) {
+
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&) const {
+
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             return size_;
@@ -208,10 +362,21 @@ namespace ld2410 {
         static inline constexpr to_bytes_union<uint32_t> definition_mfr{CommandMFR};
         static inline constexpr to_bytes_union<uint16_t> definition_type{0x0160};
 
-        void read(const ld2410::reader_t &reader) {
+        template <typename TReader>
+        void read(TReader &reader) {
             LD2410_READ_SHORT(status);
         }
 
+        template <typename TWriter>
+        void write(TWriter &writer) const {
+            LD2410_WRITE_SHORT(status);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(status);
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             size_ += sizeof(MaximumDistanceGateandUnmannedDurationParameterConfigurationCommandAck::m_status);
@@ -243,6 +408,26 @@ namespace ld2410 {
             LD2410_WRITE_SHORT(section_unattended_duration);
         }
 
+        template <typename TReader>
+        void read(TReader &reader) {
+            LD2410_READ_SHORT(maximum_moving_distance_word);
+            LD2410_READ_SHORT(maximum_moving_distance_parameter);
+            LD2410_READ_SHORT(maximum_static_distance_door_word);
+            LD2410_READ_SHORT(maximum_static_distance_door_parameter);
+            LD2410_READ_SHORT(no_person_duration);
+            LD2410_READ_SHORT(section_unattended_duration);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(maximum_moving_distance_word);
+            LD2410_VISIT_SHORT(maximum_moving_distance_parameter);
+            LD2410_VISIT_SHORT(maximum_static_distance_door_word);
+            LD2410_VISIT_SHORT(maximum_static_distance_door_parameter);
+            LD2410_VISIT_SHORT(no_person_duration);
+            LD2410_VISIT_SHORT(section_unattended_duration);
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             size_ += sizeof(MaximumDistanceGateandUnmannedDurationParameterConfigurationCommand::m_maximum_moving_distance_word);
@@ -255,14 +440,15 @@ namespace ld2410 {
         }
     };
 
-    LD2410_PACKET ReadParameterCommandAck {
+    template <std::size_t max_gate_n = LD2410_MAX_GATE_N>
+    LD2410_PACKET BasicReadParameterCommandAck {
         LD2410_PROP(uint16_t, status)
         LD2410_PROP(uint8_t, header)
         LD2410_PROP(uint8_t, maximum_distance_gate_n)
         LD2410_PROP(uint8_t, configure_maximum_moving_distance_gate)
         LD2410_PROP(uint8_t, configure_maximum_static_gate)
-        LD2410_PROP(std::vector<uint8_t>, distance_gate_motion_sensitivity)
-        LD2410_PROP(std::vector<uint8_t>, distance_gate_rest_sensitivity)
+        LD2410_PROP(basic_gate_values_t<max_gate_n>, distance_gate_motion_sensitivity)
+        LD2410_PROP(basic_gate_values_t<max_gate_n>, distance_gate_rest_sensitivity)
         LD2410_PROP(uint16_t, no_time_duration)
 
     public:
@@ -270,14 +456,21 @@ namespace ld2410 {
         static inline constexpr to_bytes_union<uint32_t> definition_mfr{CommandMFR};
         static inline constexpr to_bytes_union<uint16_t> definition_type{0x0161};
 
-        void read(const ld2410::reader_t &reader) {
+        // the gate count fits the storage, read() stops early otherwise
+        bool within_bounds() const {
+            return m_maximum_distance_gate_n <= max_gate_n;
+        }
+
+        template <typename TReader>
+        void read(TReader &reader) {
             LD2410_READ_SHORT(status);
             LD2410_READ_SHORT(header);
             LD2410_READ_SHORT(maximum_distance_gate_n);
             LD2410_READ_SHORT(configure_maximum_moving_distance_gate);
             LD2410_READ_SHORT(configure_maximum_static_gate);
+            if (!within_bounds()) return;
 
-            std::vector<uint8_t> b;
+            basic_gate_values_t<max_gate_n> b;
             b.resize(maximum_distance_gate_n()+1);
             for(size_t i = 0; i < b.size(); ++i) {
                 b[i] = reader();
@@ -291,19 +484,50 @@ namespace ld2410 {
             LD2410_READ_SHORT(no_time_duration);
         }
 
+        template <typename TWriter>
+        void write(TWriter &writer) const {
+            LD2410_WRITE_SHORT(status);
+            LD2410_WRITE_SHORT(header);
+            LD2410_WRITE_SHORT(maximum_distance_gate_n);
+            LD2410_WRITE_SHORT(configure_maximum_moving_distance_gate);
+            LD2410_WRITE_SHORT(configure_maximum_static_gate);
+            for(uint8_t v : distance_gate_motion_sensitivity()) {
+                write_any(writer, v);
+            }
+            for(uint8_t v : distance_gate_rest_sensitivity()) {
+                write_any(writer, v);
+            }
+            LD2410_WRITE_SHORT(no_time_duration);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(status);
+            LD2410_VISIT_SHORT(header);
+            LD2410_VISIT_SHORT(maximum_distance_gate_n);
+            LD2410_VISIT_SHORT(configure_maximum_moving_distance_gate);
+            LD2410_VISIT_SHORT(configure_maximum_static_gate);
+            LD2410_VISIT_SHORT(distance_gate_motion_sensitivity);
+            LD2410_VISIT_SHORT(distance_gate_rest_sensitivity);
+            LD2410_VISIT_SHORT(no_time_duration);
+        }
+
         size_t size() const {
             size_t size_ = 0;
-            size_ += sizeof(ReadParameterCommandAck::m_header);
-            size_ += sizeof(ReadParameterCommandAck::m_maximum_distance_gate_n);
-            size_ += sizeof(ReadParameterCommandAck::m_configure_maximum_moving_distance_gate);
-            size_ += sizeof(ReadParameterCommandAck::m_configure_maximum_static_gate);
-            size_ += ReadParameterCommandAck::m_maximum_distance_gate_n;
-            size_ += ReadParameterCommandAck::m_maximum_distance_gate_n;
-            size_ += sizeof(ReadParameterCommandAck::m_no_time_duration);
+            size_ += sizeof(BasicReadParameterCommandAck::m_status);
+            size_ += sizeof(BasicReadParameterCommandAck::m_header);
+            size_ += sizeof(BasicReadParameterCommandAck::m_maximum_distance_gate_n);
+            size_ += sizeof(BasicReadParameterCommandAck::m_configure_maximum_moving_distance_gate);
+            size_ += sizeof(BasicReadParameterCommandAck::m_configure_maximum_static_gate);
+            size_ += m_distance_gate_motion_sensitivity.size();
+            size_ += m_distance_gate_rest_sensitivity.size();
+            size_ += sizeof(BasicReadParameterCommandAck::m_no_time_duration);
             return size_;
         }
     };
 
+    using ReadParameterCommandAck = BasicReadParameterCommandAck<>;
+
     LD2410_PACKET ReadParameterCommand {
     public:
         static inline constexpr to_bytes_union<uint32_t> definition_header{CommandHeader};
@@ -312,7 +536,17 @@ namespace ld2410 {
         using ack_t = ReadParameterCommandAck;
 
         template <typename TWriter>
-        void write(TWriter &writer) const {
+        void write(TWriter &) const {
+
+        }
+
+        template <typename TReader>
+        void read(TReader &) {
+
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&) const {
 
         }
 
@@ -330,10 +564,21 @@ namespace ld2410 {
         static inline constexpr to_bytes_union<uint32_t> definition_mfr{CommandMFR};
         static inline constexpr to_bytes_union<uint16_t> definition_type{0x0162};
 
-        void read(const ld2410::reader_t &reader) {
+        template <typename TReader>
+        void read(TReader &reader) {
             LD2410_READ_SHORT(status);
         }
 
+        template <typename TWriter>
+        void write(TWriter &writer) const {
+            LD2410_WRITE_SHORT(status);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(status);
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             size_ += sizeof(EnableEngineeringModeCommandAck::m_status);
@@ -349,7 +594,17 @@ namespace ld2410 {
         using ack_t = EnableEngineeringModeCommandAck;
 
         template <typename TWriter>
-        void write(TWriter &writer) const {
+        void write(TWriter &) const {
+
+        }
+
+        template <typename TReader>
+        void read(TReader &) {
+
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&) const {
 
         }
 
@@ -367,10 +622,21 @@ namespace ld2410 {
         static inline constexpr to_bytes_union<uint32_t> definition_mfr{CommandMFR};
         static inline constexpr to_bytes_union<uint16_t> definition_type{0x0163};
 
-        void read(const ld2410::reader_t &reader) {
+        template <typename TReader>
+        void read(TReader &reader) {
             LD2410_READ_SHORT(status);
         }
 
+        template <typename TWriter>
+        void write(TWriter &writer) const {
+            LD2410_WRITE_SHORT(status);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(status);
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             size_ += sizeof(CloseEngineeringModeCommandAck::m_status);
@@ -386,7 +652,17 @@ namespace ld2410 {
         using ack_t = CloseEngineeringModeCommandAck;
 
         template <typename TWriter>
-        void write(TWriter &writer) const {
+        void write(TWriter &) const {
+
+        }
+
+        template <typename TReader>
+        void read(TReader &) {
+
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&) const {
 
         }
 
@@ -404,10 +680,21 @@ namespace ld2410 {
         static inline constexpr to_bytes_union<uint32_t> definition_mfr{CommandMFR};
         static inline constexpr to_bytes_union<uint16_t> definition_type{0x0164};
 
-        void read(const ld2410::reader_t &reader) {
+        template <typename TReader>
+        void read(TReader &reader) {
             LD2410_READ_SHORT(status);
         }
 
+        template <typename TWriter>
+        void write(TWriter &writer) const {
+            LD2410_WRITE_SHORT(status);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(status);
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             size_ += sizeof(RangeSensitivityConfigurationCommandAck::m_status);
@@ -439,6 +726,26 @@ namespace ld2410 {
             LD2410_WRITE_SHORT(static_sensitivity_value);
         }
 
+        template <typename TReader>
+        void read(TReader &reader) {
+            LD2410_READ_SHORT(distance_gate_word);
+            LD2410_READ_SHORT(distance_gate_value);
+            LD2410_READ_SHORT(motion_sensitivity_word);
+            LD2410_READ_SHORT(motion_sensitivity_value);
+            LD2410_READ_SHORT(static_sensitivity_word);
+            LD2410_READ_SHORT(static_sensitivity_value);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(distance_gate_word);
+            LD2410_VISIT_SHORT(distance_gate_value);
+            LD2410_VISIT_SHORT(motion_sensitivity_word);
+            LD2410_VISIT_SHORT(motion_sensitivity_value);
+            LD2410_VISIT_SHORT(static_sensitivity_word);
+            LD2410_VISIT_SHORT(static_sensitivity_value);
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             size_ += sizeof(RangeSensitivityConfigurationCommand::m_distance_gate_word);
@@ -461,12 +768,27 @@ namespace ld2410 {
         static inline constexpr to_bytes_union<uint32_t> definition_mfr{CommandMFR};
         static inline constexpr to_bytes_union<uint16_t> definition_type{0x01a0};
 
-        void read(const ld2410::reader_t &reader) {
+        template <typename TReader>
+        void read(TReader &reader) {
             LD2410_READ_SHORT(firmware_type);
             LD2410_READ_SHORT(major_version_number);
             LD2410_READ_SHORT(minor_version_number);
         }
 
+        template <typename TWriter>
+        void write(TWriter &writer) const {
+            LD2410_WRITE_SHORT(firmware_type);
+            LD2410_WRITE_SHORT(major_version_number);
+            LD2410_WRITE_SHORT(minor_version_number);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(firmware_type);
+            LD2410_VISIT_SHORT(major_version_number);
+            LD2410_VISIT_SHORT(minor_version_number);
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             size_ += sizeof(ReadFirmwareVersionCommandAck::m_firmware_type);
@@ -485,7 +807,17 @@ namespace ld2410 {
         using ack_t = ReadFirmwareVersionCommandAck;
 
         template <typename TWriter>
-        void write(TWriter &writer) const {
+        void write(TWriter &) const {
+        }
+
+        template <typename TReader>
+        void read(TReader &) {
+
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&) const {
+
         }
 
         static const size_t size() {
@@ -502,10 +834,21 @@ namespace ld2410 {
         static inline constexpr to_bytes_union<uint32_t> definition_mfr{CommandMFR};
         static inline constexpr to_bytes_union<uint16_t> definition_type{0x01a1};
 
-        void read(const ld2410::reader_t &reader) {
+        template <typename TReader>
+        void read(TReader &reader) {
             LD2410_READ_SHORT(status);
         }
 
+        template <typename TWriter>
+        void write(TWriter &writer) const {
+            LD2410_WRITE_SHORT(status);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(status);
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             size_ += sizeof(SetSerialPortBaudRateAck::m_status);
@@ -524,6 +867,20 @@ namespace ld2410 {
         BaudRate_460800 = 8,
     };
 
+    inline uint32_t baud_rate_to_bps(BaudRate rate) {
+        switch(rate) {
+            case BaudRate::BaudRate_9600: return 9600;
+            case BaudRate::BaudRate_19200: return 19200;
+            case BaudRate::BaudRate_38400: return 38400;
+            case BaudRate::BaudRate_57600: return 57600;
+            case BaudRate::BaudRate_115200: return 115200;
+            case BaudRate::BaudRate_230400: return 230400;
+            case BaudRate::BaudRate_256000: return 256000;
+            case BaudRate::BaudRate_460800: return 460800;
+        }
+        return 0;
+    }
+
     LD2410_PACKET SetSerialPortBaudRate {
         LD2410_PROP(BaudRate, baudRate_selection_index)
 
@@ -538,6 +895,16 @@ namespace ld2410 {
             LD2410_WRITE_SHORT(baudRate_selection_index);
         }
 
+        template <typename TReader>
+        void read(TReader &reader) {
+            LD2410_READ_SHORT(baudRate_selection_index);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(baudRate_selection_index);
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             size_ += sizeof(SetSerialPortBaudRate::m_baudRate_selection_index);
@@ -553,10 +920,21 @@ namespace ld2410 {
         static inline constexpr to_bytes_union<uint32_t> definition_mfr{CommandMFR};
         static inline constexpr to_bytes_union<uint16_t> definition_type{0x01a2};
 
-        void read(const ld2410::reader_t &reader) {
+        template <typename TReader>
+        void read(TReader &reader) {
             LD2410_READ_SHORT(status);
         }
 
+        template <typename TWriter>
+        void write(TWriter &writer) const {
+            LD2410_WRITE_SHORT(status);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(status);
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             size_ += sizeof(FactoryResetAck::m_status);
@@ -573,7 +951,17 @@ namespace ld2410 {
         using ack_t = FactoryResetAck;
 
         template <typename TWriter>
-        void write(TWriter &writer) const {
+        void write(TWriter &) const {
+        }
+
+        template <typename TReader>
+        void read(TReader &) {
+
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&) const {
+
         }
 
         static const size_t size() {
@@ -590,10 +978,21 @@ namespace ld2410 {
         static inline constexpr to_bytes_union<uint32_t> definition_mfr{CommandMFR};
         static inline constexpr to_bytes_union<uint16_t> definition_type{0x01a3};
 
-        void read(const ld2410::reader_t &reader) {
+        template <typename TReader>
+        void read(TReader &reader) {
             LD2410_READ_SHORT(status);
         }
 
+        template <typename TWriter>
+        void write(TWriter &writer) const {
+            LD2410_WRITE_SHORT(status);
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&visitor) const {
+            LD2410_VISIT_SHORT(status);
+        }
+
         static const size_t size() {
             size_t size_ = 0;
             size_ += sizeof(RestartModuleAck::m_status);
@@ -610,7 +1009,17 @@ namespace ld2410 {
         using ack_t = RestartModuleAck;
 
         template <typename TWriter>
-        void write(TWriter &writer) const {
+        void write(TWriter &) const {
+        }
+
+        template <typename TReader>
+        void read(TReader &) {
+
+        }
+
+        template <typename TVisitor>
+        void visit_fields(TVisitor &&) const {
+
         }
 
         static const size_t size() {
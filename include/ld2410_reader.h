@@ -1,18 +1,53 @@
 #pragma once
 
 #include <functional>
+#include <memory>
+#include <type_traits>
 
 #include "ld2410_framework_switch.h"
 
 namespace ld2410 {
+    // Non-owning reference to a reader. Unlike std::function it never copies
+    // or allocates, the referenced reader must outlive the call it is passed to.
+    class ReaderRef {
+        void *m_reader;
+        uint8_t (*m_call)(void *reader);
+
+    public:
+        template <typename TReader, typename = typename std::enable_if<!std::is_same<typename std::decay<TReader>::type, ReaderRef>::value>::type>
+        ReaderRef(TReader &&reader):
+            m_reader((void *)std::addressof(reader)),
+            m_call([](void *r) -> uint8_t { return (*static_cast<typename std::remove_reference<TReader>::type *>(r))(); }) {
+
+        }
+
+        uint8_t operator()() const {
+            return m_call(m_reader);
+        }
+    };
+
+#ifdef LD2410_ZERO_ALLOC
+    using reader_t = ReaderRef;
+#else
     using reader_t = std::function<uint8_t()>;
+#endif
+
+    // Readers are taken as template parameters so calls to them can be inlined.
+    // Anything callable without arguments that returns a byte is a reader.
+    template <typename TReader, typename = void>
+    struct is_reader: std::false_type {};
 
-    static inline uint16_t readUint16(const reader_t &r) {
-        return r() | (r() << 8);
+    template <typename TReader>
+    struct is_reader<TReader, typename std::enable_if<std::is_convertible<decltype(std::declval<TReader &>()()), uint8_t>::value>::type>: std::true_type {};
+
+    template <typename TReader>
+    static inline uint16_t readUint16(TReader &r) {
+        uint16_t low = r();
+        return low | (r() << 8);
     }
 
-    template <typename T>
-    static inline T read_any_swapped(const reader_t &r) {
+    template <typename T, typename TReader>
+    static inline T read_any_swapped(TReader &r) {
         union {
             T v;
             uint8_t u8[sizeof(T)];
@@ -25,8 +60,8 @@ namespace ld2410 {
         return res.v;
     }
 
-    template <typename T>
-    static inline T read_any(const reader_t &r) {
+    template <typename T, typename TReader>
+    static inline T read_any(TReader &r) {
         union {
             T v;
             uint8_t u8[sizeof(T)];
@@ -38,4 +73,33 @@ namespace ld2410 {
 
         return res.v;
     }
+
+    class BufferReader {
+        const uint8_t *m_data;
+        size_t m_size;
+        size_t m_index;
+        bool m_overrun;
+
+    public:
+        BufferReader(const uint8_t *data, size_t size): m_data(data), m_size(size), m_index(0), m_overrun(false) {
+
+        }
+
+        uint8_t operator()() {
+            if (m_index >= m_size) {
+                m_overrun = true;
+                return 0;
+            }
+            return m_data[m_index++];
+        }
+
+        size_t position() const {
+            return m_index;
+        }
+
+        // something was read past the end of the buffer
+        bool overrun() const {
+            return m_overrun;
+        }
+    };
 }
\ No newline at end of file
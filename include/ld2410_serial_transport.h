@@ -0,0 +1,516 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "ld2410_frame_assembler.h"
+
+// Serial I/O for many sensors on one Linux thread. Every transport owns no
+// file descriptor, it reads from the ports added to it and batches writes
+// queued for them, e.g. through writer(sensor) passed to write_to_writer().
+//
+//   SerialTransport transport;
+//   if (!transport.init()) ...
+//   size_t sensor = transport.add(fd);
+//   auto writer = transport.writer(sensor);
+//   write_to_writer(writer, EnableEngineeringModeCommand{});
+//   transport.poll(100, [&](size_t sensor, const uint8_t *data, size_t size) {
+//       assemblers[sensor].push(data, size, handler);
+//   });
+//
+// With liburing 2.6 or newer SerialTransport uses io_uring: one multishot
+// read stays posted per port and fills buffers of a ring registered with the
+// kernel, all queued writes go out with one submit. It falls back to epoll
+// if the kernel refuses the ring or has no multishot reads (before 6.7).
+// A port whose read fails or reaches end of file stops being read, poll()
+// returns -1 and error() tells the errno, EPIPE for end of file. Ports are to
+// be set up with VMIN 1, a tty with VMIN 0 reads 0 bytes once drained, which
+// io_uring takes for end of file. Linux only, not part of ld2410.h.
+
+#if __has_include(<liburing.h>)
+#include <liburing.h>
+#ifdef IO_URING_CHECK_VERSION
+#if !IO_URING_CHECK_VERSION(2, 6)
+#define LD2410_HAS_IO_URING 1
+#endif
+#endif
+#endif
+
+namespace ld2410 {
+    // error() of a port whose other end is gone
+    const int serial_end_of_file = EPIPE;
+
+    struct SerialTransportOptions {
+        // bytes per read buffer
+        size_t read_buffer_size = 256;
+        // read buffers shared by all ports, a power of two
+        unsigned read_buffers = 64;
+        // io_uring submission queue entries
+        unsigned queue_depth = 256;
+    };
+
+    // Queues writes to one port of TTransport, for write_to_writer().
+    template <typename TTransport>
+    class TransportWriter {
+        TTransport *m_transport;
+        size_t m_sensor;
+
+    public:
+        TransportWriter(TTransport &transport, size_t sensor): m_transport(&transport), m_sensor(sensor) {
+
+        }
+
+        void operator()(const uint8_t *data, size_t size) {
+            m_transport->write(m_sensor, data, size);
+        }
+    };
+
+    class EpollSerialTransport {
+        struct Port {
+            int fd;
+            std::vector<uint8_t> pending;
+            // errno of the read that stopped reading the port
+            int error;
+        };
+
+        SerialTransportOptions m_options;
+        int m_epoll = -1;
+        std::vector<Port> m_ports;
+        std::vector<uint8_t> m_read_buffer;
+
+    public:
+        explicit EpollSerialTransport(const SerialTransportOptions &options = {}): m_options(options) {
+
+        }
+
+        EpollSerialTransport(const EpollSerialTransport &) = delete;
+        EpollSerialTransport &operator=(const EpollSerialTransport &) = delete;
+
+        ~EpollSerialTransport() {
+            if (m_epoll >= 0) close(m_epoll);
+        }
+
+        bool init() {
+            if (m_epoll < 0) m_epoll = epoll_create1(EPOLL_CLOEXEC);
+            m_read_buffer.resize(m_options.read_buffer_size);
+            return m_epoll >= 0;
+        }
+
+        // Starts reading fd, which is switched to non-blocking. Returns the sensor
+        // index used by write() and poll(), or -1 on failure.
+        long add(int fd) {
+            int flags = fcntl(fd, F_GETFL);
+            if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) return -1;
+
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.u64 = m_ports.size();
+            if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) != 0) return -1;
+
+            m_ports.push_back({fd, {}, 0});
+            return m_ports.size() - 1;
+        }
+
+        // Stops reading fd of sensor and drops its queued writes. The index is not reused.
+        void remove(size_t sensor) {
+            Port &port = m_ports[sensor];
+            if (port.fd < 0) return;
+            epoll_ctl(m_epoll, EPOLL_CTL_DEL, port.fd, nullptr);
+            port.fd = -1;
+            port.pending.clear();
+        }
+
+        size_t sensors() const {
+            return m_ports.size();
+        }
+
+        // the errno that stopped reading sensor, 0 while it is read
+        int error(size_t sensor) const {
+            return m_ports[sensor].error;
+        }
+
+        // queued until the next flush() or poll()
+        void write(size_t sensor, const uint8_t *data, size_t size) {
+            auto &pending = m_ports[sensor].pending;
+            pending.insert(pending.end(), data, data + size);
+        }
+
+        TransportWriter<EpollSerialTransport> writer(size_t sensor) {
+            return {*this, sensor};
+        }
+
+        // Writes what the ports accept without blocking, the rest stays queued.
+        void flush() {
+            for(auto &port : m_ports) {
+                if (port.fd < 0 || port.pending.empty()) continue;
+
+                ssize_t n = ::write(port.fd, port.pending.data(), port.pending.size());
+                if (n > 0) port.pending.erase(port.pending.begin(), port.pending.begin() + n);
+            }
+        }
+
+        // Flushes, waits up to timeout_ms (-1 forever) for input and calls
+        // on_data(sensor, data, size) with everything read. Returns the number
+        // of calls or -1 on error, also if reading a port failed.
+        template <typename F>
+        int poll(int timeout_ms, F &&on_data) {
+            flush();
+
+            epoll_event events[16];
+            int ready = epoll_wait(m_epoll, events, 16, timeout_ms);
+            if (ready < 0) return errno == EINTR ? 0 : -1;
+
+            int calls = 0;
+            int failed = 0;
+            for(int i = 0; i < ready; ++i) {
+                size_t sensor = events[i].data.u64;
+                bool first = true;
+                // removed by on_data for an earlier event
+                while(m_ports[sensor].fd >= 0) {
+                    ssize_t n = ::read(m_ports[sensor].fd, m_read_buffer.data(), m_read_buffer.size());
+                    int error = 0;
+                    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) error = errno;
+                    // nothing to read from a port reported readable is its end
+                    if (n == 0 && first) error = serial_end_of_file;
+                    if (error != 0) {
+                        failed = error;
+                        remove(sensor);
+                        m_ports[sensor].error = error;
+                    }
+                    if (n <= 0) break;
+                    on_data(sensor, (const uint8_t *)m_read_buffer.data(), (size_t)n);
+                    ++calls;
+                    first = false;
+                }
+            }
+            if (failed != 0) {
+                errno = failed;
+                return -1;
+            }
+            return calls;
+        }
+
+        bool uses_io_uring() const {
+            return false;
+        }
+    };
+
+#ifdef LD2410_HAS_IO_URING
+    class UringSerialTransport {
+        struct Port {
+            int fd;
+            std::vector<uint8_t> pending;
+            // owned by the kernel until the write completes
+            std::vector<uint8_t> in_flight;
+            // errno of the read that stopped reading the port
+            int error;
+        };
+
+        static const uint16_t buffer_group = 0;
+        // user data of cancel requests, their completions are ignored
+        static const uint64_t cancel_data = ~(uint64_t)0;
+
+        SerialTransportOptions m_options;
+        io_uring m_ring;
+        bool m_initialized = false;
+        io_uring_buf_ring *m_buffer_ring = nullptr;
+        std::vector<uint8_t> m_buffers;
+        std::vector<Port> m_ports;
+
+        // user data of a completion, the sensor and whether it was a write
+        static uint64_t user_data(size_t sensor, bool write) {
+            return (uint64_t)sensor << 1 | (write ? 1 : 0);
+        }
+
+        io_uring_sqe *next_sqe() {
+            io_uring_sqe *sqe = io_uring_get_sqe(&m_ring);
+            if (sqe == nullptr) {
+                io_uring_submit(&m_ring);
+                sqe = io_uring_get_sqe(&m_ring);
+            }
+            return sqe;
+        }
+
+        bool arm_read(size_t sensor) {
+            io_uring_sqe *sqe = next_sqe();
+            if (sqe == nullptr) return false;
+
+            io_uring_prep_read_multishot(sqe, m_ports[sensor].fd, 0, 0, buffer_group);
+            io_uring_sqe_set_data64(sqe, user_data(sensor, false));
+            return true;
+        }
+
+        void recycle_buffer(unsigned id) {
+            io_uring_buf_ring_add(m_buffer_ring, m_buffers.data() + (size_t)id * m_options.read_buffer_size,
+                m_options.read_buffer_size, id, io_uring_buf_ring_mask(m_options.read_buffers), 0);
+            io_uring_buf_ring_advance(m_buffer_ring, 1);
+        }
+
+        // the number of on_data calls, -errno if the read of the port failed
+        template <typename F>
+        int complete(io_uring_cqe *cqe, F &on_data) {
+            uint64_t data = io_uring_cqe_get_data64(cqe);
+            if (data == cancel_data) return 0;
+            size_t sensor = data >> 1;
+            Port &port = m_ports[sensor];
+
+            if (data & 1) {
+                // put back what the port did not take
+                size_t written = cqe->res > 0 ? cqe->res : 0;
+                port.pending.insert(port.pending.begin(), port.in_flight.begin() + written, port.in_flight.end());
+                port.in_flight.clear();
+                return 0;
+            }
+
+            int calls = 0;
+            if (cqe->flags & IORING_CQE_F_BUFFER) {
+                unsigned id = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+                if (cqe->res > 0 && port.fd >= 0) {
+                    on_data(sensor, (const uint8_t *)m_buffers.data() + (size_t)id * m_options.read_buffer_size, (size_t)cqe->res);
+                    calls = 1;
+                }
+                recycle_buffer(id);
+            }
+
+            if (!(cqe->flags & IORING_CQE_F_MORE) && port.fd >= 0) {
+                // out of buffers only pauses reading, errors and end of file stop it
+                if (cqe->res > 0 || cqe->res == -ENOBUFS) {
+                    arm_read(sensor);
+                } else {
+                    port.fd = -1;
+                    port.pending.clear();
+                    port.error = cqe->res == 0 ? serial_end_of_file : -cqe->res;
+                    return -port.error;
+                }
+            }
+            return calls;
+        }
+
+    public:
+        explicit UringSerialTransport(const SerialTransportOptions &options = {}): m_options(options) {
+
+        }
+
+        UringSerialTransport(const UringSerialTransport &) = delete;
+        UringSerialTransport &operator=(const UringSerialTransport &) = delete;
+
+        ~UringSerialTransport() {
+            if (!m_initialized) return;
+            if (m_buffer_ring != nullptr) io_uring_free_buf_ring(&m_ring, m_buffer_ring, m_options.read_buffers, buffer_group);
+            io_uring_queue_exit(&m_ring);
+        }
+
+        // false if the kernel has no io_uring, no multishot reads or refuses the buffer ring
+        bool init() {
+            if (m_initialized) return true;
+            if (io_uring_queue_init(m_options.queue_depth, &m_ring, 0) != 0) return false;
+            m_initialized = true;
+
+            // every read would complete with -EINVAL otherwise
+            io_uring_probe *probe = io_uring_get_probe_ring(&m_ring);
+            bool multishot = probe != nullptr && io_uring_opcode_supported(probe, IORING_OP_READ_MULTISHOT);
+            if (probe != nullptr) io_uring_free_probe(probe);
+            if (!multishot) {
+                io_uring_queue_exit(&m_ring);
+                m_initialized = false;
+                return false;
+            }
+
+            int ret = 0;
+            m_buffer_ring = io_uring_setup_buf_ring(&m_ring, m_options.read_buffers, buffer_group, 0, &ret);
+            if (m_buffer_ring == nullptr) {
+                io_uring_queue_exit(&m_ring);
+                m_initialized = false;
+                return false;
+            }
+
+            m_buffers.resize((size_t)m_options.read_buffers * m_options.read_buffer_size);
+            for(unsigned id = 0; id < m_options.read_buffers; ++id) {
+                io_uring_buf_ring_add(m_buffer_ring, m_buffers.data() + (size_t)id * m_options.read_buffer_size,
+                    m_options.read_buffer_size, id, io_uring_buf_ring_mask(m_options.read_buffers), id);
+            }
+            io_uring_buf_ring_advance(m_buffer_ring, m_options.read_buffers);
+            return true;
+        }
+
+        // Starts reading fd. Returns the sensor index used by write() and poll(), or -1 on failure.
+        long add(int fd) {
+            m_ports.push_back({fd, {}, {}, 0});
+            if (!arm_read(m_ports.size() - 1)) {
+                m_ports.pop_back();
+                return -1;
+            }
+            io_uring_submit(&m_ring);
+            return m_ports.size() - 1;
+        }
+
+        // Cancels the read of sensor and drops its queued writes. The index is not reused.
+        void remove(size_t sensor) {
+            Port &port = m_ports[sensor];
+            if (port.fd < 0) return;
+            port.fd = -1;
+            port.pending.clear();
+
+            io_uring_sqe *sqe = next_sqe();
+            if (sqe == nullptr) return;
+            io_uring_prep_cancel64(sqe, user_data(sensor, false), 0);
+            io_uring_sqe_set_data64(sqe, cancel_data);
+            io_uring_submit(&m_ring);
+        }
+
+        size_t sensors() const {
+            return m_ports.size();
+        }
+
+        // the errno that stopped reading sensor, 0 while it is read
+        int error(size_t sensor) const {
+            return m_ports[sensor].error;
+        }
+
+        // queued until the next flush() or poll()
+        void write(size_t sensor, const uint8_t *data, size_t size) {
+            auto &pending = m_ports[sensor].pending;
+            pending.insert(pending.end(), data, data + size);
+        }
+
+        TransportWriter<UringSerialTransport> writer(size_t sensor) {
+            return {*this, sensor};
+        }
+
+        // Submits the queued writes of all ports with a single syscall.
+        void flush() {
+            for(size_t sensor = 0; sensor < m_ports.size(); ++sensor) {
+                Port &port = m_ports[sensor];
+                if (port.fd < 0 || port.pending.empty() || !port.in_flight.empty()) continue;
+
+                io_uring_sqe *sqe = next_sqe();
+                if (sqe == nullptr) break;
+                port.in_flight.swap(port.pending);
+                io_uring_prep_write(sqe, port.fd, port.in_flight.data(), port.in_flight.size(), (uint64_t)-1);
+                io_uring_sqe_set_data64(sqe, user_data(sensor, true));
+            }
+            io_uring_submit(&m_ring);
+        }
+
+        // Flushes, waits up to timeout_ms (-1 forever) for completions and calls
+        // on_data(sensor, data, size) for every filled buffer. Returns the number
+        // of calls or -1 on error, also if reading a port failed.
+        template <typename F>
+        int poll(int timeout_ms, F &&on_data) {
+            flush();
+
+            io_uring_cqe *cqe = nullptr;
+            int ret;
+            if (timeout_ms < 0) {
+                ret = io_uring_wait_cqe(&m_ring, &cqe);
+            } else {
+                __kernel_timespec timeout{};
+                timeout.tv_sec = timeout_ms / 1000;
+                timeout.tv_nsec = (long long)(timeout_ms % 1000) * 1000000;
+                ret = io_uring_wait_cqe_timeout(&m_ring, &cqe, &timeout);
+            }
+            if (ret == -ETIME || ret == -EINTR) return 0;
+            if (ret < 0) return -1;
+
+            int calls = 0;
+            int failed = 0;
+            unsigned head;
+            unsigned seen = 0;
+            io_uring_for_each_cqe(&m_ring, head, cqe) {
+                int n = complete(cqe, on_data);
+                if (n < 0) {
+                    failed = -n;
+                } else {
+                    calls += n;
+                }
+                ++seen;
+            }
+            io_uring_cq_advance(&m_ring, seen);
+            // reads re-armed while completing
+            io_uring_submit(&m_ring);
+            if (failed != 0) {
+                errno = failed;
+                return -1;
+            }
+            return calls;
+        }
+
+        bool uses_io_uring() const {
+            return true;
+        }
+    };
+
+    // io_uring if the kernel supports it, epoll otherwise.
+    class SerialTransport {
+        UringSerialTransport m_uring;
+        EpollSerialTransport m_epoll;
+        bool m_use_uring = false;
+
+    public:
+        explicit SerialTransport(const SerialTransportOptions &options = {}): m_uring(options), m_epoll(options) {
+
+        }
+
+        bool init() {
+            m_use_uring = m_uring.init();
+            return m_use_uring || m_epoll.init();
+        }
+
+        long add(int fd) {
+            return m_use_uring ? m_uring.add(fd) : m_epoll.add(fd);
+        }
+
+        void remove(size_t sensor) {
+            if (m_use_uring) {
+                m_uring.remove(sensor);
+            } else {
+                m_epoll.remove(sensor);
+            }
+        }
+
+        size_t sensors() const {
+            return m_use_uring ? m_uring.sensors() : m_epoll.sensors();
+        }
+
+        int error(size_t sensor) const {
+            return m_use_uring ? m_uring.error(sensor) : m_epoll.error(sensor);
+        }
+
+        void write(size_t sensor, const uint8_t *data, size_t size) {
+            if (m_use_uring) {
+                m_uring.write(sensor, data, size);
+            } else {
+                m_epoll.write(sensor, data, size);
+            }
+        }
+
+        TransportWriter<SerialTransport> writer(size_t sensor) {
+            return {*this, sensor};
+        }
+
+        void flush() {
+            if (m_use_uring) {
+                m_uring.flush();
+            } else {
+                m_epoll.flush();
+            }
+        }
+
+        template <typename F>
+        int poll(int timeout_ms, F &&on_data) {
+            return m_use_uring ? m_uring.poll(timeout_ms, on_data) : m_epoll.poll(timeout_ms, on_data);
+        }
+
+        bool uses_io_uring() const {
+            return m_use_uring;
+        }
+    };
+#else
+    using SerialTransport = EpollSerialTransport;
+#endif
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+#include <variant>
+
+#include "ld2410_packets.h"
+#include "ld2410_text_writer.h"
+
+// Encodes packets as JSON or MessagePack into a caller supplied buffer. The
+// fields are taken from visit_fields() of the packet, names as declared:
+//
+//   char json[256];
+//   size_t size = write_json(frame, json, sizeof(json));
+//   // {"target_state":2,"movement_target_distance":81,...}
+//
+// Gate values become arrays. Nothing is allocated and no printf is involved.
+
+namespace ld2410 {
+    namespace internal_helpers {
+        template <typename T>
+        uint32_t serialized_uint(T v) {
+            if constexpr (std::is_enum<T>::value) {
+                return (uint32_t)static_cast<std::underlying_type_t<T>>(v);
+            } else {
+                static_assert(std::is_unsigned<T>::value && sizeof(T) <= sizeof(uint32_t), "fields are unsigned integers of up to 32 bits");
+                return v;
+            }
+        }
+
+        // number of fields visit_fields() reports
+        template <typename TPacket>
+        size_t field_count(const TPacket &packet) {
+            size_t n = 0;
+            packet.visit_fields([&](const char *, const auto &) { ++n; });
+            return n;
+        }
+    }
+
+    class JsonWriter: public TextWriter {
+    public:
+        using TextWriter::TextWriter;
+
+        template <typename T>
+        void value(T v) {
+            write_uint(internal_helpers::serialized_uint(v));
+        }
+
+        template <typename T, std::size_t capacity>
+        void value(const InlineVector<T, capacity> &values) {
+            write('[');
+            for(size_t i = 0; i < values.size(); ++i) {
+                if (i != 0) write(',');
+                value(values[i]);
+            }
+            write(']');
+        }
+
+        // field names are identifiers and need no escaping
+        template <typename TPacket>
+        void object(const TPacket &packet) {
+            bool first = true;
+            write('{');
+            packet.visit_fields([&](const char *name, const auto &v) {
+                if (!first) write(',');
+                first = false;
+                write('"');
+                write(name);
+                write("\":");
+                value(v);
+            });
+            write('}');
+        }
+    };
+
+    // Encodes integers in the shortest form, packets as maps from field name to value.
+    class MessagePackWriter {
+        uint8_t *m_buffer;
+        size_t m_capacity;
+        size_t m_size;
+        bool m_overflow;
+
+        void write_big_endian(uint32_t v, size_t bytes) {
+            while(bytes > 0) {
+                --bytes;
+                write((uint8_t)(v >> (8 * bytes)));
+            }
+        }
+
+    public:
+        MessagePackWriter(uint8_t *buffer, size_t capacity): m_buffer(buffer), m_capacity(capacity), m_size(0), m_overflow(false) {
+
+        }
+
+        void write(uint8_t b) {
+            if (m_size >= m_capacity) {
+                m_overflow = true;
+                return;
+            }
+            m_buffer[m_size++] = b;
+        }
+
+        void write_uint(uint32_t v) {
+            if (v < 0x80) {
+                write((uint8_t)v);
+            } else if (v <= 0xff) {
+                write(0xcc);
+                write_big_endian(v, 1);
+            } else if (v <= 0xffff) {
+                write(0xcd);
+                write_big_endian(v, 2);
+            } else {
+                write(0xce);
+                write_big_endian(v, 4);
+            }
+        }
+
+        void write_str(const char *s) {
+            size_t length = strlen(s);
+            if (length < 32) {
+                write(0xa0 | length);
+            } else if (length <= 0xff) {
+                write(0xd9);
+                write_big_endian(length, 1);
+            } else {
+                write(0xda);
+                write_big_endian(length, 2);
+            }
+            for(size_t i = 0; i < length; ++i) {
+                write((uint8_t)s[i]);
+            }
+        }
+
+        void write_array_header(size_t n) {
+            if (n < 16) {
+                write(0x90 | n);
+            } else {
+                write(0xdc);
+                write_big_endian(n, 2);
+            }
+        }
+
+        void write_map_header(size_t n) {
+            if (n < 16) {
+                write(0x80 | n);
+            } else {
+                write(0xde);
+                write_big_endian(n, 2);
+            }
+        }
+
+        template <typename T>
+        void value(T v) {
+            write_uint(internal_helpers::serialized_uint(v));
+        }
+
+        template <typename T, std::size_t capacity>
+        void value(const InlineVector<T, capacity> &values) {
+            write_array_header(values.size());
+            for(size_t i = 0; i < values.size(); ++i) {
+                value(values[i]);
+            }
+        }
+
+        template <typename TPacket>
+        void object(const TPacket &packet) {
+            write_map_header(internal_helpers::field_count(packet));
+            packet.visit_fields([&](const char *name, const auto &v) {
+                write_str(name);
+                value(v);
+            });
+        }
+
+        // length of the encoding or 0 if it did not fit
+        size_t finish() const {
+            return m_overflow ? 0 : m_size;
+        }
+
+        size_t size() const {
+            return m_size;
+        }
+
+        bool overflow() const {
+            return m_overflow;
+        }
+    };
+
+    // Writes packet as a JSON object into buffer and terminates it with a zero.
+    // Returns the length of the text or 0 if it did not fit.
+    template <typename TPacket>
+    size_t write_json(const TPacket &packet, char *buffer, size_t capacity) {
+        JsonWriter w{buffer, capacity};
+        w.object(packet);
+        return w.finish();
+    }
+
+    template <typename ...T>
+    size_t write_json(const std::variant<T...> &packet, char *buffer, size_t capacity) {
+        return std::visit([&](const auto &p) { return write_json(p, buffer, capacity); }, packet);
+    }
+
+    // Writes packet as a MessagePack map into buffer.
+    // Returns the length of the encoding or 0 if it did not fit.
+    template <typename TPacket>
+    size_t write_msgpack(const TPacket &packet, uint8_t *buffer, size_t capacity) {
+        MessagePackWriter w{buffer, capacity};
+        w.object(packet);
+        return w.finish();
+    }
+
+    template <typename ...T>
+    size_t write_msgpack(const std::variant<T...> &packet, uint8_t *buffer, size_t capacity) {
+        return std::visit([&](const auto &p) { return write_msgpack(p, buffer, capacity); }, packet);
+    }
+}
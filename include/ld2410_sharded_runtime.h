@@ -0,0 +1,525 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+
+#include "ld2410_packet_write_and_read_ack.h"
+#include "ld2410_serial_transport.h"
+
+// Serial ports of many sensors spread over worker threads. Every shard owns
+// a SerialTransport, the ports added to it and one FrameAssembler per port,
+// nothing of that is shared with other shards. Frames are passed to a copy
+// of the handler owned by the shard, on the shard thread:
+//
+//   ShardedRuntime<Handler, ReportingDataFrame, EngineeringModeDataFrame> runtime{handler};
+//   runtime.start();
+//   long sensor = runtime.add(fd);
+//   ...
+//   runtime.rebalance();   // now and then, moves sensors by measured frame rate
+//
+// Commands sent with command() are written and their acks matched by the
+// shard owning the sensor, T has to include the ack types for that.
+//
+// add(), remove(), write(), command() and rebalance() are to be called from one thread.
+// Linux only, not part of ld2410.h.
+
+namespace ld2410 {
+    struct ShardedRuntimeOptions {
+        // worker threads, 0 selects std::thread::hardware_concurrency()
+        size_t shards = 0;
+        // pin shard i to the i-th core the process may run on, modulo their number
+        bool pin_threads = true;
+        SerialTransportOptions transport;
+    };
+
+    struct ShardMove {
+        size_t sensor;
+        size_t from;
+        size_t to;
+    };
+
+    namespace internal_helpers {
+        const size_t no_shard = ~(size_t)0;
+
+        // Moves sensors from the busiest to the idlest shard as long as that lowers
+        // the load of the busiest one. rates[i] is the load of sensor i, shard_of[i]
+        // its shard or no_shard.
+        inline std::vector<ShardMove> plan_rebalance(const std::vector<uint32_t> &rates, std::vector<size_t> shard_of, size_t shards, size_t max_moves) {
+            std::vector<ShardMove> moves;
+            std::vector<uint64_t> loads(shards, 0);
+            for(size_t i = 0; i < rates.size(); ++i) {
+                if (shard_of[i] != no_shard) loads[shard_of[i]] += rates[i];
+            }
+
+            while(moves.size() < max_moves) {
+                size_t busiest = 0, idlest = 0;
+                for(size_t s = 1; s < shards; ++s) {
+                    if (loads[s] > loads[busiest]) busiest = s;
+                    if (loads[s] < loads[idlest]) idlest = s;
+                }
+
+                // the sensor leaving both shards closest to each other
+                size_t best = no_shard;
+                uint64_t best_peak = loads[busiest];
+                for(size_t i = 0; i < rates.size(); ++i) {
+                    if (shard_of[i] != busiest || rates[i] == 0) continue;
+                    uint64_t peak = std::max(loads[busiest] - rates[i], loads[idlest] + rates[i]);
+                    if (peak < best_peak) {
+                        best = i;
+                        best_peak = peak;
+                    }
+                }
+                if (best == no_shard) break;
+
+                moves.push_back({best, busiest, idlest});
+                shard_of[best] = idlest;
+                loads[busiest] -= rates[best];
+                loads[idlest] += rates[best];
+            }
+            return moves;
+        }
+    }
+
+    template <typename THandler, typename ...T>
+    class ShardedRuntime {
+        struct Sensor {
+            int fd;
+            size_t shard;
+            // counted by the owning shard
+            std::atomic<uint32_t> frames{0};
+            uint32_t frames_at_rebalance = 0;
+        };
+
+        // Called with the frames of a sensor while its command waits for the
+        // ack, returns true once the ack was taken. nullptr if none came in time.
+        using ack_matcher_t = std::function<bool(const std::variant<T...> *)>;
+
+        struct Message {
+            enum { add, remove, write, command } kind;
+            size_t sensor;
+            // set for add, the shard never touches the sensor list itself
+            Sensor *state;
+            std::vector<uint8_t> data;
+            // told whether the shard did what was asked
+            std::shared_ptr<std::promise<bool>> done;
+            // set for command
+            ack_matcher_t match_ack = nullptr;
+            decltype(LD2410_MILLIS) timeout = 0;
+        };
+
+        struct Command {
+            std::vector<uint8_t> data;
+            ack_matcher_t match_ack;
+            decltype(LD2410_MILLIS) timeout;
+        };
+
+        class Shard {
+            struct Port {
+                size_t sensor;
+                Sensor *state;
+                FrameAssembler<T...> assembler;
+                // the first one is written and waits for its ack
+                std::deque<Command> commands;
+                decltype(LD2410_MILLIS) ack_deadline = 0;
+            };
+
+            THandler m_handler;
+            SerialTransport m_transport;
+            int m_wake = -1;
+            std::thread m_thread;
+            std::atomic<bool> m_running{false};
+
+            // filled by the controlling thread, emptied by the shard
+            std::mutex m_inbox_mutex;
+            std::vector<Message> m_inbox;
+            std::atomic<bool> m_mail{false};
+
+            // transport index to port, nullptr for the wake up event and removed ports
+            std::vector<std::unique_ptr<Port>> m_ports;
+            std::unordered_map<size_t, size_t> m_index_of;
+            // ports with commands, their ack deadlines are checked while there are any
+            size_t m_commanding = 0;
+
+            void start_command(size_t index) {
+                Port &port = *m_ports[index];
+                Command &command = port.commands.front();
+                m_transport.write(index, command.data.data(), command.data.size());
+                port.ack_deadline = LD2410_MILLIS + command.timeout;
+            }
+
+            // the first command of port is done, the next one is written
+            void next_command(size_t index) {
+                Port &port = *m_ports[index];
+                port.commands.pop_front();
+                if (port.commands.empty()) {
+                    --m_commanding;
+                } else {
+                    start_command(index);
+                }
+            }
+
+            void expire_commands() {
+                if (m_commanding == 0) return;
+                decltype(LD2410_MILLIS) now = LD2410_MILLIS;
+                for(size_t index = 0; index < m_ports.size(); ++index) {
+                    Port *port = m_ports[index].get();
+                    if (port == nullptr || port->commands.empty() || now < port->ack_deadline) continue;
+
+                    ack_matcher_t match_ack = std::move(port->commands.front().match_ack);
+                    next_command(index);
+                    match_ack(nullptr);
+                }
+            }
+
+            // milliseconds until the next ack deadline, at most a second, -1 without commands
+            int poll_timeout() const {
+                if (m_commanding == 0) return -1;
+                decltype(LD2410_MILLIS) now = LD2410_MILLIS;
+                decltype(LD2410_MILLIS) wait = 1000;
+                for(const auto &port : m_ports) {
+                    if (port == nullptr || port->commands.empty()) continue;
+                    decltype(LD2410_MILLIS) left = port->ack_deadline > now ? port->ack_deadline - now : 0;
+                    if (left < wait) wait = left;
+                }
+                return (int)wait;
+            }
+
+            bool handle(Message &message) {
+                switch(message.kind) {
+                    case Message::add: {
+                        long index = m_transport.add(message.state->fd);
+                        if (index < 0) return false;
+                        if (m_ports.size() <= (size_t)index) m_ports.resize(index + 1);
+                        m_ports[index].reset(new Port{message.sensor, message.state, {}, {}, 0});
+                        m_index_of[message.sensor] = index;
+                        return true;
+                    }
+                    case Message::remove: {
+                        auto it = m_index_of.find(message.sensor);
+                        if (it == m_index_of.end()) return false;
+                        // commands of the port fail, including those of a sensor moved by rebalance()
+                        std::deque<Command> commands;
+                        commands.swap(m_ports[it->second]->commands);
+                        if (!commands.empty()) --m_commanding;
+                        m_transport.remove(it->second);
+                        m_ports[it->second].reset();
+                        m_index_of.erase(it);
+                        for(auto &command : commands) {
+                            command.match_ack(nullptr);
+                        }
+                        return true;
+                    }
+                    case Message::write: {
+                        auto it = m_index_of.find(message.sensor);
+                        if (it == m_index_of.end()) return false;
+                        m_transport.write(it->second, message.data.data(), message.data.size());
+                        return true;
+                    }
+                    case Message::command: {
+                        auto it = m_index_of.find(message.sensor);
+                        if (it == m_index_of.end()) {
+                            message.match_ack(nullptr);
+                            return false;
+                        }
+                        Port &port = *m_ports[it->second];
+                        port.commands.push_back({std::move(message.data), std::move(message.match_ack), message.timeout});
+                        if (port.commands.size() == 1) {
+                            ++m_commanding;
+                            start_command(it->second);
+                        }
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            void read_inbox() {
+                if (!m_mail.exchange(false, std::memory_order_acquire)) return;
+
+                std::vector<Message> inbox;
+                {
+                    std::lock_guard<std::mutex> lock(m_inbox_mutex);
+                    inbox.swap(m_inbox);
+                }
+                for(auto &message : inbox) {
+                    bool handled = handle(message);
+                    if (message.done) message.done->set_value(handled);
+                }
+            }
+
+            void run() {
+                while(m_running.load(std::memory_order_relaxed)) {
+                    read_inbox();
+                    expire_commands();
+                    m_transport.poll(poll_timeout(), [&](size_t index, const uint8_t *data, size_t size) {
+                        Port *port = index < m_ports.size() ? m_ports[index].get() : nullptr;
+                        if (port == nullptr) return;
+
+                        port->assembler.push(data, size, [&](const auto &frame) {
+                            port->state->frames.fetch_add(1, std::memory_order_relaxed);
+                            if (!port->commands.empty()) {
+                                std::variant<T...> received{frame};
+                                if (port->commands.front().match_ack(&received)) {
+                                    next_command(index);
+                                    return;
+                                }
+                            }
+                            m_handler(port->sensor, frame);
+                        });
+                    });
+                }
+            }
+
+            static bool pin_to(long core) {
+                cpu_set_t cpus;
+                CPU_ZERO(&cpus);
+                CPU_SET(core, &cpus);
+                return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+            }
+
+            void wake() {
+                uint64_t one = 1;
+                if (::write(m_wake, &one, sizeof(one)) < 0) return;
+            }
+
+        public:
+            Shard(const THandler &handler, const SerialTransportOptions &options): m_handler(handler), m_transport(options) {
+
+            }
+
+            ~Shard() {
+                stop();
+                if (m_wake >= 0) close(m_wake);
+            }
+
+            // runs the shard on core, any core if negative. False if it could not be pinned.
+            bool start(long core) {
+                m_wake = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+                if (m_wake < 0 || !m_transport.init() || m_transport.add(m_wake) != 0) return false;
+                m_ports.resize(1);
+
+                // pinned by the thread itself before it reads any port
+                std::promise<bool> pinned;
+                std::future<bool> started = pinned.get_future();
+                m_running = true;
+                m_thread = std::thread([this, core, &pinned]() {
+                    pinned.set_value(core < 0 || pin_to(core));
+                    run();
+                });
+                if (!started.get()) {
+                    stop();
+                    return false;
+                }
+                return true;
+            }
+
+            void stop() {
+                if (!m_thread.joinable()) return;
+                m_running = false;
+                wake();
+                m_thread.join();
+            }
+
+            void post(Message message) {
+                {
+                    std::lock_guard<std::mutex> lock(m_inbox_mutex);
+                    m_inbox.push_back(std::move(message));
+                }
+                m_mail.store(true, std::memory_order_release);
+                wake();
+            }
+
+            // queues bytes for sensor, joined with a write queued just before
+            void post_write(size_t sensor, const uint8_t *data, size_t size) {
+                {
+                    std::lock_guard<std::mutex> lock(m_inbox_mutex);
+                    if (m_inbox.empty() || m_inbox.back().kind != Message::write || m_inbox.back().sensor != sensor) {
+                        m_inbox.push_back({Message::write, sensor, nullptr, {}, nullptr});
+                    }
+                    auto &pending = m_inbox.back().data;
+                    pending.insert(pending.end(), data, data + size);
+                }
+                m_mail.store(true, std::memory_order_release);
+                wake();
+            }
+
+            // posts message and waits until the shard handled it, false if it could not
+            bool send(Message message) {
+                auto done = std::make_shared<std::promise<bool>>();
+                std::future<bool> handled = done->get_future();
+                message.done = done;
+                post(std::move(message));
+                return handled.get();
+            }
+        };
+
+        THandler m_handler;
+        ShardedRuntimeOptions m_options;
+        std::vector<std::unique_ptr<Shard>> m_shards;
+        std::vector<std::unique_ptr<Sensor>> m_sensors;
+
+    public:
+        explicit ShardedRuntime(const THandler &handler, const ShardedRuntimeOptions &options = {}): m_handler(handler), m_options(options) {
+
+        }
+
+        ~ShardedRuntime() {
+            stop();
+        }
+
+        // Starts the shard threads. False if a transport could not be set up or
+        // a thread could not be pinned.
+        bool start() {
+            size_t count = m_options.shards != 0 ? m_options.shards : std::max(std::thread::hardware_concurrency(), 1u);
+
+            std::vector<long> cores;
+            cpu_set_t allowed;
+            if (m_options.pin_threads) {
+                if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return false;
+                for(long core = 0; core < CPU_SETSIZE; ++core) {
+                    if (CPU_ISSET(core, &allowed)) cores.push_back(core);
+                }
+            }
+
+            for(size_t i = 0; i < count; ++i) {
+                m_shards.emplace_back(new Shard(m_handler, m_options.transport));
+                if (!m_shards.back()->start(cores.empty() ? -1 : cores[i % cores.size()])) {
+                    stop();
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Joins the shard threads. Ports stay open, they belong to the caller,
+        // every sensor is removed.
+        void stop() {
+            for(auto &shard : m_shards) {
+                shard->stop();
+            }
+            m_shards.clear();
+            for(auto &s : m_sensors) {
+                s->shard = internal_helpers::no_shard;
+            }
+        }
+
+        size_t shards() const {
+            return m_shards.size();
+        }
+
+        // Hands fd to the shard with the fewest sensors. Returns the sensor index,
+        // or -1 if the runtime is not running or the shard could not read fd.
+        long add(int fd) {
+            if (m_shards.empty()) return -1;
+
+            std::vector<size_t> counts(m_shards.size(), 0);
+            for(auto &s : m_sensors) {
+                if (s->shard != internal_helpers::no_shard) ++counts[s->shard];
+            }
+            size_t shard = std::min_element(counts.begin(), counts.end()) - counts.begin();
+
+            m_sensors.emplace_back(new Sensor{fd, shard});
+            size_t index = m_sensors.size() - 1;
+            if (!m_shards[shard]->send({Message::add, index, m_sensors.back().get(), {}, nullptr})) {
+                m_sensors.back()->shard = internal_helpers::no_shard;
+                return -1;
+            }
+            return (long)index;
+        }
+
+        // Returns once the shard stopped using the port, the caller may close it then.
+        void remove(size_t sensor) {
+            Sensor &s = *m_sensors[sensor];
+            if (s.shard == internal_helpers::no_shard) return;
+            m_shards[s.shard]->send({Message::remove, sensor, nullptr, {}, nullptr});
+            s.shard = internal_helpers::no_shard;
+        }
+
+        // queued for the shard owning sensor
+        void write(size_t sensor, const uint8_t *data, size_t size) {
+            Sensor &s = *m_sensors[sensor];
+            if (s.shard == internal_helpers::no_shard) return;
+            m_shards[s.shard]->post_write(sensor, data, size);
+        }
+
+        TransportWriter<ShardedRuntime> writer(size_t sensor) {
+            return {*this, sensor};
+        }
+
+        // Has the shard owning sensor write packet and call on_ack(sensor, ack)
+        // on its thread with the ack, or with std::nullopt if none came within
+        // timeout or the sensor was removed or moved meanwhile. Commands of a
+        // sensor are written one after the other, each once the previous one
+        // was answered. False if sensor has no shard, on_ack is not called then.
+        template <typename TPacket, typename F>
+        bool command(size_t sensor, const TPacket &packet, F on_ack, decltype(LD2410_MILLIS) timeout = default_ack_timeout) {
+            using ack_t = typename TPacket::ack_t;
+            static_assert(std::disjunction<std::is_same<ack_t, T>...>::value, "the runtime has to decode the ack of the command");
+
+            Sensor &s = *m_sensors[sensor];
+            if (s.shard == internal_helpers::no_shard) return false;
+
+            std::vector<uint8_t> data;
+            auto append = [&](const uint8_t *bytes, size_t size) { data.insert(data.end(), bytes, bytes + size); };
+            write_to_writer(append, packet);
+
+            ack_matcher_t match_ack = [on_ack, sensor](const std::variant<T...> *frame) mutable {
+                if (frame == nullptr) {
+                    on_ack(sensor, std::optional<ack_t>{});
+                    return true;
+                }
+                const ack_t *ack = std::get_if<ack_t>(frame);
+                if (ack == nullptr) return false;
+                on_ack(sensor, std::optional<ack_t>{*ack});
+                return true;
+            };
+            Message message{Message::command, sensor, nullptr, std::move(data), nullptr, std::move(match_ack), timeout};
+            m_shards[s.shard]->post(std::move(message));
+            return true;
+        }
+
+        size_t shard_of(size_t sensor) const {
+            return m_sensors[sensor]->shard;
+        }
+
+        // frames decoded for sensor so far
+        uint32_t frames(size_t sensor) const {
+            return m_sensors[sensor]->frames.load(std::memory_order_relaxed);
+        }
+
+        // Moves up to max_moves sensors so the frames decoded since the last call
+        // spread evenly over the shards. A frame split by a move is lost.
+        std::vector<ShardMove> rebalance(size_t max_moves = 1) {
+            if (m_shards.empty()) return {};
+
+            std::vector<uint32_t> rates(m_sensors.size());
+            std::vector<size_t> shard_of(m_sensors.size());
+            for(size_t i = 0; i < m_sensors.size(); ++i) {
+                uint32_t frames = m_sensors[i]->frames.load(std::memory_order_relaxed);
+                rates[i] = frames - m_sensors[i]->frames_at_rebalance;
+                m_sensors[i]->frames_at_rebalance = frames;
+                shard_of[i] = m_sensors[i]->shard;
+            }
+
+            std::vector<ShardMove> moves = internal_helpers::plan_rebalance(rates, shard_of, m_shards.size(), max_moves);
+            for(const auto &move : moves) {
+                m_shards[move.from]->send({Message::remove, move.sensor, nullptr, {}, nullptr});
+                bool added = m_shards[move.to]->send({Message::add, move.sensor, m_sensors[move.sensor].get(), {}, nullptr});
+                m_sensors[move.sensor]->shard = added ? move.to : internal_helpers::no_shard;
+            }
+            return moves;
+        }
+    };
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <variant>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ld2410_broadcast_ring.h"
+#include "ld2410_packet_reader.h"
+
+// Latest data frame of every sensor in a POSIX shared memory object, for
+// processes that read what another process decodes. POSIX hosts only.
+//
+// The process owning the serial ports creates the region and publishes into
+// it, e.g. through a SharedFramePublisher passed as decoder observer. Other
+// processes open the same name read only and load frames straight from the
+// mapping, no syscall is involved after open(). Every slot is a SeqlockSlot,
+// so the publisher never waits for readers.
+//
+//   SharedMemory<SharedFrameRegion<4>> shm;
+//   shm.create("/ld2410");                     // publishing process
+//   shm.open("/ld2410");                       // reading processes
+//   shared_data_frame_t frame;
+//   if (shm->load(0, frame) != 0) ...
+//
+// publish_in_place() and read() work on the frame where it lies in the
+// mapping instead of copying it in or out.
+
+namespace ld2410 {
+    using shared_data_frame_t = std::variant<ReportingDataFrame, EngineeringModeDataFrame>;
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "seqlock sequences are shared between processes and must be lock free");
+    static_assert(std::is_trivially_copyable<shared_data_frame_t>::value, "data frames are copied bytewise into shared memory");
+
+    namespace internal_helpers {
+        struct NoFrameHistory {
+
+        };
+
+        template <std::size_t capacity>
+        using frame_history_t = std::conditional_t<capacity == 0, NoFrameHistory, BroadcastRing<shared_data_frame_t, capacity == 0 ? 1 : capacity>>;
+    }
+
+    // Layout of the shared memory object. history_capacity frames per sensor are
+    // kept in addition to the latest one, 0 keeps none.
+    template <std::size_t sensor_count, std::size_t history_capacity = 0>
+    class SharedFrameRegion {
+        static_assert(sensor_count != 0, "a region holds at least one sensor");
+
+        struct Sensor {
+            SeqlockSlot<shared_data_frame_t> latest;
+            internal_helpers::frame_history_t<history_capacity> history;
+        };
+
+        uint32_t m_magic;
+        uint32_t m_size;
+        uint32_t m_sensor_count;
+        uint32_t m_history_capacity;
+        Sensor m_sensors[sensor_count];
+
+    public:
+        static constexpr uint32_t magic = 0x4C443241;
+
+        using history_consumer_t = typename BroadcastRing<shared_data_frame_t, history_capacity == 0 ? 1 : history_capacity>::Consumer;
+
+        SharedFrameRegion(): m_magic(magic), m_size(sizeof(SharedFrameRegion)), m_sensor_count(sensor_count), m_history_capacity(history_capacity), m_sensors() {
+
+        }
+
+        // the region was set up by a process built with the same layout
+        bool compatible() const {
+            return m_magic == magic && m_size == sizeof(SharedFrameRegion)
+                && m_sensor_count == sensor_count && m_history_capacity == history_capacity;
+        }
+
+        static constexpr std::size_t sensors() {
+            return sensor_count;
+        }
+
+        // Only one process, and one thread in it, may publish.
+        void publish(std::size_t sensor, const shared_data_frame_t &frame) {
+            Sensor &s = m_sensors[sensor];
+            // an odd sequence was left by a publisher that died while storing
+            s.latest.store(frame, (s.latest.sequence() | 1) + 1);
+            if constexpr (history_capacity != 0) s.history.publish(frame);
+        }
+
+        // Like publish() but f(shared_data_frame_t &) fills the latest frame of
+        // sensor where it lies in the region. The history gets a copy.
+        template <typename F>
+        void publish_in_place(std::size_t sensor, F f) {
+            Sensor &s = m_sensors[sensor];
+            s.latest.write(f, (s.latest.sequence() | 1) + 1);
+            if constexpr (history_capacity != 0) {
+                s.latest.read([&](const shared_data_frame_t &frame) { s.history.publish(frame); });
+            }
+        }
+
+        // Copies the latest frame of sensor into frame. Returns its sequence,
+        // 0 if nothing was published yet and an odd number if the publisher was
+        // storing, in which case frame is to be ignored and loaded again.
+        uint32_t load(std::size_t sensor, shared_data_frame_t &frame) const {
+            return m_sensors[sensor].latest.load(frame);
+        }
+
+        // Calls f(const shared_data_frame_t &) on the latest frame of sensor
+        // without copying it out of the region. Returns like load(), what f took
+        // from the frame only counts for an even, non zero sequence.
+        template <typename F>
+        uint32_t read(std::size_t sensor, F f) const {
+            return m_sensors[sensor].latest.read(f);
+        }
+
+        // even number that grows with every frame published for sensor
+        uint32_t sequence(std::size_t sensor) const {
+            return m_sensors[sensor].latest.sequence();
+        }
+
+        // reads the history of sensor from now on, see BroadcastRing::Consumer
+        history_consumer_t history(std::size_t sensor) const {
+            static_assert(history_capacity != 0, "the region keeps no history");
+            return m_sensors[sensor].history.consumer();
+        }
+    };
+
+    // Maps a TRegion from a named POSIX shared memory object.
+    template <typename TRegion>
+    class SharedMemory {
+        static_assert(std::is_trivially_destructible<TRegion>::value, "the region outlives the processes mapping it");
+
+        TRegion *m_region = nullptr;
+
+        bool map(int fd, int protection) {
+            void *address = mmap(nullptr, sizeof(TRegion), protection, MAP_SHARED, fd, 0);
+            close(fd);
+            if (address == MAP_FAILED) return false;
+            m_region = static_cast<TRegion *>(address);
+            return true;
+        }
+
+    public:
+        SharedMemory() = default;
+        SharedMemory(const SharedMemory &) = delete;
+        SharedMemory &operator=(const SharedMemory &) = delete;
+
+        SharedMemory(SharedMemory &&other): m_region(other.m_region) {
+            other.m_region = nullptr;
+        }
+
+        ~SharedMemory() {
+            unmap();
+        }
+
+        // Creates or replaces the object name, e.g. "/ld2410", with an empty region.
+        bool create(const char *name, mode_t mode = 0644) {
+            unmap();
+            int fd = shm_open(name, O_CREAT | O_RDWR, mode);
+            if (fd < 0) return false;
+            if (ftruncate(fd, sizeof(TRegion)) != 0) {
+                close(fd);
+                return false;
+            }
+            if (!map(fd, PROT_READ | PROT_WRITE)) return false;
+
+            new (m_region) TRegion();
+            return true;
+        }
+
+        // Maps an existing object read only. Fails if it was created with another layout.
+        bool open(const char *name) {
+            unmap();
+            int fd = shm_open(name, O_RDONLY, 0);
+            if (fd < 0) return false;
+
+            struct stat st;
+            if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(TRegion)) {
+                close(fd);
+                return false;
+            }
+            if (!map(fd, PROT_READ)) return false;
+
+            if (!m_region->compatible()) {
+                unmap();
+                return false;
+            }
+            return true;
+        }
+
+        void unmap() {
+            if (m_region != nullptr) munmap(m_region, sizeof(TRegion));
+            m_region = nullptr;
+        }
+
+        // removes the name, existing mappings stay valid
+        static bool unlink(const char *name) {
+            return shm_unlink(name) == 0;
+        }
+
+        bool mapped() const {
+            return m_region != nullptr;
+        }
+
+        TRegion *operator->() {
+            return m_region;
+        }
+
+        const TRegion *operator->() const {
+            return m_region;
+        }
+
+        TRegion &operator*() {
+            return *m_region;
+        }
+    };
+
+    // Decoder observer publishing the data frames of one sensor into a region.
+    template <typename TRegion>
+    class SharedFramePublisher: public NullDecoderObserver {
+        TRegion &m_region;
+        std::size_t m_sensor;
+
+    public:
+        SharedFramePublisher(TRegion &region, std::size_t sensor): m_region(region), m_sensor(sensor) {
+
+        }
+
+        template <typename T>
+        void frame_decoded(const T &frame) {
+            if constexpr (std::is_same<T, ReportingDataFrame>::value || std::is_same<T, EngineeringModeDataFrame>::value) {
+                m_region.publish(m_sensor, frame);
+            }
+        }
+    };
+}
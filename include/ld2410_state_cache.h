@@ -0,0 +1,127 @@
+#pragma once
+
+#include <optional>
+
+#include "ld2410_config_sync.h"
+
+// Last known parameters, firmware version and engineering mode of a sensor.
+// Populated once, then kept up to date from the acks of the commands sent
+// through command() or apply(), so reading it needs no serial traffic.
+// FactoryReset and RestartModule acks invalidate everything.
+
+namespace ld2410 {
+    class SensorStateCache {
+        std::optional<SensorConfig> m_parameters;
+        std::optional<ReadFirmwareVersionCommandAck> m_firmware;
+        std::optional<bool> m_engineering_mode;
+
+        void set_parameter(uint16_t word, uint32_t value) {
+            switch(word) {
+                case 0x0000: m_parameters->maximum_moving_distance_gate = value; break;
+                case 0x0001: m_parameters->maximum_static_distance_gate = value; break;
+                case 0x0002: m_parameters->no_one_duration = value; break;
+            }
+        }
+
+    public:
+        const std::optional<SensorConfig> &parameters() const {
+            return m_parameters;
+        }
+
+        const std::optional<ReadFirmwareVersionCommandAck> &firmware() const {
+            return m_firmware;
+        }
+
+        const std::optional<bool> &engineering_mode() const {
+            return m_engineering_mode;
+        }
+
+        bool populated() const {
+            return m_parameters.has_value() && m_firmware.has_value();
+        }
+
+        void invalidate() {
+            m_parameters.reset();
+            m_firmware.reset();
+            m_engineering_mode.reset();
+        }
+
+        // the sensor was just configured to config, e.g. by a successful sync_config()
+        void store(const SensorConfig &config) {
+            m_parameters = config;
+        }
+
+        // commands without an effect on the cached state
+        template <typename T>
+        void apply(const T &, const typename T::ack_t &) {
+
+        }
+
+        void apply(const ReadParameterCommand &, const ReadParameterCommandAck &ack) {
+            if (ack.status() == 0) m_parameters = sensor_config_from(ack);
+        }
+
+        void apply(const ReadFirmwareVersionCommand &, const ReadFirmwareVersionCommandAck &ack) {
+            m_firmware = ack;
+        }
+
+        void apply(const MaximumDistanceGateandUnmannedDurationParameterConfigurationCommand &command, const MaximumDistanceGateandUnmannedDurationParameterConfigurationCommandAck &ack) {
+            if (ack.status() != 0 || !m_parameters.has_value()) return;
+
+            set_parameter(command.maximum_moving_distance_word(), command.maximum_moving_distance_parameter());
+            set_parameter(command.maximum_static_distance_door_word(), command.maximum_static_distance_door_parameter());
+            set_parameter(command.no_person_duration(), command.section_unattended_duration());
+        }
+
+        void apply(const RangeSensitivityConfigurationCommand &command, const RangeSensitivityConfigurationCommandAck &ack) {
+            if (ack.status() != 0 || !m_parameters.has_value()) return;
+
+            uint32_t gate = command.distance_gate_value();
+            for(size_t i = 0; i < config_gate_count; ++i) {
+                if (gate != 0xffff && gate != i) continue;
+                m_parameters->motion_sensitivity[i] = command.motion_sensitivity_value();
+                m_parameters->static_sensitivity[i] = command.static_sensitivity_value();
+            }
+        }
+
+        void apply(const EnableEngineeringModeCommand &, const EnableEngineeringModeCommandAck &ack) {
+            if (ack.status() == 0) m_engineering_mode = true;
+        }
+
+        void apply(const CloseEngineeringModeCommand &, const CloseEngineeringModeCommandAck &ack) {
+            if (ack.status() == 0) m_engineering_mode = false;
+        }
+
+        void apply(const FactoryReset &, const FactoryResetAck &ack) {
+            if (ack.status() == 0) invalidate();
+        }
+
+        void apply(const RestartModule &, const RestartModuleAck &ack) {
+            if (ack.status() == 0) invalidate();
+        }
+
+        // write_and_read_ack() that keeps the cache up to date
+        template <typename T, typename TWriter, typename TReader>
+        std::optional<typename T::ack_t> command(TWriter &writer, TReader &&reader, const T &packet, decltype(LD2410_MILLIS) timeout = default_ack_timeout) {
+            auto ack = write_and_read_ack(writer, reader, packet, timeout);
+            if (ack.has_value()) apply(packet, *ack);
+            return ack;
+        }
+
+        // Reads what is missing in one configuration session. Does nothing if the cache is populated.
+        template <typename TWriter, typename TReader>
+        bool populate(TWriter &writer, TReader &&reader, decltype(LD2410_MILLIS) timeout = default_ack_timeout) {
+            if (populated()) return true;
+
+            EnableConfigurationCommand enable_config;
+            enable_config.value(1);
+            auto enabled = command(writer, reader, enable_config, timeout);
+            if (!enabled.has_value() || enabled->status() != 0) return false;
+
+            if (!m_parameters.has_value()) command(writer, reader, ReadParameterCommand{}, timeout);
+            if (!m_firmware.has_value()) command(writer, reader, ReadFirmwareVersionCommand{}, timeout);
+            command(writer, reader, EndConfigurationCommand{}, timeout);
+            return populated();
+        }
+    };
+}
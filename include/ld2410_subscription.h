@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+
+#include "ld2410_packet_views.h"
+
+// Change-only and rate-limited delivery of data frames. Frames are read with
+// read_raw_frame() and compared on their payload bytes against the last
+// delivered frame, only frames passed on are decoded.
+
+namespace ld2410 {
+    struct DeliveryPolicy {
+        // deliver a data frame only if a field changed by more than its tolerance
+        bool on_change = false;
+        uint16_t distance_tolerance = 0;
+        uint8_t energy_tolerance = 0;
+        uint8_t gate_energy_tolerance = 0;
+        // minimum time between two delivered data frames, 0 delivers every frame
+        uint32_t min_interval = 0;
+        // deliver an unchanged frame after this long anyway, 0 never does
+        uint32_t max_interval = 0;
+
+        // limits delivery to at most hz frames per second of LD2410_MILLIS
+        void at_most_hz(uint32_t hz) {
+            min_interval = hz == 0 ? 0 : (1000 + hz - 1) / hz;
+        }
+    };
+
+    namespace internal_helpers {
+        inline bool exceeds(uint32_t a, uint32_t b, uint32_t tolerance) {
+            return (a > b ? a - b : b - a) > tolerance;
+        }
+
+        template <typename TLayout>
+        bool data_fields_changed(const DataFrameView<TLayout> &last, const DataFrameView<TLayout> &current, const DeliveryPolicy &policy) {
+            return last.target_state() != current.target_state()
+                || exceeds(last.movement_target_distance(), current.movement_target_distance(), policy.distance_tolerance)
+                || exceeds(last.stationary_target_distance(), current.stationary_target_distance(), policy.distance_tolerance)
+                || exceeds(last.detection_distance(), current.detection_distance(), policy.distance_tolerance)
+                || exceeds(last.exercise_target_energy_value(), current.exercise_target_energy_value(), policy.energy_tolerance)
+                || exceeds(last.stationary_target_energy_value(), current.stationary_target_energy_value(), policy.energy_tolerance);
+        }
+    }
+
+    // True if current differs from last by more than the tolerances of policy.
+    // Bytes that carry no measurement, like the tail and check of a ReportingDataFrame, are ignored.
+    inline bool data_frame_changed(const RawFrame &last, const RawFrame &current, const DeliveryPolicy &policy) {
+        using namespace internal_helpers;
+        if (last.type != current.type || last.size != current.size) return true;
+
+        if (!current.is<EngineeringModeDataFrame>()) {
+            ReportingDataFrameView a{last}, b{current};
+            // too short to compare field by field
+            if (!b.valid()) return true;
+            return data_fields_changed(a, b, policy);
+        }
+
+        EngineeringModeDataFrameView a{last}, b{current};
+        if (!b.valid()) return true;
+        if (data_fields_changed(a, b, policy)) return true;
+
+        if (a.maximum_moving_distance_gate_n() != b.maximum_moving_distance_gate_n()
+            || a.maximum_static_distance_gate_n() != b.maximum_static_distance_gate_n()) {
+            return true;
+        }
+
+        for(size_t gate = 0; gate < b.movement_gate_count(); ++gate) {
+            if (exceeds(a.movement_distance_gate_energy_value(gate), b.movement_distance_gate_energy_value(gate), policy.gate_energy_tolerance)) return true;
+        }
+        for(size_t gate = 0; gate < b.static_gate_count(); ++gate) {
+            if (exceeds(a.static_distance_gate_energy_value(gate), b.static_distance_gate_energy_value(gate), policy.gate_energy_tolerance)) return true;
+        }
+        return false;
+    }
+
+    // Decides per frame whether a consumer gets it. Frames other than data frames always pass.
+    class FrameSubscription {
+        DeliveryPolicy m_policy;
+        RawFrame m_last;
+        bool m_delivered;
+        uint32_t m_last_delivery;
+        uint32_t m_suppressed;
+
+    public:
+        explicit FrameSubscription(const DeliveryPolicy &policy = {}): m_policy(policy), m_last(), m_delivered(false), m_last_delivery(0), m_suppressed(0) {
+
+        }
+
+        // returns true if frame, received at now, is to be delivered
+        bool offer(const RawFrame &frame, uint32_t now) {
+            if (!frame.data_frame()) return true;
+
+            if (m_delivered) {
+                uint32_t elapsed = now - m_last_delivery;
+                bool too_early = elapsed < m_policy.min_interval;
+                bool heartbeat = m_policy.max_interval != 0 && elapsed >= m_policy.max_interval;
+                if (too_early || (m_policy.on_change && !heartbeat && !data_frame_changed(m_last, frame, m_policy))) {
+                    ++m_suppressed;
+                    return false;
+                }
+            }
+
+            m_last = frame;
+            m_delivered = true;
+            m_last_delivery = now;
+            return true;
+        }
+
+        // data frames not delivered so far
+        uint32_t suppressed() const {
+            return m_suppressed;
+        }
+
+        const DeliveryPolicy &policy() const {
+            return m_policy;
+        }
+    };
+
+    // Like read_from_reader_many(), but frames the subscription drops are never decoded.
+    template <typename ...T, typename TReader, typename TObserver>
+    std::optional<std::variant<T...>> read_subscribed(TReader &&reader, FrameSubscription &subscription, uint32_t now, TObserver &observer) {
+        std::optional<RawFrame> frame = read_raw_frame<T...>(reader, observer);
+        if (!frame.has_value() || !subscription.offer(*frame, now)) return std::nullopt;
+        return decode_raw_frame<T...>(*frame);
+    }
+
+    template <typename ...T, typename TReader>
+    std::optional<std::variant<T...>> read_subscribed(TReader &&reader, FrameSubscription &subscription, uint32_t now) {
+        NullDecoderObserver observer;
+        return read_subscribed<T...>(reader, subscription, now, observer);
+    }
+}
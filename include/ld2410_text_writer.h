@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Text into a caller supplied buffer, for the text encoders. The text is
+// kept terminated with a zero after every character, what does not fit is
+// dropped and remembered as overflow.
+
+namespace ld2410 {
+    class TextWriter {
+        char *m_buffer;
+        size_t m_capacity;
+        size_t m_size;
+        bool m_overflow;
+
+    public:
+        TextWriter(char *buffer, size_t capacity): m_buffer(buffer), m_capacity(capacity), m_size(0), m_overflow(false) {
+            if (m_capacity != 0) m_buffer[0] = 0;
+        }
+
+        void write(char c) {
+            // keep room for the terminating zero
+            if (m_size + 1 >= m_capacity) {
+                m_overflow = true;
+                return;
+            }
+            m_buffer[m_size++] = c;
+            m_buffer[m_size] = 0;
+        }
+
+        void write(const char *s) {
+            while(*s) write(*s++);
+        }
+
+        void write_uint(uint64_t v) {
+            char digits[20];
+            size_t n = 0;
+            do {
+                digits[n++] = '0' + v % 10;
+                v /= 10;
+            } while(v != 0);
+
+            while(n > 0) write(digits[--n]);
+        }
+
+        // length of the text or 0 if it did not fit
+        size_t finish() const {
+            return m_overflow ? 0 : m_size;
+        }
+
+        size_t size() const {
+            return m_size;
+        }
+
+        bool overflow() const {
+            return m_overflow;
+        }
+    };
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "ld2410_packet_reader.h"
+#include "ld2410_packet_writer.h"
+
+// Supervises a sensor and brings it back if it stops sending data frames.
+// Pass the watchdog as observer to the decoding loop, or call feed() for every
+// data frame, and call poll(now) regularly. Recovery steps only write commands
+// and switch the local UART, nothing waits for an answer: a step succeeded if
+// data frames show up again before its timeout.
+//
+//   healthy -> ending_config -> restarting -> rescanning (every rate) -> backing_off -> ending_config ...
+
+namespace ld2410 {
+    enum class WatchdogState {
+        healthy,
+        // EndConfigurationCommand, for a module left in configuration mode
+        ending_config,
+        // EnableConfigurationCommand and RestartModule
+        restarting,
+        // one local baud rate after the other
+        rescanning,
+        backing_off,
+    };
+
+    struct WatchdogOptions {
+        // time without data frames until recovery starts
+        uint32_t frame_deadline = 1000;
+        uint32_t step_timeout = 500;
+        // the module needs a while to boot after RestartModule
+        uint32_t restart_timeout = 1500;
+        uint32_t backoff_initial = 1000;
+        uint32_t backoff_max = 60000;
+    };
+
+    // factory default first, then the rates a module is most likely set to
+    constexpr std::array<BaudRate, 8> watchdog_rescan_order{
+        BaudRate::BaudRate_256000,
+        BaudRate::BaudRate_115200,
+        BaudRate::BaudRate_460800,
+        BaudRate::BaudRate_57600,
+        BaudRate::BaudRate_230400,
+        BaudRate::BaudRate_38400,
+        BaudRate::BaudRate_19200,
+        BaudRate::BaudRate_9600,
+    };
+
+    // set_local_baud(uint32_t bps) must switch the local UART to the given speed.
+    template <typename TWriter, typename TSetLocalBaud>
+    class SensorWatchdog: public NullDecoderObserver {
+        TWriter &m_writer;
+        TSetLocalBaud m_set_local_baud;
+        WatchdogOptions m_options;
+        WatchdogState m_state;
+        BaudRate m_baud_rate;
+        // rate frames last arrived at, restored when a rescan fails
+        BaudRate m_known_baud_rate;
+        bool m_frame_seen;
+        uint32_t m_last_frame;
+        uint32_t m_step_started;
+        uint32_t m_backoff;
+        size_t m_rescan_index;
+        uint32_t m_recoveries;
+
+        void set_baud_rate(BaudRate rate) {
+            m_baud_rate = rate;
+            m_set_local_baud(baud_rate_to_bps(rate));
+        }
+
+        void enter(WatchdogState state, uint32_t now) {
+            m_state = state;
+            m_step_started = now;
+
+            switch(state) {
+                case WatchdogState::healthy:
+                    break;
+                case WatchdogState::ending_config:
+                    write_to_writer(m_writer, EndConfigurationCommand{});
+                    break;
+                case WatchdogState::restarting: {
+                    EnableConfigurationCommand enable_config;
+                    enable_config.value(1);
+                    write_to_writer(m_writer, enable_config);
+                    write_to_writer(m_writer, RestartModule{});
+                    break;
+                }
+                case WatchdogState::rescanning:
+                    set_baud_rate(watchdog_rescan_order[m_rescan_index]);
+                    // the module may also hang in configuration mode at the other rate
+                    write_to_writer(m_writer, EndConfigurationCommand{});
+                    break;
+                case WatchdogState::backing_off:
+                    if (m_baud_rate != m_known_baud_rate) set_baud_rate(m_known_baud_rate);
+                    break;
+            }
+        }
+
+    public:
+        SensorWatchdog(TWriter &writer, TSetLocalBaud set_local_baud, BaudRate baud_rate, uint32_t now, const WatchdogOptions &options = {}):
+            m_writer(writer), m_set_local_baud(set_local_baud), m_options(options), m_state(WatchdogState::healthy),
+            m_baud_rate(baud_rate), m_known_baud_rate(baud_rate), m_frame_seen(false), m_last_frame(now), m_step_started(now),
+            m_backoff(options.backoff_initial), m_rescan_index(0), m_recoveries(0) {
+
+        }
+
+        // a data frame arrived
+        void feed() {
+            m_frame_seen = true;
+        }
+
+        template <typename T>
+        void frame_decoded(const T &) {
+            if (T::definition_header.val.val == ReportingDataHeader) feed();
+        }
+
+        void frame_received(const RawFrame &frame) {
+            if (frame.data_frame()) feed();
+        }
+
+        // Advances the state machine, never blocks.
+        WatchdogState poll(uint32_t now) {
+            if (m_frame_seen) {
+                m_frame_seen = false;
+                m_last_frame = now;
+                m_known_baud_rate = m_baud_rate;
+                if (m_state != WatchdogState::healthy) {
+                    ++m_recoveries;
+                    m_backoff = m_options.backoff_initial;
+                    enter(WatchdogState::healthy, now);
+                }
+                return m_state;
+            }
+
+            uint32_t elapsed = now - m_step_started;
+            switch(m_state) {
+                case WatchdogState::healthy:
+                    if (now - m_last_frame >= m_options.frame_deadline) enter(WatchdogState::ending_config, now);
+                    break;
+                case WatchdogState::ending_config:
+                    if (elapsed >= m_options.step_timeout) enter(WatchdogState::restarting, now);
+                    break;
+                case WatchdogState::restarting:
+                    if (elapsed >= m_options.restart_timeout) {
+                        m_rescan_index = 0;
+                        enter(WatchdogState::rescanning, now);
+                    }
+                    break;
+                case WatchdogState::rescanning:
+                    if (elapsed >= m_options.step_timeout) {
+                        if (++m_rescan_index < watchdog_rescan_order.size()) {
+                            enter(WatchdogState::rescanning, now);
+                        } else {
+                            enter(WatchdogState::backing_off, now);
+                        }
+                    }
+                    break;
+                case WatchdogState::backing_off:
+                    if (elapsed >= m_backoff) {
+                        m_backoff = m_backoff > m_options.backoff_max / 2 ? m_options.backoff_max : m_backoff * 2;
+                        enter(WatchdogState::ending_config, now);
+                    }
+                    break;
+            }
+
+            return m_state;
+        }
+
+        WatchdogState state() const {
+            return m_state;
+        }
+
+        // local rate in use, updated by a rescan
+        BaudRate baud_rate() const {
+            return m_baud_rate;
+        }
+
+        // number of times frames came back after recovery started
+        uint32_t recoveries() const {
+            return m_recoveries;
+        }
+
+        // wait before the next recovery round
+        uint32_t backoff() const {
+            return m_backoff;
+        }
+
+        uint32_t last_frame_time() const {
+            return m_last_frame;
+        }
+    };
+}
@@ -0,0 +1,375 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "ld2410_packets.h"
+
+// Summaries of the data frames of one sensor over tumbling or sliding windows,
+// to be sent upstream instead of every frame:
+//
+//   SlidingWindow<6> window{10000};   // last minute, every 10 seconds
+//   window.add(millis(), frame, [](const WindowSummary &summary) { ... });
+//
+// A frame is added to the open pane in O(1), a window is the merge of its
+// panes and only built when it closes. All memory is allocated inline, with
+// 9 gates a WindowSummary is about 1.1 KB and a SlidingWindow<panes> that
+// times panes. Keep windows of more than one pane out of the 4 KB loop stack
+// of an ESP8266, make them global or static.
+// Times are milliseconds of a uint32_t clock and may wrap.
+
+namespace ld2410 {
+    // Histogram of energy values 0 to 100 in buckets of bucket_width values.
+    // Percentiles are off by at most bucket_width / 2, sketches merge exactly.
+    // Buckets count to 65535, when one is full all of them are halved, which
+    // keeps the percentiles and drops a single value at most per bucket.
+    // 60 bytes with the default bucket_width.
+    template <std::size_t bucket_width = 4>
+    class EnergySketch {
+        static_assert(bucket_width != 0, "buckets hold at least one value");
+
+    public:
+        static constexpr uint8_t energy_max = 100;
+        static constexpr std::size_t bucket_count = energy_max / bucket_width + 1;
+
+    private:
+        static constexpr uint16_t bucket_max = 0xffff;
+
+        std::array<uint16_t, bucket_count> m_buckets{};
+        uint32_t m_count = 0;
+        uint8_t m_min = energy_max;
+        uint8_t m_max = 0;
+
+        void halve() {
+            m_count = 0;
+            for(auto &bucket : m_buckets) {
+                bucket /= 2;
+                m_count += bucket;
+            }
+        }
+
+    public:
+        // values above energy_max count as energy_max
+        void add(uint8_t energy) {
+            energy = std::min(energy, energy_max);
+            if (m_buckets[energy / bucket_width] == bucket_max) halve();
+            ++m_buckets[energy / bucket_width];
+            ++m_count;
+            m_min = std::min(m_min, energy);
+            m_max = std::max(m_max, energy);
+        }
+
+        // halves both sides as often as a bucket of the sum needs it
+        void merge(const EnergySketch &other) {
+            unsigned shift = 0;
+            for(std::size_t b = 0; b < bucket_count; ++b) {
+                while(((uint32_t)m_buckets[b] >> shift) + (other.m_buckets[b] >> shift) > bucket_max) ++shift;
+            }
+
+            m_count = 0;
+            for(std::size_t b = 0; b < bucket_count; ++b) {
+                m_buckets[b] = (uint16_t)((m_buckets[b] >> shift) + (other.m_buckets[b] >> shift));
+                m_count += m_buckets[b];
+            }
+            m_min = std::min(m_min, other.m_min);
+            m_max = std::max(m_max, other.m_max);
+        }
+
+        void reset() {
+            *this = EnergySketch{};
+        }
+
+        // values in the buckets, fewer than were added once they were halved
+        uint32_t count() const {
+            return m_count;
+        }
+
+        // p percent of the values are at or below the result, 0 without values
+        uint8_t percentile(uint8_t p) const {
+            if (m_count == 0) return 0;
+            if (p == 0) return m_min;
+
+            uint64_t rank = ((uint64_t)std::min<uint8_t>(p, 100) * m_count + 99) / 100;
+
+            uint64_t seen = 0;
+            for(std::size_t b = 0; b < bucket_count; ++b) {
+                seen += m_buckets[b];
+                if (seen < rank) continue;
+
+                // middle of the bucket, never outside the values seen
+                uint8_t middle = (uint8_t)std::min<std::size_t>(b * bucket_width + bucket_width / 2, energy_max);
+                return std::max(m_min, std::min(m_max, middle));
+            }
+            return m_max;
+        }
+
+        // smallest and largest value added, 0 without values
+        uint8_t lowest() const {
+            return m_count != 0 ? m_min : 0;
+        }
+
+        uint8_t highest() const {
+            return m_max;
+        }
+    };
+
+    // Counts of the frames and an EnergySketch per gate and direction,
+    // 36 + 2 * (max_gate_n + 1) * sizeof(sketch_t) bytes.
+    template <std::size_t max_gate_n = LD2410_MAX_GATE_N, std::size_t bucket_width = 4>
+    class BasicWindowSummary {
+    public:
+        using sketch_t = EnergySketch<bucket_width>;
+
+    private:
+        uint32_t m_start = 0;
+        uint32_t m_end = 0;
+        uint32_t m_frames = 0;
+        uint32_t m_occupied = 0;
+        uint32_t m_moving = 0;
+        uint32_t m_stationary = 0;
+        // detection distance of the frames with a target
+        uint32_t m_distance_sum = 0;
+        uint16_t m_min_distance = 0xffff;
+        uint16_t m_max_distance = 0;
+        uint32_t m_engineering_frames = 0;
+        std::array<sketch_t, max_gate_n + 1> m_movement_energy{};
+        std::array<sketch_t, max_gate_n + 1> m_static_energy{};
+
+        template <typename TFrame>
+        void add_target(const TFrame &frame) {
+            ++m_frames;
+            uint8_t state = frame.target_state();
+            if (state == 0) return;
+
+            ++m_occupied;
+            if (state & 1) ++m_moving;
+            if (state & 2) ++m_stationary;
+            m_distance_sum += frame.detection_distance();
+            m_min_distance = std::min(m_min_distance, frame.detection_distance());
+            m_max_distance = std::max(m_max_distance, frame.detection_distance());
+        }
+
+        template <typename TValues>
+        static void add_gates(std::array<sketch_t, max_gate_n + 1> &sketches, const TValues &values) {
+            for(std::size_t gate = 0; gate < values.size() && gate < sketches.size(); ++gate) {
+                sketches[gate].add(values[gate]);
+            }
+        }
+
+    public:
+        void add(const ReportingDataFrame &frame) {
+            add_target(frame);
+        }
+
+        template <std::size_t frame_max_gate_n>
+        void add(const BasicEngineeringModeDataFrame<frame_max_gate_n> &frame) {
+            add_target(frame);
+            ++m_engineering_frames;
+            add_gates(m_movement_energy, frame.movement_distance_gate_energy_value());
+            add_gates(m_static_energy, frame.static_distance_gate_energy_value());
+        }
+
+        // adds the frames of other, the time span is left as it is
+        void merge(const BasicWindowSummary &other) {
+            m_frames += other.m_frames;
+            m_occupied += other.m_occupied;
+            m_moving += other.m_moving;
+            m_stationary += other.m_stationary;
+            m_distance_sum += other.m_distance_sum;
+            m_min_distance = std::min(m_min_distance, other.m_min_distance);
+            m_max_distance = std::max(m_max_distance, other.m_max_distance);
+            m_engineering_frames += other.m_engineering_frames;
+            for(std::size_t gate = 0; gate <= max_gate_n; ++gate) {
+                m_movement_energy[gate].merge(other.m_movement_energy[gate]);
+                m_static_energy[gate].merge(other.m_static_energy[gate]);
+            }
+        }
+
+        // in place, a temporary would need the size of a summary on the stack
+        void reset() {
+            m_start = 0;
+            m_end = 0;
+            m_frames = 0;
+            m_occupied = 0;
+            m_moving = 0;
+            m_stationary = 0;
+            m_distance_sum = 0;
+            m_min_distance = 0xffff;
+            m_max_distance = 0;
+            m_engineering_frames = 0;
+            for(std::size_t gate = 0; gate <= max_gate_n; ++gate) {
+                m_movement_energy[gate].reset();
+                m_static_energy[gate].reset();
+            }
+        }
+
+        uint32_t start() const {
+            return m_start;
+        }
+
+        void start(uint32_t v) {
+            m_start = v;
+        }
+
+        uint32_t end() const {
+            return m_end;
+        }
+
+        void end(uint32_t v) {
+            m_end = v;
+        }
+
+        uint32_t frames() const {
+            return m_frames;
+        }
+
+        // frames with a moving or stationary target
+        uint32_t occupied_frames() const {
+            return m_occupied;
+        }
+
+        uint32_t moving_frames() const {
+            return m_moving;
+        }
+
+        uint32_t stationary_frames() const {
+            return m_stationary;
+        }
+
+        // share of the frames with a target, frames arrive at a fixed rate so this is the share of time
+        uint16_t occupied_permille() const {
+            return m_frames != 0 ? (uint16_t)((uint64_t)m_occupied * 1000 / m_frames) : 0;
+        }
+
+        // detection distance over the frames with a target, 0 without any
+        uint16_t min_distance() const {
+            return m_occupied != 0 ? m_min_distance : 0;
+        }
+
+        uint16_t mean_distance() const {
+            return m_occupied != 0 ? (uint16_t)(m_distance_sum / m_occupied) : 0;
+        }
+
+        uint16_t max_distance() const {
+            return m_max_distance;
+        }
+
+        // frames the gate energies were taken from
+        uint32_t engineering_frames() const {
+            return m_engineering_frames;
+        }
+
+        const sketch_t &movement_energy(std::size_t gate) const {
+            return m_movement_energy[gate];
+        }
+
+        const sketch_t &static_energy(std::size_t gate) const {
+            return m_static_energy[gate];
+        }
+    };
+
+    using WindowSummary = BasicWindowSummary<>;
+
+    // Windows of panes * slide milliseconds, one closes every slide milliseconds.
+    // The first closes once panes panes are complete, counted from the first
+    // call. Windows without frames are not reported.
+    // Holds panes summaries and nothing else, a closing window is merged into
+    // the oldest pane which is reused for the next one.
+    template <std::size_t panes, std::size_t max_gate_n = LD2410_MAX_GATE_N, std::size_t bucket_width = 4>
+    class SlidingWindow {
+        static_assert(panes != 0, "a window has at least one pane");
+
+    public:
+        using summary_t = BasicWindowSummary<max_gate_n, bucket_width>;
+
+    private:
+        uint32_t m_slide;
+        bool m_started = false;
+        uint32_t m_pane_end = 0;
+        // the open pane and the panes - 1 before it, oldest first from m_current + 1
+        std::array<summary_t, panes> m_panes{};
+        std::size_t m_current = 0;
+        std::size_t m_closed = 0;
+
+        bool idle() const {
+            for(const auto &pane : m_panes) {
+                if (pane.frames() != 0) return false;
+            }
+            return true;
+        }
+
+        void open_pane(uint32_t start) {
+            m_current = (m_current + 1) % panes;
+            m_panes[m_current].reset();
+            m_panes[m_current].start(start);
+            m_pane_end = start + m_slide;
+        }
+
+        template <typename F>
+        void close_pane(F &on_window) {
+            uint32_t end = m_pane_end;
+            m_panes[m_current].end(end);
+            if (m_closed < panes) ++m_closed;
+
+            if (m_closed == panes && !idle()) {
+                // the oldest pane is reset by open_pane() next
+                summary_t &window = m_panes[(m_current + 1) % panes];
+                for(std::size_t p = 2; p <= panes; ++p) {
+                    window.merge(m_panes[(m_current + p) % panes]);
+                }
+                window.start(end - (uint32_t)(panes * m_slide));
+                window.end(end);
+                on_window(window);
+            }
+            open_pane(end);
+        }
+
+    public:
+        explicit SlidingWindow(uint32_t slide): m_slide(slide) {
+
+        }
+
+        uint32_t slide() const {
+            return m_slide;
+        }
+
+        uint32_t length() const {
+            return (uint32_t)(panes * m_slide);
+        }
+
+        // Closes the panes ended at now and calls on_window(const summary_t &)
+        // for every window closed with them.
+        template <typename F>
+        void advance(uint32_t now, F on_window) {
+            if (!m_started) {
+                m_started = true;
+                m_panes[m_current].start(now);
+                m_pane_end = now + m_slide;
+                return;
+            }
+
+            while((int32_t)(now - m_pane_end) >= 0) {
+                close_pane(on_window);
+                if (!idle() || (int32_t)(now - m_pane_end) < 0) continue;
+
+                // nothing to report until the next frame, skip the empty panes
+                uint32_t skipped = (now - m_pane_end) / m_slide + 1;
+                m_closed = std::min<std::size_t>(panes, m_closed + skipped);
+                uint32_t start = m_pane_end + (skipped - 1) * m_slide;
+                m_panes[m_current].start(start);
+                m_pane_end = start + m_slide;
+            }
+        }
+
+        template <typename TFrame, typename F>
+        void add(uint32_t now, const TFrame &frame, F on_window) {
+            advance(now, on_window);
+            m_panes[m_current].add(frame);
+        }
+    };
+
+    template <std::size_t max_gate_n = LD2410_MAX_GATE_N, std::size_t bucket_width = 4>
+    using BasicTumblingWindow = SlidingWindow<1, max_gate_n, bucket_width>;
+    using TumblingWindow = BasicTumblingWindow<>;
+}
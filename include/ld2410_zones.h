@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "ld2410_config_sync.h"
+
+// Occupancy of user defined zones, each a range of distance gates. The zones
+// are compiled into one bitmask per gate holding the zones that gate belongs
+// to, a frame then costs an OR of the masks of its active gates and a XOR
+// against the previous state. Only zones whose state changed are reported:
+//
+//   ZoneMap map{{desk, door, couch}, thresholds};   // shared by all sensors
+//   ZoneTracker tracker{map};                        // one per sensor
+//   tracker.update(frame, [](size_t zone, bool occupied) { ... });
+//
+// Zones are held in words of 64, so thousands of them stay cheap.
+
+namespace ld2410 {
+    // distance covered by one gate with the default resolution
+    const uint16_t gate_centimeters = 75;
+
+    struct Zone {
+        uint8_t first_gate = 0;
+        uint8_t last_gate = config_gate_count - 1;
+        // which targets occupy the zone
+        bool moving = true;
+        bool stationary = true;
+    };
+
+    // the gates covering near_cm to far_cm
+    inline Zone zone_from_distances(uint16_t near_cm, uint16_t far_cm, uint16_t gate_cm = gate_centimeters) {
+        Zone zone;
+        zone.first_gate = (uint8_t)std::min<uint32_t>(near_cm / gate_cm, config_gate_count - 1);
+        zone.last_gate = (uint8_t)std::min<uint32_t>(far_cm / gate_cm, config_gate_count - 1);
+        return zone;
+    }
+
+    class ZoneMap {
+        size_t m_zones;
+        size_t m_words;
+        uint16_t m_gate_cm;
+        // a gate is active if its energy exceeds the sensitivity, as for the module itself
+        std::array<uint8_t, config_gate_count> m_motion_threshold;
+        std::array<uint8_t, config_gate_count> m_static_threshold;
+        // m_words words per gate, bit z is set if a target at the gate occupies zone z
+        std::vector<uint64_t> m_moving;
+        std::vector<uint64_t> m_stationary;
+
+        void occupy(const std::vector<uint64_t> &rows, size_t gate, uint64_t *occupied) const {
+            const uint64_t *row = rows.data() + gate * m_words;
+            for(size_t w = 0; w < m_words; ++w) {
+                occupied[w] |= row[w];
+            }
+        }
+
+    public:
+        // thresholds are usually the parameters read from the sensor
+        ZoneMap(const std::vector<Zone> &zones, const SensorConfig &thresholds, uint16_t gate_cm = gate_centimeters)
+            : m_zones(zones.size()), m_words((zones.size() + 63) / 64), m_gate_cm(gate_cm),
+              m_motion_threshold(thresholds.motion_sensitivity), m_static_threshold(thresholds.static_sensitivity),
+              m_moving(config_gate_count * m_words, 0), m_stationary(config_gate_count * m_words, 0) {
+            for(size_t z = 0; z < zones.size(); ++z) {
+                for(size_t gate = zones[z].first_gate; gate <= zones[z].last_gate && gate < config_gate_count; ++gate) {
+                    uint64_t bit = (uint64_t)1 << (z % 64);
+                    if (zones[z].moving) m_moving[gate * m_words + z / 64] |= bit;
+                    if (zones[z].stationary) m_stationary[gate * m_words + z / 64] |= bit;
+                }
+            }
+        }
+
+        size_t zones() const {
+            return m_zones;
+        }
+
+        // words of 64 zones
+        size_t words() const {
+            return m_words;
+        }
+
+        // ORs the zones occupied by frame into occupied, words() words
+        template <std::size_t max_gate_n>
+        void occupied(const BasicEngineeringModeDataFrame<max_gate_n> &frame, uint64_t *occupied) const {
+            const auto &movement = frame.movement_distance_gate_energy_value();
+            const auto &stationary = frame.static_distance_gate_energy_value();
+            for(size_t gate = 0; gate < movement.size() && gate < config_gate_count; ++gate) {
+                if (movement[gate] > m_motion_threshold[gate]) occupy(m_moving, gate, occupied);
+            }
+            for(size_t gate = 0; gate < stationary.size() && gate < config_gate_count; ++gate) {
+                if (stationary[gate] > m_static_threshold[gate]) occupy(m_stationary, gate, occupied);
+            }
+        }
+
+        // without gate energies the gates of the target distances are taken
+        void occupied(const ReportingDataFrame &frame, uint64_t *occupied) const {
+            if (frame.target_state() & 1) {
+                occupy(m_moving, std::min<size_t>(frame.movement_target_distance() / m_gate_cm, config_gate_count - 1), occupied);
+            }
+            if (frame.target_state() & 2) {
+                occupy(m_stationary, std::min<size_t>(frame.stationary_target_distance() / m_gate_cm, config_gate_count - 1), occupied);
+            }
+        }
+    };
+
+    // Zone states of one sensor. Memory is allocated on construction only.
+    class ZoneTracker {
+        const ZoneMap *m_map;
+        std::vector<uint64_t> m_occupied;
+        std::vector<uint64_t> m_next;
+
+    public:
+        explicit ZoneTracker(const ZoneMap &map): m_map(&map), m_occupied(map.words(), 0), m_next(map.words(), 0) {
+
+        }
+
+        // Evaluates frame and calls on_transition(size_t zone, bool occupied)
+        // for every zone that became occupied or free.
+        template <typename TFrame, typename F>
+        void update(const TFrame &frame, F on_transition) {
+            std::fill(m_next.begin(), m_next.end(), 0);
+            m_map->occupied(frame, m_next.data());
+
+            for(size_t w = 0; w < m_next.size(); ++w) {
+                uint64_t changed = m_next[w] ^ m_occupied[w];
+                m_occupied[w] = m_next[w];
+                while(changed != 0) {
+                    size_t bit = __builtin_ctzll(changed);
+                    changed &= changed - 1;
+                    on_transition(w * 64 + bit, ((m_next[w] >> bit) & 1) != 0);
+                }
+            }
+        }
+
+        bool occupied(size_t zone) const {
+            return ((m_occupied[zone / 64] >> (zone % 64)) & 1) != 0;
+        }
+
+        // every zone free again, without reporting it
+        void reset() {
+            std::fill(m_occupied.begin(), m_occupied.end(), 0);
+        }
+    };
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "ld2410_arrival_stats.h"
+#include "ld2410_metrics.h"
+#include "helpers.h"
+
+using namespace ld2410;
+
+class ManualClock {
+    const uint32_t *m_now;
+
+public:
+    explicit ManualClock(const uint32_t &now): m_now(&now) {
+
+    }
+
+    uint32_t operator()() const {
+        return *m_now;
+    }
+};
+
+static const std::vector<uint8_t> arrival_test_report{0xF4, 0xF3, 0xF2, 0xF1, 0x0D, 0x00, 0x02, 0xAA, 0x02, 0x51, 0x01, 0x00, 0x00, 0x00, 0x3B, 0x00, 0x00, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5};
+
+TEST(ArrivalStatsTest, StampsFirstHeaderByte) {
+    uint32_t now = 1000;
+    ArrivalTracker<ManualClock> tracker{ManualClock{now}};
+
+    // every byte arrives one tick after the previous one
+    BufferReader buffer{arrival_test_report.data(), arrival_test_report.size()};
+    auto r = [&]() {
+        now += 1;
+        return buffer();
+    };
+
+    EXPECT_EQ(true, read_from_reader<ReportingDataFrame>(r, tracker).has_value());
+    EXPECT_EQ(1001, tracker.last_frame_time());
+    EXPECT_EQ(1, tracker.frames());
+}
+
+TEST(ArrivalStatsTest, InterArrivalAndJitter) {
+    uint32_t now = 0;
+    ArrivalTracker<ManualClock> tracker{ManualClock{now}};
+
+    const uint32_t arrivals[] = {100, 200, 310, 400, 500};
+    for(uint32_t t : arrivals) {
+        now = t;
+        BufferReader r{arrival_test_report.data(), arrival_test_report.size()};
+        EXPECT_EQ(true, read_from_reader<ReportingDataFrame>(r, tracker).has_value());
+    }
+
+    EXPECT_EQ(5, tracker.frames());
+    EXPECT_EQ(500, tracker.last_frame_time());
+    EXPECT_EQ(100, tracker.last_interval());
+    EXPECT_EQ(90, tracker.min_interval());
+    EXPECT_EQ(110, tracker.max_interval());
+    EXPECT_EQ(100, tracker.mean_interval());
+    // |D| is 10, 20 and 10, each smoothed in by 1/16
+    EXPECT_EQ(2, tracker.jitter());
+
+    now = 750;
+    EXPECT_EQ(250, tracker.since_last_frame());
+}
+
+TEST(ArrivalStatsTest, IgnoresAcks) {
+    uint32_t now = 10;
+    ArrivalTracker<ManualClock> tracker{ManualClock{now}};
+    InMemoryReader r{{0xFD, 0xFC, 0xFB, 0xFA, 0x04, 0x00, 0xFE, 0x01, 0x00, 0x00, 0x04, 0x03, 0x02, 0x01}};
+
+    EXPECT_EQ(true, read_from_reader<EndConfigurationCommandAck>(r, tracker).has_value());
+    EXPECT_EQ(0, tracker.frames());
+    EXPECT_EQ(10, tracker.last_frame_time());
+}
+
+TEST(ArrivalStatsTest, WrappingClock) {
+    uint32_t now = 0xffffffc0;
+    ArrivalTracker<ManualClock> tracker{ManualClock{now}};
+
+    for(int i = 0; i < 2; ++i) {
+        BufferReader r{arrival_test_report.data(), arrival_test_report.size()};
+        read_from_reader<ReportingDataFrame>(r, tracker);
+        now += 100;
+    }
+
+    EXPECT_EQ(100, tracker.last_interval());
+}
+
+TEST(ArrivalStatsTest, CombinesWithOtherObservers) {
+    uint32_t now = 0;
+    ArrivalTracker<ManualClock> first{ManualClock{now}};
+    ArrivalTracker<ManualClock> second{ManualClock{now}};
+    DecoderMetrics metrics;
+    auto observers = observe_all(first, second, metrics);
+
+    BufferReader r{arrival_test_report.data(), arrival_test_report.size()};
+    EXPECT_EQ(true, read_from_reader<ReportingDataFrame>(r, observers).has_value());
+    EXPECT_EQ(1, first.frames());
+    EXPECT_EQ(1, second.frames());
+#ifdef LD2410_METRICS
+    EXPECT_EQ(1, metrics.snapshot().frames[packet_kind_index(ReportingDataFrame::definition_type.val.val)]);
+#endif
+}
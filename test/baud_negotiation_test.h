@@ -0,0 +1,177 @@
+#pragma once
+
+#include <deque>
+
+#include <gtest/gtest.h>
+#include "ld2410_baud_negotiation.h"
+#include "pty_sensor.h"
+#include "simulated_sensor.h"
+
+using namespace ld2410;
+
+class SimulatedLocalBaud {
+    SimulatedSensor *m_sensor;
+
+public:
+    explicit SimulatedLocalBaud(SimulatedSensor &sensor): m_sensor(&sensor) {
+
+    }
+
+    void operator()(uint32_t bps) {
+        m_sensor->set_local_baud(bps);
+    }
+};
+
+// the in-memory sensor restarts at once
+inline BaudNegotiationOptions instant_restart() {
+    BaudNegotiationOptions options;
+    options.restart_settle = 0;
+    return options;
+}
+
+TEST(BaudNegotiationTest, ProbeCleanLink) {
+    SimulatedSensor sensor;
+    auto r = sensor.reader();
+    auto w = sensor.writer();
+    BaudRateNegotiator negotiator{w, r, SimulatedLocalBaud{sensor}, BaudRate::BaudRate_256000, instant_restart()};
+
+    auto result = negotiator.probe();
+    EXPECT_GE(result.frames, 15);
+    EXPECT_EQ(0, result.damaged_frames);
+    EXPECT_EQ(0, result.loss_permille());
+}
+
+TEST(BaudNegotiationTest, ProbeWrongLocalRate) {
+    SimulatedSensor sensor;
+    sensor.set_local_baud(115200);
+    auto r = sensor.reader();
+    auto w = sensor.writer();
+    BaudNegotiationOptions options = instant_restart();
+    options.probe_timeout = 50;
+    BaudRateNegotiator negotiator{w, r, SimulatedLocalBaud{sensor}, BaudRate::BaudRate_115200, options};
+
+    // garbage without a single header
+    auto result = negotiator.probe();
+    EXPECT_EQ(true, result.silent());
+    EXPECT_EQ(1000, result.loss_permille());
+}
+
+TEST(BaudNegotiationTest, NegotiatesHighestCleanRate) {
+    SimulatedSensor sensor;
+    auto r = sensor.reader();
+    auto w = sensor.writer();
+    BaudRateNegotiator negotiator{w, r, SimulatedLocalBaud{sensor}, BaudRate::BaudRate_256000, instant_restart()};
+
+    EXPECT_EQ(BaudRate::BaudRate_460800, negotiator.negotiate());
+    EXPECT_EQ(BaudRate::BaudRate_460800, sensor.baud);
+    EXPECT_EQ(460800, sensor.local_bps);
+    EXPECT_EQ(true, negotiator.result(BaudRate::BaudRate_460800).probed);
+    EXPECT_EQ(0, negotiator.result(BaudRate::BaudRate_460800).loss_permille());
+}
+
+TEST(BaudNegotiationTest, RevertsWhenFasterRateLosesFrames) {
+    SimulatedSensor sensor;
+    sensor.max_clean_bps = 256000;
+    auto r = sensor.reader();
+    auto w = sensor.writer();
+    BaudRateNegotiator negotiator{w, r, SimulatedLocalBaud{sensor}, BaudRate::BaudRate_256000, instant_restart()};
+
+    EXPECT_EQ(BaudRate::BaudRate_256000, negotiator.negotiate());
+    EXPECT_EQ(BaudRate::BaudRate_256000, sensor.baud);
+    EXPECT_EQ(256000, sensor.local_bps);
+    EXPECT_GE(negotiator.result(BaudRate::BaudRate_460800).loss_permille(), 400);
+    EXPECT_EQ(0, negotiator.result(BaudRate::BaudRate_256000).loss_permille());
+}
+
+TEST(BaudNegotiationTest, FallsBackWhenLinkDegrades) {
+    SimulatedSensor sensor;
+    auto r = sensor.reader();
+    auto w = sensor.writer();
+    BaudRateNegotiator negotiator{w, r, SimulatedLocalBaud{sensor}, BaudRate::BaudRate_256000, instant_restart()};
+    negotiator.negotiate();
+
+    sensor.max_clean_bps = 115200;
+    EXPECT_EQ(BaudRate::BaudRate_115200, negotiator.check_link());
+    EXPECT_EQ(BaudRate::BaudRate_115200, sensor.baud);
+    EXPECT_EQ(115200, sensor.local_bps);
+}
+
+TEST(BaudNegotiationTest, SilentSensorKeepsItsRate) {
+    SimulatedSensor sensor;
+    sensor.hung = true;
+    auto r = sensor.reader();
+    auto w = sensor.writer();
+    BaudNegotiationOptions options = instant_restart();
+    options.probe_timeout = 50;
+    BaudRateNegotiator negotiator{w, r, SimulatedLocalBaud{sensor}, BaudRate::BaudRate_256000, options};
+
+    EXPECT_EQ(BaudRate::BaudRate_256000, negotiator.check_link());
+    EXPECT_EQ(BaudRate::BaudRate_256000, negotiator.negotiate());
+    EXPECT_EQ(true, negotiator.result(BaudRate::BaudRate_256000).silent());
+    EXPECT_EQ(0, sensor.received_commands.size());
+}
+
+TEST(BaudNegotiationTest, KeepsTheRateItTalksAtWhenRevertFails) {
+    SimulatedSensor sensor;
+    sensor.max_clean_bps = 256000;
+    auto r = sensor.reader();
+    auto w = sensor.writer();
+    // the module stops listening once at the lossy rate
+    auto set_local_baud = [&](uint32_t bps) {
+        sensor.set_local_baud(bps);
+        if (bps == 460800) sensor.deaf = true;
+    };
+    BaudNegotiationOptions options = instant_restart();
+    options.ack_timeout = 20;
+    BaudRateNegotiator negotiator{w, r, set_local_baud, BaudRate::BaudRate_256000, options};
+
+    EXPECT_EQ(BaudRate::BaudRate_460800, negotiator.negotiate());
+    EXPECT_EQ(BaudRate::BaudRate_460800, negotiator.current());
+    EXPECT_EQ(BaudRate::BaudRate_460800, sensor.baud);
+    EXPECT_EQ(460800, sensor.local_bps);
+    EXPECT_GE(negotiator.result(BaudRate::BaudRate_460800).loss_permille(), 400);
+}
+
+TEST(BaudNegotiationTest, NegotiatesOverPty) {
+    std::deque<PtySensorPort> ports(1);
+    PtySensorPort &port = ports.front();
+    port.sensor.max_clean_bps = 256000;
+    PtySensorServer server{ports};
+
+    auto r = port.reader();
+    auto w = port.writer();
+    auto set_local_baud = [&](uint32_t bps) { port.set_local_baud(bps); };
+    // reports come every 100 ms, five of them are enough here
+    BaudNegotiationOptions options;
+    options.probe_frames = 5;
+    options.restart_settle = 200;
+    BaudRateNegotiator negotiator{w, r, set_local_baud, BaudRate::BaudRate_256000, options};
+
+    EXPECT_EQ(BaudRate::BaudRate_256000, negotiator.negotiate());
+    EXPECT_EQ(0, negotiator.result(BaudRate::BaudRate_256000).loss_permille());
+    EXPECT_GE(negotiator.result(BaudRate::BaudRate_460800).loss_permille(), 400);
+
+    std::lock_guard<std::mutex> lock(port.mutex);
+    EXPECT_EQ(BaudRate::BaudRate_256000, port.sensor.baud);
+    EXPECT_EQ(256000, port.sensor.local_bps);
+}
+
+TEST(BaudNegotiationTest, SilentPtyIsNotSteppedDown) {
+    std::deque<PtySensorPort> ports(1);
+    PtySensorPort &port = ports.front();
+    port.sensor.hung = true;
+    PtySensorServer server{ports};
+
+    auto r = port.reader();
+    auto w = port.writer();
+    auto set_local_baud = [&](uint32_t bps) { port.set_local_baud(bps); };
+    BaudNegotiationOptions options;
+    options.probe_timeout = 300;
+    BaudRateNegotiator negotiator{w, r, set_local_baud, BaudRate::BaudRate_256000, options};
+
+    EXPECT_EQ(BaudRate::BaudRate_256000, negotiator.check_link());
+    EXPECT_EQ(true, negotiator.result(BaudRate::BaudRate_256000).silent());
+
+    std::lock_guard<std::mutex> lock(port.mutex);
+    EXPECT_EQ(0, port.sensor.received_commands.size());
+}
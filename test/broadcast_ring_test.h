@@ -0,0 +1,103 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ld2410_broadcast_ring.h"
+#include "ld2410_packets.h"
+
+using namespace ld2410;
+
+inline ReportingDataFrame numbered_reporting_frame(uint16_t n) {
+    ReportingDataFrame frame;
+    frame.target_state(1);
+    frame.movement_target_distance(n);
+    return frame;
+}
+
+TEST(BroadcastRingTest, EveryConsumerGetsEveryFrame) {
+    BroadcastRing<std::variant<ReportingDataFrame>, 8> ring;
+    auto first = ring.consumer();
+    auto second = ring.consumer();
+
+    for(uint16_t i = 0; i < 5; ++i) {
+        ring.publish(numbered_reporting_frame(i));
+    }
+
+    std::variant<ReportingDataFrame> frame;
+    for(uint16_t i = 0; i < 5; ++i) {
+        EXPECT_EQ(true, first.read(frame));
+        EXPECT_EQ(i, std::get<ReportingDataFrame>(frame).movement_target_distance());
+    }
+    EXPECT_EQ(false, first.read(frame));
+
+    EXPECT_EQ(5, second.pending());
+    EXPECT_EQ(true, second.read(frame));
+    EXPECT_EQ(0, std::get<ReportingDataFrame>(frame).movement_target_distance());
+    EXPECT_EQ(0, second.lost());
+}
+
+TEST(BroadcastRingTest, ConsumerStartsAtCurrentHead) {
+    BroadcastRing<ReportingDataFrame, 4> ring;
+    ring.publish(numbered_reporting_frame(1));
+
+    auto consumer = ring.consumer();
+    ReportingDataFrame frame;
+    EXPECT_EQ(false, consumer.read(frame));
+
+    ring.publish(numbered_reporting_frame(2));
+    EXPECT_EQ(true, consumer.read(frame));
+    EXPECT_EQ(2, frame.movement_target_distance());
+}
+
+TEST(BroadcastRingTest, SlowConsumerOverrun) {
+    BroadcastRing<ReportingDataFrame, 4> ring;
+    auto consumer = ring.consumer();
+
+    for(uint16_t i = 0; i < 10; ++i) {
+        ring.publish(numbered_reporting_frame(i));
+    }
+
+    ReportingDataFrame frame;
+    EXPECT_EQ(true, consumer.read(frame));
+    EXPECT_EQ(6, frame.movement_target_distance());
+    EXPECT_EQ(6, consumer.lost());
+}
+
+TEST(BroadcastRingTest, ConcurrentConsumers) {
+    const uint16_t frames = 20000;
+    BroadcastRing<ReportingDataFrame, 64> ring;
+    std::vector<std::thread> threads;
+    std::atomic<bool> failed{false};
+    std::atomic<int> ready{0};
+
+    for(int c = 0; c < 4; ++c) {
+        threads.emplace_back([&]() {
+            auto consumer = ring.consumer();
+            ready.fetch_add(1);
+
+            uint32_t received = 0;
+            int32_t last = -1;
+            ReportingDataFrame frame;
+            while(last != frames - 1) {
+                if (!consumer.read(frame)) continue;
+                int32_t n = frame.movement_target_distance();
+                if (n <= last || frame.target_state() != 1) failed = true;
+                last = n;
+                ++received;
+            }
+            if (received + consumer.lost() != frames) failed = true;
+        });
+    }
+
+    while(ready.load() != 4);
+    for(uint16_t i = 0; i < frames; ++i) {
+        ring.publish(numbered_reporting_frame(i));
+    }
+    for(auto &t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(false, failed.load());
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ld2410_calibration.h"
+#include "simulated_sensor.h"
+
+using namespace ld2410;
+
+inline EngineeringModeDataFrame zero_energy_frame() {
+    EngineeringModeDataFrame frame{};
+    frame.maximum_moving_distance_gate_n(8);
+    frame.maximum_static_distance_gate_n(8);
+    frame.movement_distance_gate_energy_value({0, 0, 0, 0, 0, 0, 0, 0, 0});
+    frame.static_distance_gate_energy_value({0, 0, 0, 0, 0, 0, 0, 0, 0});
+    return frame;
+}
+
+TEST(CalibrationTest, RecordedFrames) {
+    // the same engineering mode frame five times, one without a target
+    const std::vector<uint8_t> frame{0xF4, 0xF3, 0xF2, 0xF1, 0x23, 0x00, 0x01, 0xAA, 0x03, 0x1E, 0x00, 0x3C, 0x00, 0x00, 0x39, 0x00, 0x00, 0x08, 0x08, 0x3C, 0x22, 0x05, 0x03, 0x03, 0x04, 0x03, 0x06, 0x05, 0x00, 0x00, 0x39, 0x10, 0x13, 0x06, 0x06, 0x08, 0x04, 0x03, 0x05, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5};
+    std::vector<uint8_t> data;
+    for(int i = 0; i < 5; ++i) data.insert(data.end(), frame.begin(), frame.end());
+
+    BufferReader r{data.data(), data.size()};
+    NoiseCalibrator calibrator;
+    for(int i = 0; i < 5; ++i) {
+        EXPECT_EQ(true, read_from_reader<EngineeringModeDataFrame>(r, calibrator).has_value());
+    }
+    EXPECT_EQ(5, calibrator.frames());
+
+    SensorConfig current;
+    current.static_sensitivity = {7, 7, 7, 7, 7, 7, 7, 7, 7};
+    CalibrationOptions options;
+    options.margin = 10;
+    SensorConfig recommended = calibrator.recommend(current, options);
+
+    std::array<uint8_t, config_gate_count> motion{70, 44, 15, 13, 13, 14, 13, 16, 15};
+    std::array<uint8_t, config_gate_count> stationary{7, 7, 67, 26, 29, 16, 16, 18, 14};
+    EXPECT_EQ(motion, recommended.motion_sensitivity);
+    EXPECT_EQ(stationary, recommended.static_sensitivity);
+}
+
+TEST(CalibrationTest, PercentileOfNoise) {
+    NoiseCalibrator calibrator;
+    EngineeringModeDataFrame frame{};
+    frame.maximum_moving_distance_gate_n(1);
+    frame.maximum_static_distance_gate_n(1);
+
+    // gate 0 is noisy, gate 1 has a single spike
+    for(uint8_t i = 0; i < 100; ++i) {
+        frame.movement_distance_gate_energy_value({i, (uint8_t)(i == 50 ? 95 : 5)});
+        frame.static_distance_gate_energy_value({0, 0});
+        calibrator.add(frame);
+    }
+
+    CalibrationOptions options;
+    options.percentile = 90;
+    options.margin = 5;
+    SensorConfig recommended = calibrator.recommend(SensorConfig{}, options);
+    EXPECT_NEAR(95, recommended.motion_sensitivity[0], 1);
+    EXPECT_EQ(10, recommended.motion_sensitivity[1]);
+    // gates without frames keep their value
+    EXPECT_EQ(0, recommended.motion_sensitivity[2]);
+
+    options.margin = 50;
+    EXPECT_EQ(100, calibrator.recommend(SensorConfig{}, options).motion_sensitivity[0]);
+}
+
+TEST(CalibrationTest, CalibratesSimulatedSensor) {
+    SimulatedSensor sensor;
+    sensor.target_state = 0;
+    auto w = sensor.writer();
+
+    CalibrationOptions options;
+    options.frames = 50;
+    options.margin = 8;
+    NoiseCalibrator calibrator;
+    CalibrationReport report = calibrate_sensor(w, sensor.reader(), calibrator, options);
+
+    EXPECT_EQ(true, report.success());
+    EXPECT_EQ(50, report.frames);
+    EXPECT_EQ(false, sensor.engineering_mode);
+    EXPECT_EQ(false, sensor.config_mode);
+
+    std::array<uint8_t, 9> motion{68, 42, 13, 11, 11, 12, 11, 14, 13};
+    std::array<uint8_t, 9> stationary{0, 0, 65, 24, 27, 14, 14, 16, 12};
+    EXPECT_EQ(motion, sensor.motion_sensitivity);
+    EXPECT_EQ(stationary, sensor.static_sensitivity);
+    EXPECT_EQ(motion, report.recommended.motion_sensitivity);
+
+    // engineering mode on, then reading and writing the parameters in one session
+    EXPECT_EQ(2, std::count(sensor.received_commands.begin(), sensor.received_commands.end(), 0x00ff));
+    EXPECT_EQ(9, sensor.parameter_writes);
+}
+
+TEST(CalibrationTest, GivesUpWithoutFrames) {
+    SimulatedSensor sensor;
+    sensor.hung = true;
+    auto w = sensor.writer();
+    auto before = sensor.motion_sensitivity;
+
+    CalibrationOptions options;
+    options.capture_timeout = 50;
+    NoiseCalibrator calibrator;
+    CalibrationReport report = calibrate_sensor(w, sensor.reader(), calibrator, options);
+
+    EXPECT_EQ(false, report.captured);
+    EXPECT_EQ(false, report.success());
+    EXPECT_EQ(false, sensor.engineering_mode);
+    EXPECT_EQ(0, sensor.parameter_writes);
+    EXPECT_EQ(before, sensor.motion_sensitivity);
+}
+
+TEST(CalibrationTest, ClosesEngineeringModeWhenTheSessionFails) {
+    SimulatedSensor sensor;
+    sensor.target_state = 0;
+    // the session writing the sensitivities after the capture is not opened
+    sensor.ignored_enable_config = 1;
+    auto w = sensor.writer();
+    auto before = sensor.motion_sensitivity;
+
+    CalibrationOptions options;
+    options.frames = 20;
+    options.ack_timeout = 50;
+    // frames of an earlier run are dropped
+    NoiseCalibrator calibrator;
+    calibrator.add(zero_energy_frame());
+    CalibrationReport report = calibrate_sensor(w, sensor.reader(), calibrator, options);
+
+    EXPECT_EQ(true, report.captured);
+    EXPECT_EQ(false, report.success());
+    EXPECT_EQ(20, calibrator.frames());
+    EXPECT_EQ(5, calibrator.movement_energy(2).lowest());
+    EXPECT_EQ(false, sensor.engineering_mode);
+    EXPECT_EQ(false, sensor.config_mode);
+    EXPECT_EQ(0, sensor.parameter_writes);
+    EXPECT_EQ(before, sensor.motion_sensitivity);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "ld2410_config_sync.h"
+#include "simulated_sensor.h"
+
+using namespace ld2410;
+
+static SensorConfig simulated_sensor_config(const SimulatedSensor &sensor) {
+    SensorConfig config;
+    config.maximum_moving_distance_gate = sensor.max_moving_gate;
+    config.maximum_static_distance_gate = sensor.max_static_gate;
+    config.no_one_duration = sensor.no_one_duration;
+    for(size_t i = 0; i < config_gate_count; ++i) {
+        config.motion_sensitivity[i] = sensor.motion_sensitivity[i];
+        config.static_sensitivity[i] = sensor.static_sensitivity[i];
+    }
+    return config;
+}
+
+TEST(ConfigSyncTest, DiffConfig) {
+    SensorConfig current;
+    SensorConfig desired;
+    EXPECT_EQ(true, diff_config(current, desired).empty());
+
+    desired.no_one_duration = 10;
+    desired.static_sensitivity[2] = 40;
+    desired.motion_sensitivity[8] = 15;
+    auto diff = diff_config(current, desired);
+    EXPECT_EQ(true, diff.distances);
+    EXPECT_EQ((1 << 2) | (1 << 8), diff.gates);
+    EXPECT_EQ(false, diff.all_gates());
+}
+
+TEST(ConfigSyncTest, UnchangedConfigWritesNothing) {
+    SimulatedSensor sensor;
+    auto w = sensor.writer();
+    SensorConfig desired = simulated_sensor_config(sensor);
+
+    auto report = sync_config(w, sensor.reader(), desired);
+
+    EXPECT_EQ(true, report.read);
+    EXPECT_EQ(true, report.success);
+    EXPECT_EQ(true, report.changed.empty());
+    EXPECT_EQ(0, report.writes);
+    EXPECT_EQ(desired, report.previous);
+    EXPECT_EQ(0, sensor.parameter_writes);
+    EXPECT_EQ((std::vector<uint16_t>{0x00ff, 0x0061, 0x00fe}), sensor.received_commands);
+    EXPECT_EQ(false, sensor.config_mode);
+}
+
+TEST(ConfigSyncTest, WritesOnlyChangedGates) {
+    SimulatedSensor sensor;
+    auto w = sensor.writer();
+    SensorConfig desired = simulated_sensor_config(sensor);
+    desired.motion_sensitivity[3] = 45;
+    desired.static_sensitivity[5] = 60;
+
+    auto report = sync_config(w, sensor.reader(), desired);
+
+    EXPECT_EQ(true, report.success);
+    EXPECT_EQ(false, report.changed.distances);
+    EXPECT_EQ((1 << 3) | (1 << 5), report.changed.gates);
+    EXPECT_EQ(2, report.writes);
+    EXPECT_EQ(2, sensor.parameter_writes);
+    EXPECT_EQ(desired, simulated_sensor_config(sensor));
+    EXPECT_EQ((std::vector<uint16_t>{0x00ff, 0x0061, 0x0064, 0x0064, 0x00fe}), sensor.received_commands);
+}
+
+TEST(ConfigSyncTest, WritesDistances) {
+    SimulatedSensor sensor;
+    auto w = sensor.writer();
+    SensorConfig desired = simulated_sensor_config(sensor);
+    desired.maximum_moving_distance_gate = 6;
+    desired.no_one_duration = 30;
+
+    auto report = sync_config(w, sensor.reader(), desired);
+
+    EXPECT_EQ(true, report.success);
+    EXPECT_EQ(true, report.changed.distances);
+    EXPECT_EQ(0, report.changed.gates);
+    EXPECT_EQ(1, report.writes);
+    EXPECT_EQ(desired, simulated_sensor_config(sensor));
+}
+
+TEST(ConfigSyncTest, UniformGatesInOneCommand) {
+    SimulatedSensor sensor;
+    auto w = sensor.writer();
+    SensorConfig desired = simulated_sensor_config(sensor);
+    desired.motion_sensitivity.fill(25);
+    desired.static_sensitivity.fill(35);
+
+    auto report = sync_config(w, sensor.reader(), desired);
+
+    EXPECT_EQ(true, report.success);
+    EXPECT_EQ(true, report.changed.all_gates());
+    EXPECT_EQ(1, report.writes);
+    EXPECT_EQ(desired, simulated_sensor_config(sensor));
+}
+
+TEST(ConfigSyncTest, UnreachableSensor) {
+    SimulatedSensor sensor;
+    sensor.set_local_baud(115200);
+    auto w = sensor.writer();
+
+    auto report = sync_config(w, sensor.reader(), SensorConfig{}, 50);
+
+    EXPECT_EQ(false, report.read);
+    EXPECT_EQ(false, report.success);
+    EXPECT_EQ(0, report.writes);
+    EXPECT_EQ(true, sensor.received_commands.empty());
+}
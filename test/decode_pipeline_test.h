@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ld2410_decode_pipeline.h"
+#include "helpers.h"
+
+using namespace ld2410;
+
+inline std::vector<uint8_t> build_capture(size_t frame_pairs) {
+    const std::vector<uint8_t> reporting{0xF4, 0xF3, 0xF2, 0xF1, 0x0D, 0x00, 0x02, 0xAA, 0x02, 0x51, 0x01, 0x00, 0x00, 0x00, 0x3B, 0x00, 0x00, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5};
+    const std::vector<uint8_t> engineering{0xF4, 0xF3, 0xF2, 0xF1, 0x23, 0x00, 0x01, 0xAA, 0x03, 0x1E, 0x00, 0x3C, 0x00, 0x00, 0x39, 0x00, 0x00, 0x08, 0x08, 0x3C, 0x22, 0x05, 0x03, 0x03, 0x04, 0x03, 0x06, 0x05, 0x00, 0x00, 0x39, 0x10, 0x13, 0x06, 0x06, 0x08, 0x04, 0x03, 0x05, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5};
+
+    std::vector<uint8_t> capture;
+    for(size_t i = 0; i < frame_pairs; ++i) {
+        capture.insert(capture.end(), reporting.begin(), reporting.end());
+        // some line noise, including a truncated header
+        capture.insert(capture.end(), {0x00, 0xF4, 0xF3, 0x13});
+        capture.insert(capture.end(), engineering.begin(), engineering.end());
+        // the movement distance encodes the position in the capture
+        capture[capture.size() - engineering.size() + 9] = (uint8_t)i;
+    }
+    return capture;
+}
+
+inline void check_decoded_capture(const std::vector<std::variant<EngineeringModeDataFrame, ReportingDataFrame>> &frames, size_t frame_pairs) {
+    EXPECT_EQ(frame_pairs * 2, frames.size());
+    if (frames.size() != frame_pairs * 2) return;
+
+    for(size_t i = 0; i < frame_pairs; ++i) {
+        EXPECT_EQ(true, std::holds_alternative<ReportingDataFrame>(frames[i*2]));
+        EXPECT_EQ(true, std::holds_alternative<EngineeringModeDataFrame>(frames[i*2+1]));
+        if (!std::holds_alternative<EngineeringModeDataFrame>(frames[i*2+1])) return;
+
+        auto engineering = std::get<EngineeringModeDataFrame>(frames[i*2+1]);
+        EXPECT_EQ((uint8_t)i, engineering.movement_target_distance());
+        EXPECT_EQ(9, engineering.static_distance_gate_energy_value().size());
+    }
+}
+
+TEST(DecodePipelineTest, FindFrameOffsets) {
+    auto capture = build_capture(3);
+    auto offsets = find_frame_offsets<EngineeringModeDataFrame, ReportingDataFrame>(capture.data(), capture.size());
+
+    std::vector<size_t> expected{0, 27, 72, 99, 144, 171};
+    EXPECT_EQ(expected, offsets);
+}
+
+TEST(DecodePipelineTest, IgnoresTruncatedFrame) {
+    auto capture = build_capture(2);
+    capture.resize(capture.size() - 1);
+    auto frames = decode_parallel<EngineeringModeDataFrame, ReportingDataFrame>(capture.data(), capture.size());
+
+    EXPECT_EQ(3, frames.size());
+}
+
+TEST(DecodePipelineTest, SingleThread) {
+    auto capture = build_capture(100);
+    DecodePipelineOptions options;
+    options.threads = 1;
+
+    check_decoded_capture(decode_parallel<EngineeringModeDataFrame, ReportingDataFrame>(capture.data(), capture.size(), options), 100);
+}
+
+TEST(DecodePipelineTest, FramesAcrossChunks) {
+    auto capture = build_capture(200);
+    DecodePipelineOptions options;
+    options.threads = 4;
+    options.chunk_size = 50;
+    options.frames_per_task = 7;
+
+    check_decoded_capture(decode_parallel<EngineeringModeDataFrame, ReportingDataFrame>(capture.data(), capture.size(), options), 200);
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <deque>
+
+#include <gtest/gtest.h>
+#include "ld2410_discovery.h"
+#include "pty_sensor.h"
+#include "simulated_sensor.h"
+
+using namespace ld2410;
+
+// a serial port with or without a sensor attached
+class DiscoveryPort {
+public:
+    SimulatedSensor sensor;
+    bool attached = true;
+
+    auto writer() {
+        return [this](const uint8_t *data, size_t size) {
+            if (attached) sensor.write(data, size);
+        };
+    }
+
+    auto reader() {
+        return [this]() -> uint8_t {
+            return attached ? sensor.read() : 0;
+        };
+    }
+
+    void set_local_baud(uint32_t bps) {
+        sensor.set_local_baud(bps);
+    }
+};
+
+static size_t rescan_position(BaudRate rate) {
+    for(size_t i = 0; i < watchdog_rescan_order.size(); ++i) {
+        if (watchdog_rescan_order[i] == rate) return i;
+    }
+    return watchdog_rescan_order.size();
+}
+
+TEST(DiscoveryTest, FindsEverySensorAtItsRate) {
+    const BaudRate rates[] = {BaudRate::BaudRate_256000, BaudRate::BaudRate_115200, BaudRate::BaudRate_57600, BaudRate::BaudRate_9600};
+    std::deque<DiscoveryPort> ports(12);
+    for(size_t i = 0; i < ports.size(); ++i) {
+        ports[i].sensor.baud = rates[i % 4];
+    }
+    ports[3].sensor.engineering_mode = true;
+    // left in configuration mode, it does not report
+    ports[5].sensor.config_mode = true;
+    ports[7].attached = false;
+
+    DiscoveryOptions options;
+    options.sniff_timeout = 20;
+    options.ack_timeout = 20;
+    auto sensors = discover_sensors(ports, ports.size(), options);
+
+    for(size_t i = 0; i < ports.size(); ++i) {
+        if (i == 7) continue;
+        EXPECT_EQ(true, sensors[i].found);
+        EXPECT_EQ(rates[i % 4], sensors[i].baud_rate);
+        EXPECT_EQ(rescan_position(rates[i % 4]) + 1, sensors[i].rates_tried);
+        EXPECT_EQ(true, sensors[i].firmware.has_value());
+        EXPECT_EQ(baud_rate_to_bps(rates[i % 4]), ports[i].sensor.local_bps);
+        EXPECT_EQ(false, ports[i].sensor.config_mode);
+    }
+
+    EXPECT_EQ(true, sensors[3].engineering_mode);
+    EXPECT_EQ(false, sensors[5].reporting);
+    EXPECT_EQ(true, sensors[6].reporting);
+    EXPECT_EQ(false, sensors[7].found);
+    EXPECT_EQ(watchdog_rescan_order.size(), sensors[7].rates_tried);
+    if (sensors[0].firmware.has_value()) {
+        EXPECT_EQ(0x0102, sensors[0].firmware->major_version_number());
+    }
+}
+
+TEST(DiscoveryTest, SniffingAloneSendsNoCommands) {
+    std::deque<DiscoveryPort> ports(2);
+    ports[1].sensor.baud = BaudRate::BaudRate_460800;
+
+    DiscoveryOptions options;
+    options.read_firmware = false;
+    options.sniff_timeout = 20;
+    options.ack_timeout = 20;
+    auto sensors = discover_sensors(ports, ports.size(), options);
+
+    EXPECT_EQ(true, sensors[0].found && sensors[1].found);
+    EXPECT_EQ(BaudRate::BaudRate_460800, sensors[1].baud_rate);
+    EXPECT_EQ(false, sensors[1].firmware.has_value());
+    EXPECT_EQ(true, ports[0].sensor.received_commands.empty());
+    // commands sent at the wrong rates never arrived
+    EXPECT_EQ(3, sensors[1].rates_tried);
+    EXPECT_EQ(true, ports[1].sensor.received_commands.empty());
+}
+
+TEST(DiscoveryTest, ColdStartOfManyPtys) {
+    std::deque<PtySensorPort> ports(32);
+    for(size_t i = 0; i < ports.size(); ++i) {
+        ASSERT_EQ(true, ports[i].pty.valid());
+        // every fourth module was left at the second rate tried
+        if (i % 4 == 3) ports[i].sensor.baud = watchdog_rescan_order[1];
+    }
+    PtySensorServer server{ports};
+
+    auto sensors = discover_sensors(ports, ports.size());
+    for(size_t i = 0; i < ports.size(); ++i) {
+        EXPECT_EQ(true, sensors[i].found);
+        EXPECT_EQ(true, sensors[i].reporting);
+        EXPECT_EQ(true, sensors[i].firmware.has_value());
+        EXPECT_EQ(i % 4 == 3 ? 2 : 1, sensors[i].rates_tried);
+    }
+}
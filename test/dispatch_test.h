@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ld2410_dispatch.h"
+#include "ld2410_metrics.h"
+#include "ld2410_packet_writer.h"
+#include "helpers.h"
+
+using namespace ld2410;
+
+static_assert(std::is_same<internal_helpers::handler_packet_t<void(*)(const ReportingDataFrame &)>, ReportingDataFrame>::value, "function pointers name their packet");
+static_assert(internal_helpers::distinct_types<ReportingDataFrame, EngineeringModeDataFrame>::value, "different packets are distinct");
+static_assert(!internal_helpers::distinct_types<ReportingDataFrame, EngineeringModeDataFrame, ReportingDataFrame>::value, "a packet listed twice is not");
+
+static uint16_t dispatched_distance = 0;
+
+static void remember_distance(const ReportingDataFrame &frame) {
+    dispatched_distance = frame.movement_target_distance();
+}
+
+static std::vector<uint8_t> written_frames() {
+    InMemoryWriter w;
+    ReportingDataFrame reporting{};
+    reporting.movement_target_distance(120);
+    write_to_writer(w, reporting);
+    write_to_writer(w, EndConfigurationCommandAck{});
+    EngineeringModeDataFrame engineering{};
+    engineering.detection_distance(80);
+    // gate 0 only
+    gate_values_t gates;
+    gates.push_back(10);
+    engineering.movement_distance_gate_energy_value(gates);
+    engineering.static_distance_gate_energy_value(gates);
+    write_to_writer(w, engineering);
+    return w.m_data;
+}
+
+TEST(DispatchTest, CallsHandlerOfEachType) {
+    InMemoryReader r{written_frames()};
+    uint16_t reporting = 0, engineering = 0, acks = 0;
+
+    auto on_reporting = [&](const ReportingDataFrame &frame) { reporting = frame.movement_target_distance(); };
+    auto on_ack = [&](const EndConfigurationCommandAck &) { ++acks; };
+    auto on_engineering = [&](const EngineeringModeDataFrame &frame) { engineering = frame.detection_distance(); };
+
+    EXPECT_EQ(true, read_and_dispatch(r, on_reporting, on_ack, on_engineering));
+    EXPECT_EQ(120, reporting);
+    EXPECT_EQ(true, read_and_dispatch(r, on_reporting, on_ack, on_engineering));
+    EXPECT_EQ(1, acks);
+    EXPECT_EQ(true, read_and_dispatch(r, on_reporting, on_ack, on_engineering));
+    EXPECT_EQ(80, engineering);
+}
+
+TEST(DispatchTest, SkipsTypesWithoutHandler) {
+    InMemoryReader r{written_frames()};
+    auto dispatcher = make_dispatcher(remember_distance, [](const EngineeringModeDataFrame &) {});
+    DecoderMetrics metrics;
+
+    dispatched_distance = 0;
+    EXPECT_EQ(true, dispatcher.read(r, metrics));
+    EXPECT_EQ(120, dispatched_distance);
+    // the ack is not taken by any handler and skipped like garbage
+    EXPECT_EQ(false, dispatcher.read(r, metrics));
+    size_t reads = 0;
+    while(!dispatcher.read(r, metrics) && ++reads < 100);
+    EXPECT_LT(reads, 100);
+#ifdef LD2410_METRICS
+    EXPECT_EQ(1, metrics.snapshot().frames[packet_kind_index(ReportingDataFrame::definition_type.val.val)]);
+    EXPECT_EQ(1, metrics.snapshot().frames[packet_kind_index(EngineeringModeDataFrame::definition_type.val.val)]);
+#endif
+}
+
+TEST(DispatchTest, RawFrames) {
+    std::vector<uint8_t> bytes = written_frames();
+    BufferReader r{bytes.data(), bytes.size()};
+    auto frame = read_raw_frame<ReportingDataFrame>(r);
+    ASSERT_EQ(true, frame.has_value());
+
+    uint16_t distance = 0;
+    auto dispatcher = make_dispatcher([&](const ReportingDataFrame &frame) { distance = frame.movement_target_distance(); });
+    EXPECT_EQ(true, dispatcher.dispatch(*frame));
+    EXPECT_EQ(120, distance);
+
+    // data too short for the type
+    frame->size = 4;
+    EXPECT_EQ(false, dispatcher.dispatch(*frame));
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <deque>
+
+#include <gtest/gtest.h>
+#include "ld2410_fleet_config.h"
+#include "config_sync_test.h"
+
+using namespace ld2410;
+
+static SensorConfig retuned_config(const SimulatedSensor &sensor) {
+    SensorConfig desired = simulated_sensor_config(sensor);
+    desired.no_one_duration = 30;
+    desired.motion_sensitivity[2] = 25;
+    desired.static_sensitivity[6] = 35;
+    return desired;
+}
+
+TEST(FleetConfigTest, AppliesToEverySensor) {
+    std::deque<SimulatedSensor> sensors(32);
+    SensorConfig desired = retuned_config(sensors[0]);
+    // already retuned
+    sensors[5].no_one_duration = 30;
+    sensors[5].motion_sensitivity[2] = 25;
+    sensors[5].static_sensitivity[6] = 35;
+
+    FleetOptions options;
+    options.concurrency = 8;
+    auto report = apply_fleet_config(sensors, sensors.size(), desired, options);
+
+    EXPECT_EQ(true, report.success());
+    EXPECT_EQ(31, report.count(FleetOutcome::applied));
+    EXPECT_EQ(1, report.count(FleetOutcome::unchanged));
+    EXPECT_EQ(FleetOutcome::unchanged, report.sensors[5].outcome);
+    EXPECT_EQ(0, report.sensors[5].writes);
+    for(size_t i = 0; i < sensors.size(); ++i) {
+        EXPECT_EQ(desired, simulated_sensor_config(sensors[i]));
+        EXPECT_EQ(false, sensors[i].config_mode);
+    }
+    EXPECT_EQ(1, report.sensors[0].attempts);
+    EXPECT_EQ(3, report.sensors[0].writes);
+}
+
+TEST(FleetConfigTest, RollsBackFailedSensor) {
+    std::deque<SimulatedSensor> sensors(4);
+    sensors[2].rejected_gate = 6;
+    SensorConfig original = simulated_sensor_config(sensors[2]);
+
+    FleetOptions options;
+    options.retries = 1;
+    auto report = apply_fleet_config(sensors, sensors.size(), retuned_config(sensors[0]), options);
+
+    EXPECT_EQ(false, report.success());
+    EXPECT_EQ(3, report.count(FleetOutcome::applied));
+    EXPECT_EQ(FleetOutcome::rolled_back, report.sensors[2].outcome);
+    // two failed attempts and the rollback
+    EXPECT_EQ(3, report.sensors[2].attempts);
+    EXPECT_EQ(original, *report.sensors[2].previous);
+    EXPECT_EQ(original, simulated_sensor_config(sensors[2]));
+}
+
+TEST(FleetConfigTest, KeepsPartialConfigWithoutRollback) {
+    std::deque<SimulatedSensor> sensors(1);
+    sensors[0].rejected_gate = 6;
+    SensorConfig desired = retuned_config(sensors[0]);
+
+    FleetOptions options;
+    options.retries = 0;
+    options.rollback = false;
+    auto report = apply_fleet_config(sensors, 1, desired, options);
+
+    EXPECT_EQ(FleetOutcome::failed, report.sensors[0].outcome);
+    EXPECT_EQ(desired.no_one_duration, sensors[0].no_one_duration);
+    EXPECT_NE(desired, simulated_sensor_config(sensors[0]));
+}
+
+TEST(FleetConfigTest, UnreachableSensorIsRetried) {
+    std::deque<SimulatedSensor> sensors(3);
+    sensors[1].set_local_baud(115200);
+
+    FleetOptions options;
+    options.ack_timeout = 20;
+    std::vector<SensorConfig> plan;
+    for(auto &sensor : sensors) plan.push_back(retuned_config(sensor));
+    auto report = apply_fleet_config(sensors, plan, options);
+
+    EXPECT_EQ(2, report.count(FleetOutcome::applied));
+    EXPECT_EQ(FleetOutcome::failed, report.sensors[1].outcome);
+    EXPECT_EQ(3, report.sensors[1].attempts);
+    EXPECT_EQ(false, report.sensors[1].previous.has_value());
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ld2410_frame_assembler.h"
+#include "ld2410_metrics.h"
+#include "helpers.h"
+
+using namespace ld2410;
+
+// reporting frame with the given movement distance
+static std::vector<uint8_t> assembler_reporting_frame(uint16_t movement_distance) {
+    return {0xF4, 0xF3, 0xF2, 0xF1, 0x0D, 0x00, 0x02, 0xAA,
+        0x01, (uint8_t)movement_distance, (uint8_t)(movement_distance >> 8), 0x20,
+        0x00, 0x00, 0x00, 0x10, 0x00, 0x55, 0x00,
+        0xF8, 0xF7, 0xF6, 0xF5};
+}
+
+class DistanceCollector {
+public:
+    std::vector<uint16_t> distances;
+
+    void operator()(const ReportingDataFrame &frame) {
+        distances.push_back(frame.movement_target_distance());
+    }
+
+    void operator()(const EngineeringModeDataFrame &) {
+        distances.push_back(0xffff);
+    }
+};
+
+TEST(FrameAssemblerTest, FramesSplitAcrossPushes) {
+    std::vector<uint8_t> bytes = assembler_reporting_frame(100);
+    std::vector<uint8_t> second = assembler_reporting_frame(200);
+    bytes.insert(bytes.end(), second.begin(), second.end());
+
+    for(size_t chunk = 1; chunk <= bytes.size(); ++chunk) {
+        FrameAssembler<ReportingDataFrame, EngineeringModeDataFrame> assembler;
+        DistanceCollector collector;
+        for(size_t pos = 0; pos < bytes.size(); pos += chunk) {
+            size_t n = bytes.size() - pos < chunk ? bytes.size() - pos : chunk;
+            assembler.push(bytes.data() + pos, n, collector);
+        }
+
+        EXPECT_EQ(2, collector.distances.size());
+        if (collector.distances.size() != 2) continue;
+        EXPECT_EQ(100, collector.distances[0]);
+        EXPECT_EQ(200, collector.distances[1]);
+        EXPECT_EQ(0, assembler.buffered());
+    }
+}
+
+TEST(FrameAssemblerTest, KeepsIncompleteFrame) {
+    std::vector<uint8_t> bytes = assembler_reporting_frame(100);
+    FrameAssembler<ReportingDataFrame> assembler;
+    DistanceCollector collector;
+
+    EXPECT_EQ(0, assembler.push(bytes.data(), 10, collector));
+    EXPECT_EQ(10, assembler.buffered());
+    EXPECT_EQ(1, assembler.push(bytes.data() + 10, bytes.size() - 10, collector));
+    EXPECT_EQ(0, assembler.buffered());
+}
+
+TEST(FrameAssemblerTest, ResyncsAfterGarbage) {
+    std::vector<uint8_t> bytes{0x00, 0xF4, 0xF3, 0x12, 0xF4};
+    std::vector<uint8_t> broken = assembler_reporting_frame(1);
+    broken[broken.size() - 1] = 0x00;
+    std::vector<uint8_t> good = assembler_reporting_frame(300);
+    bytes.insert(bytes.end(), broken.begin(), broken.end());
+    bytes.insert(bytes.end(), good.begin(), good.end());
+
+    FrameAssembler<ReportingDataFrame> assembler;
+    DistanceCollector collector;
+    DecoderMetrics metrics;
+    EXPECT_EQ(1, assembler.push(bytes.data(), bytes.size(), metrics, collector));
+
+    EXPECT_EQ(1, collector.distances.size());
+    EXPECT_EQ(300, collector.distances[0]);
+#ifdef LD2410_METRICS
+    EXPECT_EQ(1, metrics.snapshot().malformed_frames);
+    // the garbage and the broken frame but its first byte, dropped as malformed
+    EXPECT_EQ(5 + broken.size() - 1, metrics.snapshot().resync_bytes);
+#endif
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ld2410_metrics.h"
+#include "ld2410_packet_reader.h"
+#include "helpers.h"
+
+using namespace ld2410;
+
+static_assert(std::is_trivially_copyable<EngineeringModeDataFrame>::value, "engineering frames can be copied bytewise, e.g. into a BroadcastRing");
+static_assert(std::is_trivially_copyable<ReadParameterCommandAck>::value, "parameter acks can be copied bytewise");
+static_assert(basic_gate_values_t<12>::max_size() == 13, "storage follows the maximum gate count");
+static_assert(gate_values_t::max_size() == LD2410_MAX_GATE_N + 1, "default storage holds LD2410_MAX_GATE_N + 1 gates");
+
+static std::vector<uint8_t> engineering_frame_with_gates(uint8_t moving_gate_n, uint8_t static_gate_n) {
+    std::vector<uint8_t> payload{0x01, 0xAA, 0x01, 0x10, 0x00, 0x20, 0x00, 0x00, 0x00, 0x10, 0x00, moving_gate_n, static_gate_n};
+    for(size_t i = 0; i < (size_t)moving_gate_n + 1 + static_gate_n + 1 && payload.size() < max_frame_data_size; ++i) payload.push_back(i);
+    payload.push_back(0x55);
+    payload.push_back(0x00);
+
+    std::vector<uint8_t> frame{0xF4, 0xF3, 0xF2, 0xF1, (uint8_t)payload.size(), 0x00};
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    frame.insert(frame.end(), {0xF8, 0xF7, 0xF6, 0xF5});
+    return frame;
+}
+
+TEST(GateBoundsTest, AcceptsCountsWithinCapacity) {
+    InMemoryReader r{engineering_frame_with_gates(4, 3)};
+    auto packet = read_from_reader<BasicEngineeringModeDataFrame<4>>(r);
+
+    EXPECT_EQ(true, packet.has_value());
+    if (!packet.has_value()) return;
+    EXPECT_EQ(5, packet->movement_distance_gate_energy_value().size());
+    EXPECT_EQ(4, packet->static_distance_gate_energy_value().size());
+    EXPECT_EQ(4, packet->movement_distance_gate_energy_value()[4]);
+    EXPECT_EQ(5, packet->static_distance_gate_energy_value()[0]);
+}
+
+TEST(GateBoundsTest, RejectsCountsBeyondCapacity) {
+    std::vector<uint8_t> bytes = engineering_frame_with_gates(8, 8);
+    std::vector<uint8_t> next = engineering_frame_with_gates(2, 2);
+    bytes.insert(bytes.end(), next.begin(), next.end());
+    InMemoryReader r{bytes};
+    DecoderMetrics metrics;
+
+    EXPECT_EQ(false, read_from_reader<BasicEngineeringModeDataFrame<4>>(r, metrics).has_value());
+    // decoding goes on with the next frame
+    EXPECT_EQ(true, read_from_reader<BasicEngineeringModeDataFrame<4>>(r, metrics).has_value());
+#ifdef LD2410_METRICS
+    EXPECT_EQ(1, metrics.snapshot().malformed_frames);
+#endif
+}
+
+TEST(GateBoundsTest, StopsReadingAtTheGateCounts) {
+    // gate counts of 255, read() must not touch the gates
+    const uint8_t payload[] = {0x01, 0x10, 0x00, 0x20, 0x00, 0x00, 0x00, 0x10, 0x00, 0xFF, 0xFF, 0x01, 0x02, 0x03};
+    BufferReader r{payload, sizeof(payload)};
+    EngineeringModeDataFrame packet;
+    packet.read(r);
+
+    EXPECT_EQ(11, r.position());
+    EXPECT_EQ(false, packet.within_bounds());
+    EXPECT_EQ(0, packet.movement_distance_gate_energy_value().size());
+}
+
+TEST(GateBoundsTest, ReadParameterCommandAckBounds) {
+    const uint8_t payload[] = {0x00, 0x00, 0xAA, 0x0C, 0x08, 0x08, 0x01, 0x02};
+    BufferReader r{payload, sizeof(payload)};
+    ReadParameterCommandAck packet;
+    packet.read(r);
+
+    EXPECT_EQ(6, r.position());
+    EXPECT_EQ(false, packet.within_bounds());
+}
@@ -6,23 +6,19 @@
 
 #include <gtest/gtest.h>
 
-struct InMemoryReaderState {
-    std::vector<uint8_t> m_data;
-    uint16_t m_index;
-};
-
 class InMemoryReader {
 private:
-    std::shared_ptr<InMemoryReaderState> m_state;
+    std::vector<uint8_t> m_data;
+    uint16_t m_index;
 
 public:
-    InMemoryReader(std::vector<uint8_t> data): m_state(std::make_shared<InMemoryReaderState>(InMemoryReaderState{data, 0})) {
+    InMemoryReader(std::vector<uint8_t> data): m_data(data), m_index(0) {
 
     }
 
     uint8_t operator()() {
-        if (m_state->m_index >= m_state->m_data.size()) return 0;
-        return m_state->m_data[m_state->m_index++];
+        if (m_index >= m_data.size()) return 0;
+        return m_data[m_index++];
     }
 };
 
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <thread>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+#include "ld2410_metrics.h"
+#include "ld2410_packet_write_and_read_ack.h"
+#include "helpers.h"
+
+using namespace ld2410;
+
+#ifdef LD2410_METRICS
+
+TEST(MetricsTest, CountsDecodedFramesPerType) {
+    InMemoryReader r{{0xF4, 0xF3, 0xF2, 0xF1, 0x0D, 0x00, 0x02, 0xAA, 0x02, 0x51, 0x01, 0x00, 0x00, 0x00, 0x3B, 0x00, 0x00, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5,
+        0xF4, 0xF3, 0xF2, 0xF1, 0x0D, 0x00, 0x02, 0xAA, 0x02, 0x51, 0x01, 0x00, 0x00, 0x00, 0x3B, 0x00, 0x00, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5}};
+    DecoderMetrics metrics;
+
+    for(int i = 0; i < 20; ++i) {
+        read_from_reader<EngineeringModeDataFrame, ReportingDataFrame>(r, metrics);
+    }
+
+    auto s = metrics.snapshot();
+    EXPECT_EQ(2, s.frames[packet_kind_index(ReportingDataFrame::definition_type.val.val)]);
+    EXPECT_EQ(0, s.frames[packet_kind_index(EngineeringModeDataFrame::definition_type.val.val)]);
+
+    uint32_t decoded = 0;
+    for(auto count : s.decode_latency_us) decoded += count;
+    EXPECT_EQ(2, decoded);
+}
+
+TEST(MetricsTest, DecodeLatencyExcludesWireTime) {
+    // a slow line, the frame takes at least 23 * 200 us to arrive
+    InMemoryReader data{{0xF4, 0xF3, 0xF2, 0xF1, 0x0D, 0x00, 0x02, 0xAA, 0x02, 0x51, 0x01, 0x00, 0x00, 0x00, 0x3B, 0x00, 0x00, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5}};
+    auto r = [&]() {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        return data();
+    };
+    DecoderMetrics metrics;
+
+    EXPECT_EQ(true, read_from_reader<ReportingDataFrame>(r, metrics).has_value());
+
+    auto s = metrics.snapshot();
+    static_assert(std::is_same<uint64_t, decltype(s.decode_latency_us_sum)>::value, "latency sums must not wrap");
+    EXPECT_EQ(1, s.decode_latency_us[latency_bucket_index(s.decode_latency_us_sum)]);
+    EXPECT_GT(23 * 200, s.decode_latency_us_sum);
+}
+
+TEST(MetricsTest, CountsResyncBytes) {
+    // mfr of the previous frame, a broken header and a frame of an unexpected type
+    InMemoryReader r{{0xF8, 0xF7, 0xF6, 0xF5, 0xF4, 0xF3, 0x00, 0xF4, 0xF3, 0xF2, 0xF1, 0x0D, 0x00, 0x03, 0xAA, 0xAA}};
+    DecoderMetrics metrics;
+
+    for(int i = 0; i < 7; ++i) {
+        read_from_reader<EngineeringModeDataFrame, ReportingDataFrame>(r, metrics);
+    }
+
+    EXPECT_EQ(15, metrics.snapshot().resync_bytes);
+}
+
+TEST(MetricsTest, CountsMalformedFrames) {
+    InMemoryReader r{{0xF4, 0xF3, 0xF2, 0xF1, 0xFF, 0x00, 0x02, 0xAA}};
+    DecoderMetrics metrics;
+
+    EXPECT_EQ(false, read_from_reader<ReportingDataFrame>(r, metrics).has_value());
+    EXPECT_EQ(1, metrics.snapshot().malformed_frames);
+}
+
+TEST(MetricsTest, AckLatencyAndTimeouts) {
+    class NullWriter {
+    public:
+        void operator()(const uint8_t *, size_t) {}
+    } w;
+    InMemoryReader r{{0xFD, 0xFC, 0xFB, 0xFA, 0x04, 0x00, 0xFE, 0x01, 0x00, 0x00, 0x04, 0x03, 0x02, 0x01}};
+    DecoderMetrics metrics;
+
+    EXPECT_EQ(true, write_and_read_ack(w, r, EndConfigurationCommand{}, 100, metrics).has_value());
+    EXPECT_EQ(false, write_and_read_ack(w, r, EndConfigurationCommand{}, 10, metrics).has_value());
+
+    auto s = metrics.snapshot();
+    EXPECT_EQ(1, s.ack_timeouts);
+    EXPECT_EQ(1, s.ack_latency_ms[0] + s.ack_latency_ms[1]);
+    EXPECT_EQ(1, s.frames[packet_kind_index(EndConfigurationCommandAck::definition_type.val.val)]);
+}
+
+#else
+
+TEST(MetricsTest, CompiledOut) {
+    static_assert(std::is_empty<DecoderMetrics>::value, "metrics must not take space when compiled out");
+    DecoderMetrics metrics;
+    EXPECT_EQ(0, metrics.snapshot().resync_bytes);
+}
+
+#endif
+
+TEST(MetricsTest, LatencyBuckets) {
+    EXPECT_EQ(0, latency_bucket_index(0));
+    EXPECT_EQ(1, latency_bucket_index(1));
+    EXPECT_EQ(2, latency_bucket_index(3));
+    EXPECT_EQ(3, latency_bucket_index(4));
+    EXPECT_EQ(latency_bucket_count - 1, latency_bucket_index(0xffffffff));
+    EXPECT_EQ(7, latency_bucket_upper_bound(3));
+}
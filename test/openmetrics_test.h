@@ -0,0 +1,84 @@
+#pragma once
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include "ld2410_openmetrics.h"
+#include "simulated_sensor.h"
+
+using namespace ld2410;
+
+inline bool has_line(const std::string &text, const std::string &line) {
+    return text.find("\n" + line + "\n") != std::string::npos;
+}
+
+TEST(OpenMetricsTest, RendersLastFrameWithoutDecoderMetrics) {
+    ReportingDataFrame frame;
+    frame.target_state(2);
+    frame.detection_distance(150);
+
+    SensorMetricsView sensor;
+    sensor.name = "hall \"1\"";
+    sensor.reporting = &frame;
+
+    char buffer[4096];
+    size_t size = render_openmetrics(&sensor, 1, buffer, sizeof(buffer));
+    std::string text{buffer};
+
+    EXPECT_EQ(text.size(), size);
+    EXPECT_EQ(true, has_line(text, "ld2410_target_state{sensor=\"hall \\\"1\\\"\"} 2"));
+    EXPECT_EQ(true, has_line(text, "ld2410_detection_distance_centimeters{sensor=\"hall \\\"1\\\"\"} 150"));
+    EXPECT_EQ(std::string::npos, text.find("ld2410_frames_total"));
+    EXPECT_EQ(std::string::npos, text.find("ld2410_movement_gate_energy{"));
+    EXPECT_EQ("# EOF\n", text.substr(text.size() - 6));
+}
+
+TEST(OpenMetricsTest, RendersSimulatedSensorStream) {
+    SimulatedSensor simulated;
+    simulated.engineering_mode = true;
+    auto r = simulated.reader();
+    DecoderMetrics metrics;
+    std::optional<EngineeringModeDataFrame> last;
+
+    for(int i = 0; i < 200; ++i) {
+        auto frame = read_from_reader<EngineeringModeDataFrame>(r, metrics);
+        if (frame.has_value()) last = frame;
+    }
+    ASSERT_EQ(true, last.has_value());
+
+    auto snapshot = metrics.snapshot();
+    SensorMetricsView sensors[2];
+    sensors[0].name = "desk";
+    sensors[0].decoder = &snapshot;
+    sensors[0].engineering = &*last;
+    sensors[1].name = "door";
+
+    char buffer[16384];
+    size_t size = render_openmetrics(sensors, 2, buffer, sizeof(buffer));
+    std::string text{buffer};
+    EXPECT_EQ(text.size(), size);
+
+    EXPECT_EQ(0, text.find("# TYPE ld2410_frames counter\n"));
+    EXPECT_EQ(true, has_line(text, "ld2410_movement_target_distance_centimeters{sensor=\"desk\"} 120"));
+    EXPECT_EQ(true, has_line(text, "ld2410_movement_gate_energy{sensor=\"desk\",gate=\"0\"} 60"));
+    EXPECT_EQ(true, has_line(text, "ld2410_static_gate_energy{sensor=\"desk\",gate=\"2\"} 57"));
+    EXPECT_EQ(std::string::npos, text.find("sensor=\"door\""));
+#ifdef LD2410_METRICS
+    std::string frames = std::to_string(snapshot.frames[packet_kind_index(0xaa01)]);
+    EXPECT_NE("0", frames);
+    EXPECT_EQ(true, has_line(text, "ld2410_frames_total{sensor=\"desk\",type=\"engineering_mode_data_frame\"} " + frames));
+    EXPECT_EQ(true, has_line(text, "ld2410_decode_latency_microseconds_bucket{sensor=\"desk\",le=\"+Inf\"} " + frames));
+    EXPECT_EQ(true, has_line(text, "ld2410_decode_latency_microseconds_count{sensor=\"desk\"} " + frames));
+    EXPECT_EQ(true, has_line(text, "ld2410_resync_bytes_total{sensor=\"desk\"} " + std::to_string(snapshot.resync_bytes)));
+#endif
+}
+
+TEST(OpenMetricsTest, BufferTooSmall) {
+    ReportingDataFrame frame;
+    SensorMetricsView sensor;
+    sensor.reporting = &frame;
+
+    char buffer[64];
+    EXPECT_EQ(0, render_openmetrics(&sensor, 1, buffer, sizeof(buffer)));
+    EXPECT_GT(sizeof(buffer), std::string{buffer}.size());
+}
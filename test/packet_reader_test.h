@@ -26,6 +26,13 @@ TEST(PacketReaderTest, ThreeCompileCheck) {
     ld2410::read_from_reader<ld2410::EngineeringModeDataFrame, ld2410::ReportingDataFrame, ReadParameterCommandAck>(r);
 }
 
+TEST(PacketReaderTest, TypeErasedReader) {
+    InMemoryReader r{{0xFD, 0xFC, 0xFB, 0xFA, 0x04, 0x00, 0xFE, 0x01, 0x00, 0x00, 0x04, 0x03, 0x02, 0x01}};
+    std::function<uint8_t()> erased = std::ref(r);
+    auto packet = ld2410::read_from_reader<ld2410::EndConfigurationCommandAck>(erased);
+    EXPECT_EQ(true, packet.has_value());
+}
+
 TEST(PacketReaderTest, ReadReportingDataFrame) {
     InMemoryReader r{{0xF4, 0xF3, 0xF2, 0xF1, 0x0D, 0x00, 0x02, 0xAA, 0x02, 0x51, 0x01, 0x00, 0x00, 0x00, 0x3B, 0x00, 0x00, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5}};
     auto packet = ld2410::read_from_reader<ld2410::EngineeringModeDataFrame, ld2410::ReportingDataFrame>(r);
@@ -111,7 +118,7 @@ TEST(PacketReaderTest, MaximumDistanceGateandUnmannedDurationParameterConfigurat
 }
 
 TEST(PacketReaderTest, ReadParameterCommandAck) {
-    InMemoryReader r{{0xFD, 0xFC, 0xFB, 0xFA, 0x18, 0x00, 0x61, 0x01, 0xaa, 0x08, 0x08, 0x08, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x19, 0x19, 0x19, 0x19, 0x19, 0x19, 0x19, 0x19, 0x19, 0x01, 0x00, 0x04, 0x03, 0x02, 0x01}};
+    InMemoryReader r{{0xFD, 0xFC, 0xFB, 0xFA, 0x1C, 0x00, 0x61, 0x01, 0x00, 0x00, 0xaa, 0x08, 0x08, 0x08, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x19, 0x19, 0x19, 0x19, 0x19, 0x19, 0x19, 0x19, 0x19, 0x01, 0x00, 0x04, 0x03, 0x02, 0x01}};
     auto packet = ld2410::read_from_reader<ld2410::ReadParameterCommandAck>(r);
     EXPECT_EQ(true, packet.has_value());
     if (!packet.has_value()) return;
@@ -172,7 +179,7 @@ TEST(PacketReaderTest, RangeSensitivityConfigurationCommandAck) {
 }
 
 TEST(PacketReaderTest, ReadFirmwareVersionCommandAck) {
-    InMemoryReader r{{0xFD, 0xFC, 0xFB, 0xFA, 0x0B, 0x00, 0xA0, 0x01, 0x00, 0x00, 0x02, 0x01, 0x16, 0x24, 0x06, 0x22, 0x04, 0x03, 0x02, 0x01}};
+    InMemoryReader r{{0xFD, 0xFC, 0xFB, 0xFA, 0x0A, 0x00, 0xA0, 0x01, 0x00, 0x00, 0x02, 0x01, 0x16, 0x24, 0x06, 0x22, 0x04, 0x03, 0x02, 0x01}};
     auto packet = ld2410::read_from_reader<ld2410::ReadFirmwareVersionCommandAck>(r);
     EXPECT_EQ(true, packet.has_value());
     if (!packet.has_value()) return;
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ld2410_packet_views.h"
+
+using namespace ld2410;
+
+static_assert(ReportingDataFrameLayout::offset<1> == 1, "movement_target_distance follows target_state");
+static_assert(ReportingDataFrameLayout::offset<5> == 7, "detection_distance starts at byte 7");
+static_assert(ReportingDataFrameLayout::size == 11, "a reporting frame has 11 payload bytes");
+static_assert(EngineeringModeDataFrameLayout::size == 11, "gate energies start at byte 11");
+
+static RawFrame raw_frame_of(const std::vector<uint8_t> &bytes) {
+    BufferReader r{bytes.data(), bytes.size()};
+    return *read_raw_frame<ReportingDataFrame, EngineeringModeDataFrame>(r);
+}
+
+TEST(PacketViewsTest, ReportingDataFrameView) {
+    const std::vector<uint8_t> bytes{0xF4, 0xF3, 0xF2, 0xF1, 0x0D, 0x00, 0x02, 0xAA, 0x02, 0x51, 0x01, 0x00, 0x00, 0x00, 0x3B, 0x00, 0x00, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5};
+    RawFrame raw = raw_frame_of(bytes);
+    ReportingDataFrameView view{raw};
+    auto packet = raw.decode<ReportingDataFrame>();
+
+    EXPECT_EQ(true, view.valid());
+    EXPECT_EQ(packet.target_state(), view.target_state());
+    EXPECT_EQ(packet.movement_target_distance(), view.movement_target_distance());
+    EXPECT_EQ(packet.exercise_target_energy_value(), view.exercise_target_energy_value());
+    EXPECT_EQ(packet.stationary_target_distance(), view.stationary_target_distance());
+    EXPECT_EQ(packet.stationary_target_energy_value(), view.stationary_target_energy_value());
+    EXPECT_EQ(packet.detection_distance(), view.detection_distance());
+    EXPECT_EQ(packet.tail(), view.tail());
+    EXPECT_EQ(packet.check(), view.check());
+}
+
+TEST(PacketViewsTest, EngineeringModeDataFrameView) {
+    const std::vector<uint8_t> bytes{0xF4, 0xF3, 0xF2, 0xF1, 0x23, 0x00, 0x01, 0xAA, 0x03, 0x1E, 0x00, 0x3C, 0x00, 0x00, 0x39, 0x00, 0x00, 0x08, 0x08, 0x3C, 0x22, 0x05, 0x03, 0x03, 0x04, 0x03, 0x06, 0x05, 0x00, 0x00, 0x39, 0x10, 0x13, 0x06, 0x06, 0x08, 0x04, 0x03, 0x05, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5};
+    RawFrame raw = raw_frame_of(bytes);
+    EngineeringModeDataFrameView view{raw};
+    auto packet = raw.decode<EngineeringModeDataFrame>();
+
+    EXPECT_EQ(true, view.valid());
+    EXPECT_EQ(packet.target_state(), view.target_state());
+    EXPECT_EQ(packet.movement_target_distance(), view.movement_target_distance());
+    EXPECT_EQ(packet.stationary_target_energy_value(), view.stationary_target_energy_value());
+    EXPECT_EQ(packet.maximum_moving_distance_gate_n(), view.maximum_moving_distance_gate_n());
+    EXPECT_EQ(packet.maximum_static_distance_gate_n(), view.maximum_static_distance_gate_n());
+    EXPECT_EQ(packet.movement_distance_gate_energy_value().size(), view.movement_gate_count());
+    EXPECT_EQ(packet.static_distance_gate_energy_value().size(), view.static_gate_count());
+    for(size_t gate = 0; gate < view.movement_gate_count(); ++gate) {
+        EXPECT_EQ(packet.movement_distance_gate_energy_value()[gate], view.movement_distance_gate_energy_value(gate));
+    }
+    for(size_t gate = 0; gate < view.static_gate_count(); ++gate) {
+        EXPECT_EQ(packet.static_distance_gate_energy_value()[gate], view.static_distance_gate_energy_value(gate));
+    }
+}
+
+TEST(PacketViewsTest, ShortPayloadIsInvalid) {
+    const uint8_t payload[] = {0x01, 0x10, 0x00, 0x20, 0x00, 0x00, 0x00, 0x10, 0x00, 0x08, 0x08, 0x01, 0x02};
+
+    EXPECT_EQ(false, ReportingDataFrameView(payload, 9).valid());
+    EXPECT_EQ(true, ReportingDataFrameView(payload, 11).valid());
+    // the gate counts announce 18 gate energies
+    EXPECT_EQ(false, EngineeringModeDataFrameView(payload, sizeof(payload)).valid());
+}
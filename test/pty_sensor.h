@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "raw_pty.h"
+#include "simulated_sensor.h"
+
+// A SimulatedSensor behind a pty, played by PtySensorServer. The host side
+// reads like a serial port with a short timeout, 0 if nothing arrived.
+class PtySensorPort {
+    uint8_t m_buffer[64];
+    size_t m_size = 0;
+    size_t m_position = 0;
+
+public:
+    RawPty pty;
+    // the sensor is shared with the server thread
+    std::mutex mutex;
+    SimulatedSensor sensor;
+    std::chrono::steady_clock::time_point next_report;
+
+    auto writer() {
+        return [this](const uint8_t *data, size_t size) {
+            if (::write(pty.master, data, size) < 0) return;
+        };
+    }
+
+    auto reader() {
+        return [this]() -> uint8_t {
+            if (m_position == m_size) {
+                pollfd fd{pty.master, POLLIN, 0};
+                ssize_t n = ::poll(&fd, 1, 1) == 1 ? ::read(pty.master, m_buffer, sizeof(m_buffer)) : 0;
+                m_size = n > 0 ? n : 0;
+                m_position = 0;
+                if (m_size == 0) return 0;
+            }
+            return m_buffer[m_position++];
+        };
+    }
+
+    // the rate of the line is out of band, the sensor garbles bytes sent at another one
+    void set_local_baud(uint32_t bps) {
+        std::lock_guard<std::mutex> lock(mutex);
+        sensor.set_local_baud(bps);
+    }
+};
+
+// Plays all sensors on one thread at the pace of real modules: commands are
+// answered at once, reports go out every 100 ms unless in configuration mode.
+class PtySensorServer {
+    std::deque<PtySensorPort> &m_ports;
+    std::atomic<bool> m_running{true};
+    std::thread m_thread;
+
+    void serve(PtySensorPort &port, std::chrono::steady_clock::time_point now) {
+        uint8_t input[256];
+        ssize_t n = ::read(port.pty.slave, input, sizeof(input));
+        std::vector<uint8_t> output;
+        {
+            std::lock_guard<std::mutex> lock(port.mutex);
+            if (n > 0) port.sensor.write(input, n);
+
+            bool reporting = !port.sensor.config_mode && !port.sensor.hung;
+            if (reporting && port.sensor.pending() == 0 && now >= port.next_report) {
+                // queues the next report
+                output.push_back(port.sensor.read());
+                port.next_report = now + std::chrono::milliseconds(100);
+            }
+            while(port.sensor.pending() != 0) {
+                output.push_back(port.sensor.read());
+            }
+        }
+        if (!output.empty() && ::write(port.pty.slave, output.data(), output.size()) < 0) return;
+    }
+
+public:
+    explicit PtySensorServer(std::deque<PtySensorPort> &ports): m_ports(ports) {
+        auto now = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < m_ports.size(); ++i) {
+            int flags = fcntl(m_ports[i].pty.slave, F_GETFL);
+            fcntl(m_ports[i].pty.slave, F_SETFL, flags | O_NONBLOCK);
+            // the modules were powered up at different times
+            m_ports[i].next_report = now + std::chrono::milliseconds(i * 37 % 100);
+        }
+
+        m_thread = std::thread([this]() {
+            while(m_running) {
+                auto now = std::chrono::steady_clock::now();
+                for(auto &port : m_ports) {
+                    serve(port, now);
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+
+    ~PtySensorServer() {
+        m_running = false;
+        m_thread.join();
+    }
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+// A pseudo terminal in raw mode, the transport reads the master side while
+// the test plays the sensor on the slave side.
+class RawPty {
+public:
+    int master = -1;
+    int slave = -1;
+
+    RawPty() {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) return;
+        slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+
+        termios tio;
+        if (slave >= 0 && tcgetattr(slave, &tio) == 0) {
+            cfmakeraw(&tio);
+            tcsetattr(slave, TCSANOW, &tio);
+        }
+    }
+
+    ~RawPty() {
+        if (slave >= 0) close(slave);
+        if (master >= 0) close(master);
+    }
+
+    bool valid() const {
+        return master >= 0 && slave >= 0;
+    }
+};
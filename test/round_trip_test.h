@@ -0,0 +1,273 @@
+#pragma once
+
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ld2410_packet_reader.h"
+#include "ld2410_packet_writer.h"
+#include "helpers.h"
+
+using namespace ld2410;
+
+class XorShiftRandom {
+    uint32_t m_state;
+
+public:
+    explicit XorShiftRandom(uint32_t seed): m_state(seed) {
+
+    }
+
+    uint8_t operator()() {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state;
+    }
+};
+
+class CountingReader {
+    BufferReader m_reader;
+
+public:
+    size_t reads = 0;
+
+    CountingReader(const uint8_t *data, size_t size): m_reader(data, size) {
+
+    }
+
+    uint8_t operator()() {
+        ++reads;
+        return m_reader();
+    }
+};
+
+// a packet with random field values and consistent gate counts
+template <typename T>
+T random_packet(XorShiftRandom &random) {
+    std::vector<uint8_t> data(max_frame_data_size);
+    for(auto &b : data) b = random();
+
+    if (std::is_same<T, EngineeringModeDataFrame>::value) {
+        data[9] = data[9] % (LD2410_MAX_GATE_N + 1);
+        data[10] = data[10] % (LD2410_MAX_GATE_N + 1);
+    }
+    if (std::is_same<T, ReadParameterCommandAck>::value) {
+        data[3] = data[3] % (LD2410_MAX_GATE_N + 1);
+    }
+
+    BufferReader r{data.data(), data.size()};
+    T packet;
+    packet.read(r);
+    return packet;
+}
+
+// Values and wire bytes of the fields visit_fields() reports, in order.
+class VisitedFields {
+    template <typename V>
+    void field(V v) {
+        uint32_t value = (uint32_t)v;
+        values.push_back(value);
+        for(size_t i = 0; i < sizeof(V); ++i) {
+            bytes.push_back(value >> (8 * i));
+        }
+    }
+
+    template <typename V, std::size_t capacity>
+    void field(const InlineVector<V, capacity> &v) {
+        for(size_t i = 0; i < v.size(); ++i) {
+            field(v[i]);
+        }
+    }
+
+public:
+    std::vector<uint32_t> values;
+    std::vector<uint8_t> bytes;
+
+    template <typename V>
+    void operator()(const char *, const V &v) {
+        field(v);
+    }
+};
+
+// written after the visited fields, only framing
+template <typename T>
+size_t unvisited_trailer_size() {
+    return std::is_same<T, ReportingDataFrame>::value ? 2 : 0;
+}
+
+// visit_fields() reports the fields write() writes, in the same order, and
+// read() restores them from those bytes
+template <typename T>
+void expect_visited_fields_match_wire(const T &packet) {
+    InMemoryWriter written;
+    packet.write(written);
+    VisitedFields visited;
+    packet.visit_fields(visited);
+
+    ASSERT_EQ(written.m_data.size(), visited.bytes.size() + unvisited_trailer_size<T>());
+    std::vector<uint8_t> data = visited.bytes;
+    data.insert(data.end(), written.m_data.begin() + visited.bytes.size(), written.m_data.end());
+    expect_same_vector(written.m_data, data);
+
+    BufferReader r{data.data(), data.size()};
+    T decoded{};
+    decoded.read(r);
+    VisitedFields revisited;
+    decoded.visit_fields(revisited);
+    EXPECT_EQ(visited.values, revisited.values);
+}
+
+template <typename T>
+void expect_round_trip(uint32_t seed) {
+    XorShiftRandom random{seed};
+
+    for(int i = 0; i < 50; ++i) {
+        T packet = random_packet<T>(random);
+        expect_visited_fields_match_wire(packet);
+
+        InMemoryWriter encoded;
+        write_to_writer(encoded, packet);
+        EXPECT_EQ(internal_helpers::frame_overhead + sizeof(uint16_t) + packet.size(), encoded.m_data.size());
+
+        CountingReader r{encoded.m_data.data(), encoded.m_data.size()};
+        auto decoded = read_from_reader<T>(r);
+        EXPECT_EQ(true, decoded.has_value());
+        EXPECT_EQ(encoded.m_data.size(), r.reads);
+        if (!decoded.has_value()) return;
+
+        InMemoryWriter reencoded;
+        write_to_writer(reencoded, *decoded);
+        expect_same_vector(encoded.m_data, reencoded.m_data);
+    }
+}
+
+TEST(RoundTripTest, EngineeringModeDataFrame) {
+    expect_round_trip<EngineeringModeDataFrame>(1);
+}
+
+TEST(RoundTripTest, ReportingDataFrame) {
+    expect_round_trip<ReportingDataFrame>(2);
+}
+
+TEST(RoundTripTest, EnableConfigurationCommandAck) {
+    expect_round_trip<EnableConfigurationCommandAck>(3);
+}
+
+TEST(RoundTripTest, EnableConfigurationCommand) {
+    expect_round_trip<EnableConfigurationCommand>(4);
+}
+
+TEST(RoundTripTest, EndConfigurationCommandAck) {
+    expect_round_trip<EndConfigurationCommandAck>(5);
+}
+
+TEST(RoundTripTest, EndConfigurationCommand) {
+    expect_round_trip<EndConfigurationCommand>(6);
+}
+
+TEST(RoundTripTest, MaximumDistanceGateandUnmannedDurationParameterConfigurationCommandAck) {
+    expect_round_trip<MaximumDistanceGateandUnmannedDurationParameterConfigurationCommandAck>(7);
+}
+
+TEST(RoundTripTest, MaximumDistanceGateandUnmannedDurationParameterConfigurationCommand) {
+    expect_round_trip<MaximumDistanceGateandUnmannedDurationParameterConfigurationCommand>(8);
+}
+
+TEST(RoundTripTest, ReadParameterCommandAck) {
+    expect_round_trip<ReadParameterCommandAck>(9);
+}
+
+TEST(RoundTripTest, ReadParameterCommand) {
+    expect_round_trip<ReadParameterCommand>(10);
+}
+
+TEST(RoundTripTest, EnableEngineeringModeCommandAck) {
+    expect_round_trip<EnableEngineeringModeCommandAck>(11);
+}
+
+TEST(RoundTripTest, EnableEngineeringModeCommand) {
+    expect_round_trip<EnableEngineeringModeCommand>(12);
+}
+
+TEST(RoundTripTest, CloseEngineeringModeCommandAck) {
+    expect_round_trip<CloseEngineeringModeCommandAck>(13);
+}
+
+TEST(RoundTripTest, CloseEngineeringModeCommand) {
+    expect_round_trip<CloseEngineeringModeCommand>(14);
+}
+
+TEST(RoundTripTest, RangeSensitivityConfigurationCommandAck) {
+    expect_round_trip<RangeSensitivityConfigurationCommandAck>(15);
+}
+
+TEST(RoundTripTest, RangeSensitivityConfigurationCommand) {
+    expect_round_trip<RangeSensitivityConfigurationCommand>(16);
+}
+
+TEST(RoundTripTest, ReadFirmwareVersionCommandAck) {
+    expect_round_trip<ReadFirmwareVersionCommandAck>(17);
+}
+
+TEST(RoundTripTest, ReadFirmwareVersionCommand) {
+    expect_round_trip<ReadFirmwareVersionCommand>(18);
+}
+
+TEST(RoundTripTest, SetSerialPortBaudRateAck) {
+    expect_round_trip<SetSerialPortBaudRateAck>(19);
+}
+
+TEST(RoundTripTest, SetSerialPortBaudRate) {
+    expect_round_trip<SetSerialPortBaudRate>(20);
+}
+
+TEST(RoundTripTest, FactoryResetAck) {
+    expect_round_trip<FactoryResetAck>(21);
+}
+
+TEST(RoundTripTest, FactoryReset) {
+    expect_round_trip<FactoryReset>(22);
+}
+
+TEST(RoundTripTest, RestartModuleAck) {
+    expect_round_trip<RestartModuleAck>(23);
+}
+
+TEST(RoundTripTest, RestartModule) {
+    expect_round_trip<RestartModule>(24);
+}
+
+TEST(RoundTripTest, GarbageNeverReadsPastAFrame) {
+    XorShiftRandom random{4242};
+    std::vector<uint8_t> data(4096);
+    for(auto &b : data) b = random();
+    // plant frame starts so that the slow paths get exercised too
+    for(size_t pos = 0; pos + 8 < data.size(); pos += 97) {
+        const uint8_t start[] = {0xF4, 0xF3, 0xF2, 0xF1, random(), 0x00, 0x01, 0xAA};
+        std::copy(start, start + sizeof(start), data.begin() + pos);
+    }
+
+    CountingReader r{data.data(), data.size()};
+    while(r.reads < data.size()) {
+        size_t before = r.reads;
+        read_from_reader<EngineeringModeDataFrame, ReportingDataFrame, ReadParameterCommandAck>(r);
+        EXPECT_LE(r.reads - before, internal_helpers::frame_overhead + max_frame_data_size);
+    }
+}
+
+TEST(RoundTripTest, GateCountBeyondFrameIsMalformed) {
+    // maximum_moving_distance_gate_n is 255
+    InMemoryReader r{{0xF4, 0xF3, 0xF2, 0xF1, 0x11, 0x00, 0x01, 0xAA, 0x01, 0x10, 0x00, 0x20, 0x00, 0x00, 0x00, 0x10, 0x00, 0xFF, 0x01, 0x20, 0x10, 0x00, 0x00, 0xF8, 0xF7, 0xF6, 0xF5,
+        0xF4, 0xF3, 0xF2, 0xF1, 0x0D, 0x00, 0x02, 0xAA, 0x02, 0x51, 0x01, 0x00, 0x00, 0x00, 0x3B, 0x00, 0x00, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5}};
+
+    EXPECT_EQ(false, (read_from_reader<EngineeringModeDataFrame, ReportingDataFrame>(r).has_value()));
+    // the next frame is intact
+    EXPECT_EQ(true, (read_from_reader<EngineeringModeDataFrame, ReportingDataFrame>(r).has_value()));
+}
+
+TEST(RoundTripTest, MfrMismatchIsMalformed) {
+    InMemoryReader r{{0xFD, 0xFC, 0xFB, 0xFA, 0x04, 0x00, 0xFE, 0x01, 0x00, 0x00, 0x04, 0x03, 0x02, 0x00}};
+
+    EXPECT_EQ(false, read_from_reader<EndConfigurationCommandAck>(r).has_value());
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include "ld2410_packet_writer.h"
+#include "ld2410_serial_transport.h"
+#include "frame_assembler_test.h"
+#include "raw_pty.h"
+
+using namespace ld2410;
+
+template <typename TTransport>
+void expect_transport_round_trip(TTransport &transport) {
+    RawPty first, second;
+    ASSERT_EQ(true, first.valid() && second.valid());
+    ASSERT_EQ(true, transport.init());
+    long a = transport.add(first.master);
+    long b = transport.add(second.master);
+    ASSERT_EQ(0, a);
+    ASSERT_EQ(1, b);
+
+    // commands are queued and written on poll
+    auto writer = transport.writer(b);
+    write_to_writer(writer, EndConfigurationCommand{});
+    transport.poll(0, [](size_t, const uint8_t *, size_t) {});
+
+    uint8_t command[12];
+    InMemoryWriter expected;
+    write_to_writer(expected, EndConfigurationCommand{});
+    ASSERT_EQ((ssize_t)expected.m_data.size(), read(second.slave, command, expected.m_data.size()));
+    expect_same_vector(expected.m_data, std::vector<uint8_t>(command, command + expected.m_data.size()));
+
+    // frames written by both sensors are assembled per sensor
+    std::vector<uint8_t> frame = assembler_reporting_frame(150);
+    ASSERT_EQ(10, ::write(first.slave, frame.data(), 10));
+    ASSERT_EQ((ssize_t)frame.size(), ::write(second.slave, frame.data(), frame.size()));
+    ASSERT_EQ((ssize_t)frame.size() - 10, ::write(first.slave, frame.data() + 10, frame.size() - 10));
+
+    FrameAssembler<ReportingDataFrame> assemblers[2];
+    DistanceCollector collectors[2];
+    for(int i = 0; i < 50 && (collectors[0].distances.empty() || collectors[1].distances.empty()); ++i) {
+        int calls = transport.poll(100, [&](size_t sensor, const uint8_t *data, size_t size) {
+            assemblers[sensor].push(data, size, collectors[sensor]);
+        });
+        ASSERT_NE(-1, calls);
+    }
+
+    for(auto &collector : collectors) {
+        EXPECT_EQ(1, collector.distances.size());
+        if (!collector.distances.empty()) {
+            EXPECT_EQ(150, collector.distances[0]);
+        }
+    }
+}
+
+TEST(SerialTransportTest, Epoll) {
+    EpollSerialTransport transport;
+    expect_transport_round_trip(transport);
+    EXPECT_EQ(false, transport.uses_io_uring());
+}
+
+TEST(SerialTransportTest, EpollReportsReadErrors) {
+    EpollSerialTransport transport;
+    ASSERT_EQ(true, transport.init());
+    RawPty pty;
+    ASSERT_EQ(true, pty.valid());
+    long sensor = transport.add(pty.master);
+
+    // the master side fails with EIO once the slave side is gone
+    close(pty.slave);
+    pty.slave = -1;
+    EXPECT_EQ(-1, transport.poll(100, [](size_t, const uint8_t *, size_t) {}));
+    EXPECT_EQ(EIO, transport.error(sensor));
+    // and is not polled any more
+    EXPECT_EQ(0, transport.poll(0, [](size_t, const uint8_t *, size_t) {}));
+}
+
+TEST(SerialTransportTest, EpollReportsEndOfFile) {
+    EpollSerialTransport transport;
+    ASSERT_EQ(true, transport.init());
+    int pipe_fds[2];
+    ASSERT_EQ(0, pipe(pipe_fds));
+    long sensor = transport.add(pipe_fds[0]);
+
+    // data written before the end is still delivered
+    ASSERT_EQ(3, ::write(pipe_fds[1], "abc", 3));
+    close(pipe_fds[1]);
+    size_t received = 0;
+    int calls = 0;
+    for(int i = 0; i < 10 && calls != -1; ++i) {
+        calls = transport.poll(100, [&](size_t, const uint8_t *, size_t size) { received += size; });
+    }
+    EXPECT_EQ(-1, calls);
+    EXPECT_EQ(3, received);
+    EXPECT_EQ(serial_end_of_file, transport.error(sensor));
+    EXPECT_EQ(0, transport.poll(0, [](size_t, const uint8_t *, size_t) {}));
+
+    close(pipe_fds[0]);
+}
+
+// io_uring if built with liburing and the kernel allows it, epoll otherwise
+TEST(SerialTransportTest, Default) {
+    SerialTransport transport;
+    expect_transport_round_trip(transport);
+}
+
+#ifdef LD2410_HAS_IO_URING
+// a kernel without io_uring skips these, unless the build requires it
+#ifdef LD2410_REQUIRE_IO_URING
+#define LD2410_EXPECT_IO_URING(transport) ASSERT_EQ(true, (transport).init())
+#else
+#define LD2410_EXPECT_IO_URING(transport) if (!(transport).init()) GTEST_SKIP() << "no io_uring with multishot reads"
+#endif
+
+TEST(SerialTransportTest, Uring) {
+    UringSerialTransport transport;
+    LD2410_EXPECT_IO_URING(transport);
+    expect_transport_round_trip(transport);
+    EXPECT_EQ(true, transport.uses_io_uring());
+}
+
+TEST(SerialTransportTest, UringReportsReadErrors) {
+    UringSerialTransport transport;
+    LD2410_EXPECT_IO_URING(transport);
+    RawPty pty;
+    ASSERT_EQ(true, pty.valid());
+    int pipe_fds[2];
+    ASSERT_EQ(0, pipe(pipe_fds));
+
+    // the write end of a pipe can not be read
+    long good = transport.add(pty.master);
+    long bad = transport.add(pipe_fds[1]);
+    ASSERT_EQ(1, bad);
+
+    int calls = 0;
+    for(int i = 0; i < 10 && calls != -1; ++i) {
+        calls = transport.poll(100, [](size_t, const uint8_t *, size_t) {});
+    }
+    EXPECT_EQ(-1, calls);
+    EXPECT_EQ(EBADF, transport.error(bad));
+    EXPECT_EQ(0, transport.error(good));
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+TEST(SerialTransportTest, UringReportsEndOfFile) {
+    UringSerialTransport transport;
+    LD2410_EXPECT_IO_URING(transport);
+    int pipe_fds[2];
+    ASSERT_EQ(0, pipe(pipe_fds));
+    long sensor = transport.add(pipe_fds[0]);
+
+    ASSERT_EQ(3, ::write(pipe_fds[1], "abc", 3));
+    close(pipe_fds[1]);
+    size_t received = 0;
+    int calls = 0;
+    for(int i = 0; i < 10 && calls != -1; ++i) {
+        calls = transport.poll(100, [&](size_t, const uint8_t *, size_t size) { received += size; });
+    }
+    EXPECT_EQ(-1, calls);
+    EXPECT_EQ(3, received);
+    EXPECT_EQ(serial_end_of_file, transport.error(sensor));
+
+    close(pipe_fds[0]);
+}
+#elif defined(LD2410_REQUIRE_IO_URING)
+#error "LD2410_REQUIRE_IO_URING needs liburing 2.6 or newer"
+#endif
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ld2410_serialize.h"
+
+using namespace ld2410;
+
+inline EngineeringModeDataFrame serialize_engineering_frame() {
+    EngineeringModeDataFrame frame{};
+    frame.target_state(3);
+    frame.movement_target_distance(300);
+    frame.exercise_target_energy_value(60);
+    frame.stationary_target_distance(57);
+    frame.stationary_target_energy_value(100);
+    frame.detection_distance(57);
+    frame.maximum_moving_distance_gate_n(2);
+    frame.maximum_static_distance_gate_n(2);
+    frame.movement_distance_gate_energy_value({60, 34, 5});
+    frame.static_distance_gate_energy_value({0, 0, 57});
+    return frame;
+}
+
+inline void append_msgpack_str(std::vector<uint8_t> &out, const std::string &s) {
+    out.push_back(0xa0 | s.size());
+    out.insert(out.end(), s.begin(), s.end());
+}
+
+TEST(SerializeTest, JsonEngineeringModeFrame) {
+    char buffer[512];
+    size_t size = write_json(serialize_engineering_frame(), buffer, sizeof(buffer));
+
+    EXPECT_EQ(std::string{"{\"target_state\":3,\"movement_target_distance\":300,\"exercise_target_energy_value\":60,"
+                          "\"stationary_target_distance\":57,\"stationary_target_energy_value\":100,\"detection_distance\":57,"
+                          "\"maximum_moving_distance_gate_n\":2,\"maximum_static_distance_gate_n\":2,"
+                          "\"movement_distance_gate_energy_value\":[60,34,5],\"static_distance_gate_energy_value\":[0,0,57]}"}, std::string(buffer));
+    EXPECT_EQ(strlen(buffer), size);
+}
+
+TEST(SerializeTest, JsonVariantAndEmptyPacket) {
+    ReportingDataFrame reporting{};
+    reporting.target_state(1);
+    reporting.detection_distance(65535);
+    std::variant<ReportingDataFrame, EngineeringModeDataFrame> packet{reporting};
+
+    char buffer[256];
+    write_json(packet, buffer, sizeof(buffer));
+    EXPECT_EQ(std::string{"{\"target_state\":1,\"movement_target_distance\":0,\"exercise_target_energy_value\":0,"
+                          "\"stationary_target_distance\":0,\"stationary_target_energy_value\":0,\"detection_distance\":65535}"}, std::string(buffer));
+
+    EXPECT_EQ(2, write_json(ReadFirmwareVersionCommand{}, buffer, sizeof(buffer)));
+    EXPECT_EQ(std::string{"{}"}, std::string(buffer));
+}
+
+TEST(SerializeTest, MessagePackUsesShortestIntegers) {
+    ReadFirmwareVersionCommandAck ack{};
+    ack.firmware_type(1);
+    ack.major_version_number(0x0102);
+    ack.minor_version_number(0x12345678);
+
+    std::vector<uint8_t> expected{0x83};
+    append_msgpack_str(expected, "firmware_type");
+    expected.push_back(0x01);
+    append_msgpack_str(expected, "major_version_number");
+    expected.insert(expected.end(), {0xcd, 0x01, 0x02});
+    append_msgpack_str(expected, "minor_version_number");
+    expected.insert(expected.end(), {0xce, 0x12, 0x34, 0x56, 0x78});
+
+    uint8_t buffer[128];
+    size_t size = write_msgpack(ack, buffer, sizeof(buffer));
+    EXPECT_EQ(expected, std::vector<uint8_t>(buffer, buffer + size));
+}
+
+TEST(SerializeTest, MessagePackEngineeringModeFrame) {
+    uint8_t buffer[512];
+    size_t size = write_msgpack(serialize_engineering_frame(), buffer, sizeof(buffer));
+    std::vector<uint8_t> encoded(buffer, buffer + size);
+
+    ASSERT_NE(0, size);
+    EXPECT_EQ(0x8a, encoded[0]);
+
+    // names of 32 characters and more are str8, gate values fixarrays
+    std::string name{"movement_distance_gate_energy_value"};
+    std::vector<uint8_t> gates{0xd9, (uint8_t)name.size()};
+    gates.insert(gates.end(), name.begin(), name.end());
+    gates.insert(gates.end(), {0x93, 0x3c, 0x22, 0x05});
+    EXPECT_NE(encoded.end(), std::search(encoded.begin(), encoded.end(), gates.begin(), gates.end()));
+
+    // movement_target_distance 300 is a uint16
+    std::vector<uint8_t> distance{0xcd, 0x01, 0x2c};
+    EXPECT_NE(encoded.end(), std::search(encoded.begin(), encoded.end(), distance.begin(), distance.end()));
+}
+
+TEST(SerializeTest, ReportsOverflow) {
+    char text[16];
+    EXPECT_EQ(0, write_json(serialize_engineering_frame(), text, sizeof(text)));
+    EXPECT_EQ(15, strlen(text));
+
+    uint8_t bytes[16];
+    EXPECT_EQ(0, write_msgpack(serialize_engineering_frame(), bytes, sizeof(bytes)));
+}
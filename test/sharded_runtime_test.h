@@ -0,0 +1,238 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <poll.h>
+
+#include <gtest/gtest.h>
+#include "ld2410_sharded_runtime.h"
+#include "serial_transport_test.h"
+
+using namespace ld2410;
+
+const size_t runtime_test_sensors = 6;
+
+// counts the frames of every sensor, shared by all shards
+class CountingHandler {
+    std::array<std::atomic<uint32_t>, runtime_test_sensors> *m_counts;
+
+public:
+    explicit CountingHandler(std::array<std::atomic<uint32_t>, runtime_test_sensors> &counts): m_counts(&counts) {
+
+    }
+
+    void operator()(size_t sensor, const ReportingDataFrame &) {
+        (*m_counts)[sensor].fetch_add(1);
+    }
+};
+
+template <typename F>
+static bool wait_until(F condition) {
+    for(int i = 0; i < 200; ++i) {
+        if (condition()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return condition();
+}
+
+static void send_reporting_frames(const RawPty &pty, size_t count) {
+    std::vector<uint8_t> frame = assembler_reporting_frame(100);
+    for(size_t i = 0; i < count; ++i) {
+        ASSERT_EQ((ssize_t)frame.size(), ::write(pty.slave, frame.data(), frame.size()));
+    }
+}
+
+TEST(ShardedRuntimeTest, PlanMovesBusiestSensor) {
+    using internal_helpers::plan_rebalance;
+
+    auto moves = plan_rebalance({100, 100, 0, 10}, {0, 0, 1, 1}, 2, 4);
+    EXPECT_EQ(1, moves.size());
+    if (moves.empty()) return;
+    EXPECT_EQ(0, moves[0].sensor);
+    EXPECT_EQ(0, moves[0].from);
+    EXPECT_EQ(1, moves[0].to);
+
+    // nothing to gain
+    EXPECT_EQ(0, plan_rebalance({50, 50}, {0, 1}, 2, 4).size());
+    EXPECT_EQ(0, plan_rebalance({500, 1}, {0, 1}, 2, 4).size());
+    // removed sensors are ignored
+    EXPECT_EQ(0, plan_rebalance({100, 100}, {internal_helpers::no_shard, 1}, 2, 4).size());
+}
+
+TEST(ShardedRuntimeTest, FramesAndCommandsOfAllShards) {
+    // closed only after the runtime stopped reading them
+    RawPty ptys[runtime_test_sensors];
+    std::array<std::atomic<uint32_t>, runtime_test_sensors> counts{};
+    ShardedRuntimeOptions options;
+    options.shards = 3;
+    ShardedRuntime<CountingHandler, ReportingDataFrame> runtime{CountingHandler{counts}, options};
+    ASSERT_EQ(true, runtime.start());
+    EXPECT_EQ(3, runtime.shards());
+
+    for(size_t i = 0; i < runtime_test_sensors; ++i) {
+        ASSERT_EQ(true, ptys[i].valid());
+        EXPECT_EQ((long)i, runtime.add(ptys[i].master));
+        EXPECT_EQ(i % 3, runtime.shard_of(i));
+    }
+
+    for(size_t i = 0; i < runtime_test_sensors; ++i) {
+        send_reporting_frames(ptys[i], i + 1);
+    }
+    EXPECT_EQ(true, wait_until([&]() {
+        for(size_t i = 0; i < runtime_test_sensors; ++i) {
+            if (counts[i] != i + 1) return false;
+        }
+        return true;
+    }));
+    EXPECT_EQ(4, runtime.frames(3));
+
+    auto writer = runtime.writer(4);
+    write_to_writer(writer, EndConfigurationCommand{});
+    InMemoryWriter expected;
+    write_to_writer(expected, EndConfigurationCommand{});
+    // the shard may flush before the whole command was queued
+    std::vector<uint8_t> command(expected.m_data.size());
+    for(size_t n = 0; n < command.size();) {
+        ssize_t r = read(ptys[4].slave, command.data() + n, command.size() - n);
+        ASSERT_LT(0, r);
+        n += r;
+    }
+    expect_same_vector(expected.m_data, command);
+}
+
+TEST(ShardedRuntimeTest, RebalanceMovesBusySensor) {
+    RawPty ptys[4];
+    std::array<std::atomic<uint32_t>, runtime_test_sensors> counts{};
+    ShardedRuntimeOptions options;
+    options.shards = 2;
+    options.pin_threads = false;
+    ShardedRuntime<CountingHandler, ReportingDataFrame> runtime{CountingHandler{counts}, options};
+    ASSERT_EQ(true, runtime.start());
+
+    // sensors 0 and 2 end up on shard 0 and are the only busy ones
+    for(auto &pty : ptys) {
+        runtime.add(pty.master);
+    }
+    send_reporting_frames(ptys[0], 10);
+    send_reporting_frames(ptys[2], 10);
+    ASSERT_EQ(true, wait_until([&]() { return counts[0] == 10 && counts[2] == 10; }));
+
+    auto moves = runtime.rebalance();
+    EXPECT_EQ(1, moves.size());
+    EXPECT_EQ(1, runtime.shard_of(0));
+    EXPECT_EQ(0, runtime.shard_of(2));
+
+    // the moved sensor is read by its new shard
+    send_reporting_frames(ptys[0], 5);
+    EXPECT_EQ(true, wait_until([&]() { return counts[0] == 15; }));
+    EXPECT_EQ(0, runtime.rebalance().size());
+
+    runtime.remove(0);
+    EXPECT_EQ(internal_helpers::no_shard, runtime.shard_of(0));
+    send_reporting_frames(ptys[0], 1);
+    send_reporting_frames(ptys[2], 1);
+    EXPECT_EQ(true, wait_until([&]() { return counts[2] == 11; }));
+    EXPECT_EQ(15, counts[0]);
+}
+
+TEST(ShardedRuntimeTest, AddNeedsRunningShards) {
+    RawPty pty;
+    ASSERT_EQ(true, pty.valid());
+    std::array<std::atomic<uint32_t>, runtime_test_sensors> counts{};
+    ShardedRuntimeOptions options;
+    options.shards = 2;
+    ShardedRuntime<CountingHandler, ReportingDataFrame> runtime{CountingHandler{counts}, options};
+
+    EXPECT_EQ(-1, runtime.add(pty.master));
+    ASSERT_EQ(true, runtime.start());
+    EXPECT_EQ(0, runtime.add(pty.master));
+
+    // stopping removes every sensor
+    runtime.stop();
+    EXPECT_EQ(internal_helpers::no_shard, runtime.shard_of(0));
+    EXPECT_EQ(-1, runtime.add(pty.master));
+    EXPECT_EQ(0, runtime.rebalance().size());
+    runtime.remove(0);
+}
+
+TEST(ShardedRuntimeTest, AddReportsPortTheShardCannotRead) {
+    RawPty pty;
+    ASSERT_EQ(true, pty.valid());
+    std::array<std::atomic<uint32_t>, runtime_test_sensors> counts{};
+    ShardedRuntimeOptions options;
+    options.shards = 1;
+    ShardedRuntime<CountingHandler, ReportingDataFrame> runtime{CountingHandler{counts}, options};
+    ASSERT_EQ(true, runtime.start());
+
+    EXPECT_EQ(-1, runtime.add(-1));
+    EXPECT_EQ(internal_helpers::no_shard, runtime.shard_of(0));
+    EXPECT_EQ(1, runtime.add(pty.master));
+    EXPECT_EQ(0, runtime.shard_of(1));
+}
+
+// counts the frames the handler gets besides matched acks
+class AnyFrameHandler {
+    std::atomic<uint32_t> *m_frames;
+
+public:
+    explicit AnyFrameHandler(std::atomic<uint32_t> &frames): m_frames(&frames) {
+
+    }
+
+    template <typename TFrame>
+    void operator()(size_t, const TFrame &) {
+        m_frames->fetch_add(1);
+    }
+};
+
+TEST(ShardedRuntimeTest, CommandsAreAnsweredByTheirShard) {
+    RawPty pty;
+    ASSERT_EQ(true, pty.valid());
+    std::atomic<uint32_t> frames{0};
+    ShardedRuntimeOptions options;
+    options.shards = 2;
+    options.pin_threads = false;
+    ShardedRuntime<AnyFrameHandler, ReportingDataFrame, EndConfigurationCommandAck> runtime{AnyFrameHandler{frames}, options};
+    ASSERT_EQ(true, runtime.start());
+    ASSERT_EQ(0, runtime.add(pty.master));
+
+    // 1 acked, 0 timed out, -1 not yet
+    std::atomic<int> first{-1}, second{-1};
+    auto remember = [](std::atomic<int> &outcome) {
+        return [&outcome](size_t, std::optional<EndConfigurationCommandAck> ack) { outcome = ack.has_value() ? 1 : 0; };
+    };
+    ASSERT_EQ(true, runtime.command(0, EndConfigurationCommand{}, remember(first), 1000));
+    ASSERT_EQ(true, runtime.command(0, EndConfigurationCommand{}, remember(second), 20));
+
+    // only the first command is written until it is answered
+    InMemoryWriter expected;
+    write_to_writer(expected, EndConfigurationCommand{});
+    std::vector<uint8_t> command(expected.m_data.size());
+    for(size_t n = 0; n < command.size();) {
+        ssize_t r = read(pty.slave, command.data() + n, command.size() - n);
+        ASSERT_LT(0, r);
+        n += r;
+    }
+    expect_same_vector(expected.m_data, command);
+    pollfd more{pty.slave, POLLIN, 0};
+    EXPECT_EQ(0, ::poll(&more, 1, 50));
+    EXPECT_EQ(-1, first);
+
+    InMemoryWriter ack;
+    write_to_writer(ack, EndConfigurationCommandAck{});
+    send_reporting_frames(pty, 1);
+    ASSERT_EQ((ssize_t)ack.m_data.size(), ::write(pty.slave, ack.m_data.data(), ack.m_data.size()));
+    EXPECT_EQ(true, wait_until([&]() { return first == 1; }));
+
+    // the second one follows and is never answered
+    EXPECT_EQ(1, ::poll(&more, 1, 1000));
+    EXPECT_EQ((ssize_t)command.size(), read(pty.slave, command.data(), command.size()));
+    EXPECT_EQ(true, wait_until([&]() { return second == 0; }));
+    EXPECT_EQ(1, frames);
+
+    runtime.remove(0);
+    EXPECT_EQ(false, runtime.command(0, EndConfigurationCommand{}, remember(first)));
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include "ld2410_shared_frames.h"
+#include "broadcast_ring_test.h"
+#include "subscription_test.h"
+
+using namespace ld2410;
+
+// a shared memory name no other test run uses, removed again on destruction
+class SharedMemoryName {
+    std::string m_name;
+
+public:
+    explicit SharedMemoryName(const char *test): m_name(std::string("/ld2410-test-") + test + "-" + std::to_string(getpid())) {
+
+    }
+
+    ~SharedMemoryName() {
+        shm_unlink(m_name.c_str());
+    }
+
+    const char *c_str() const {
+        return m_name.c_str();
+    }
+};
+
+TEST(SharedFramesTest, ReaderSeesPublishedFrames) {
+    SharedMemoryName name{"latest"};
+    SharedMemory<SharedFrameRegion<2>> publisher, reader;
+    ASSERT_EQ(true, publisher.create(name.c_str()));
+    ASSERT_EQ(true, reader.open(name.c_str()));
+
+    shared_data_frame_t frame;
+    EXPECT_EQ(0, reader->load(0, frame));
+
+    publisher->publish(1, numbered_reporting_frame(7));
+    EXPECT_EQ(0, reader->load(0, frame));
+    EXPECT_EQ(2, reader->load(1, frame));
+    EXPECT_EQ(7, std::get<ReportingDataFrame>(frame).movement_target_distance());
+
+    publisher->publish(1, numbered_reporting_frame(8));
+    EXPECT_EQ(4, reader->load(1, frame));
+    EXPECT_EQ(8, std::get<ReportingDataFrame>(frame).movement_target_distance());
+}
+
+TEST(SharedFramesTest, InPlaceWriterAndReader) {
+    SharedMemoryName name{"in-place"};
+    SharedMemory<SharedFrameRegion<1, 4>> publisher, reader;
+    ASSERT_EQ(true, publisher.create(name.c_str()));
+    ASSERT_EQ(true, reader.open(name.c_str()));
+    auto history = reader->history(0);
+
+    publisher->publish_in_place(0, [](shared_data_frame_t &frame) {
+        frame.emplace<ReportingDataFrame>().movement_target_distance(9);
+    });
+
+    uint16_t distance = 0;
+    EXPECT_EQ(2, reader->read(0, [&](const shared_data_frame_t &frame) {
+        distance = std::get<ReportingDataFrame>(frame).movement_target_distance();
+    }));
+    EXPECT_EQ(9, distance);
+
+    shared_data_frame_t frame;
+    EXPECT_EQ(true, history.read(frame));
+    EXPECT_EQ(9, std::get<ReportingDataFrame>(frame).movement_target_distance());
+}
+
+TEST(SharedFramesTest, OpenRejectsOtherLayout) {
+    SharedMemoryName name{"layout"};
+    SharedMemory<SharedFrameRegion<2>> publisher;
+    SharedMemory<SharedFrameRegion<2, 8>> with_history;
+    SharedMemory<SharedFrameRegion<1>> fewer_sensors;
+    ASSERT_EQ(true, publisher.create(name.c_str()));
+
+    EXPECT_EQ(false, with_history.open(name.c_str()));
+    EXPECT_EQ(false, fewer_sensors.open(name.c_str()));
+    EXPECT_EQ(false, fewer_sensors.mapped());
+    EXPECT_EQ(false, SharedMemory<SharedFrameRegion<1>>{}.open("/ld2410-test-missing"));
+}
+
+TEST(SharedFramesTest, HistoryKeepsEveryFrame) {
+    SharedMemoryName name{"history"};
+    SharedMemory<SharedFrameRegion<1, 4>> publisher, reader;
+    ASSERT_EQ(true, publisher.create(name.c_str()));
+    ASSERT_EQ(true, reader.open(name.c_str()));
+
+    auto history = reader->history(0);
+    for(uint16_t i = 0; i < 6; ++i) {
+        publisher->publish(0, numbered_reporting_frame(i));
+    }
+
+    shared_data_frame_t frame;
+    EXPECT_EQ(true, history.read(frame));
+    EXPECT_EQ(2, std::get<ReportingDataFrame>(frame).movement_target_distance());
+    EXPECT_EQ(2, history.lost());
+    EXPECT_EQ(3, history.pending());
+}
+
+TEST(SharedFramesTest, PublisherObservesDecoder) {
+    SharedMemoryName name{"observer"};
+    SharedMemory<SharedFrameRegion<1>> shm;
+    ASSERT_EQ(true, shm.create(name.c_str()));
+
+    std::vector<uint8_t> bytes;
+    append_reporting_frame(bytes, 2, 300, 45, 310);
+    append_engineering_frame(bytes, 60);
+    InMemoryReader r{bytes};
+    SharedFramePublisher<SharedFrameRegion<1>> publisher{*shm, 0};
+
+    shared_data_frame_t frame;
+    read_from_reader_many<ReportingDataFrame, EngineeringModeDataFrame>(r, publisher);
+    EXPECT_EQ(2, shm->load(0, frame));
+    EXPECT_EQ(300, std::get<ReportingDataFrame>(frame).movement_target_distance());
+
+    read_from_reader_many<ReportingDataFrame, EngineeringModeDataFrame>(r, publisher);
+    EXPECT_EQ(4, shm->load(0, frame));
+    EXPECT_EQ(60, std::get<EngineeringModeDataFrame>(frame).movement_distance_gate_energy_value()[1]);
+}
+
+TEST(SharedFramesTest, AcrossProcesses) {
+    SharedMemoryName name{"fork"};
+    SharedMemory<SharedFrameRegion<1, 64>> publisher;
+    ASSERT_EQ(true, publisher.create(name.c_str()));
+
+    int ready[2];
+    ASSERT_EQ(0, pipe(ready));
+    pid_t child = fork();
+    ASSERT_NE(-1, child);
+    if (child == 0) {
+        SharedMemory<SharedFrameRegion<1, 64>> reader;
+        if (!reader.open(name.c_str())) _exit(1);
+        auto history = reader->history(0);
+        if (write(ready[1], "r", 1) != 1) _exit(1);
+
+        // every frame published from now on arrives in order
+        shared_data_frame_t frame;
+        uint16_t next = 0;
+        while(next < 32) {
+            if (!history.read(frame)) continue;
+            if (std::get<ReportingDataFrame>(frame).movement_target_distance() != next++) _exit(2);
+        }
+        _exit(reader->sequence(0) == 64 ? 0 : 3);
+    }
+
+    char c;
+    ASSERT_EQ(1, read(ready[0], &c, 1));
+    for(uint16_t i = 0; i < 32; ++i) {
+        publisher->publish(0, numbered_reporting_frame(i));
+    }
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    close(ready[0]);
+    close(ready[1]);
+    EXPECT_EQ(true, WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+}
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "ld2410_packets.h"
+
+// Behavioural model of an LD2410 module for host tests. It answers commands
+// like the module does and emits reporting frames whenever the host reads and
+// nothing else is queued. Bytes only arrive intact if the local baud rate set by
+// the test matches the rate of the sensor.
+class SimulatedSensor {
+    std::deque<std::pair<uint8_t, uint32_t>> m_output;
+    std::vector<uint8_t> m_input;
+    uint32_t m_frame_counter = 0;
+
+    uint32_t sensor_bps() const {
+        return ld2410::baud_rate_to_bps(baud);
+    }
+
+    void push(uint8_t b) {
+        m_output.push_back({b, sensor_bps()});
+    }
+
+    void push_u16(uint16_t v) {
+        push(v & 0xff);
+        push(v >> 8);
+    }
+
+    void push_u32(uint32_t v) {
+        push_u16(v & 0xffff);
+        push_u16(v >> 16);
+    }
+
+    void push_ack(uint16_t type, const std::vector<uint8_t> &payload) {
+        push_u32(ld2410::CommandHeader);
+        push_u16(2 + payload.size());
+        push_u16(type);
+        for(uint8_t b : payload) push(b);
+        push_u32(ld2410::CommandMFR);
+    }
+
+    void push_status_ack(uint16_t type) {
+        push_ack(type, {0x00, 0x00});
+    }
+
+    void push_report() {
+        std::vector<uint8_t> frame;
+        auto u16 = [&](uint16_t v) { frame.push_back(v & 0xff); frame.push_back(v >> 8); };
+
+        u16(engineering_mode ? 0xaa01 : 0xaa02);
+        frame.push_back(target_state);
+        u16(movement_distance);
+        frame.push_back(movement_energy);
+        u16(static_distance);
+        frame.push_back(static_energy);
+        u16(detection_distance);
+        if (engineering_mode) {
+            frame.push_back(max_moving_gate);
+            frame.push_back(max_static_gate);
+            for(size_t i = 0; i <= max_moving_gate; ++i) frame.push_back(moving_gate_energy[i]);
+            for(size_t i = 0; i <= max_static_gate; ++i) frame.push_back(static_gate_energy[i]);
+        }
+        frame.push_back(0x55);
+        frame.push_back(0x00);
+
+        ++m_frame_counter;
+        // too fast for the line, every second frame loses a byte
+        bool damaged = sensor_bps() > max_clean_bps && m_frame_counter % 2 == 0;
+        if (damaged) frame.erase(frame.begin() + 4);
+
+        push_u32(ld2410::ReportingDataHeader);
+        push_u16(damaged ? frame.size() + 1 : frame.size());
+        for(uint8_t b : frame) push(b);
+        push_u32(ld2410::ReportingDataMFR);
+        ++frames_sent;
+    }
+
+    static uint16_t u16_at(const std::vector<uint8_t> &data, size_t pos) {
+        return data[pos] | (data[pos + 1] << 8);
+    }
+
+    static uint32_t u32_at(const std::vector<uint8_t> &data, size_t pos) {
+        return u16_at(data, pos) | ((uint32_t)u16_at(data, pos + 2) << 16);
+    }
+
+    void handle_command(uint16_t type, const std::vector<uint8_t> &payload) {
+        received_commands.push_back(type);
+        if (deaf) return;
+
+        if (type == 0x00ff) {
+            if (enable_config_count++ == ignored_enable_config) return;
+            config_mode = true;
+            push_ack(0x01ff, {0x00, 0x00, 0x01, 0x00, 0x40, 0x00});
+            return;
+        }
+        if (!config_mode) return;
+
+        switch(type) {
+            case 0x00fe:
+                config_mode = false;
+                push_status_ack(0x01fe);
+                break;
+            case 0x0060:
+                for(size_t pos = 0; pos + 6 <= payload.size(); pos += 6) {
+                    uint16_t word = u16_at(payload, pos);
+                    uint32_t value = u32_at(payload, pos + 2);
+                    if (word == 0) max_moving_gate = value;
+                    if (word == 1) max_static_gate = value;
+                    if (word == 2) no_one_duration = value;
+                }
+                ++parameter_writes;
+                push_status_ack(0x0160);
+                break;
+            case 0x0061: {
+                std::vector<uint8_t> ack{0x00, 0x00, 0xaa, 8, max_moving_gate, max_static_gate};
+                ack.insert(ack.end(), motion_sensitivity.begin(), motion_sensitivity.end());
+                ack.insert(ack.end(), static_sensitivity.begin(), static_sensitivity.end());
+                ack.push_back(no_one_duration & 0xff);
+                ack.push_back(no_one_duration >> 8);
+                push_ack(0x0161, ack);
+                break;
+            }
+            case 0x0062:
+                engineering_mode = true;
+                push_status_ack(0x0162);
+                break;
+            case 0x0063:
+                engineering_mode = false;
+                push_status_ack(0x0163);
+                break;
+            case 0x0064: {
+                uint32_t gate = u32_at(payload, 2);
+                uint8_t motion = u32_at(payload, 8);
+                uint8_t stationary = u32_at(payload, 14);
+                if ((int)gate == rejected_gate) {
+                    push_ack(0x0164, {0x01, 0x00});
+                    break;
+                }
+                for(size_t i = 0; i < motion_sensitivity.size(); ++i) {
+                    if (gate != 0xffff && gate != i) continue;
+                    motion_sensitivity[i] = motion;
+                    static_sensitivity[i] = stationary;
+                }
+                ++parameter_writes;
+                push_status_ack(0x0164);
+                break;
+            }
+            case 0x00a0:
+                push_ack(0x01a0, {0x00, 0x00, 0x02, 0x01, 0x16, 0x24, 0x06, 0x22});
+                break;
+            case 0x00a1:
+                pending_baud = static_cast<ld2410::BaudRate>(u16_at(payload, 0));
+                push_status_ack(0x01a1);
+                break;
+            case 0x00a2:
+                pending_baud = ld2410::BaudRate::BaudRate_256000;
+                max_moving_gate = 8;
+                max_static_gate = 8;
+                no_one_duration = 5;
+                push_status_ack(0x01a2);
+                break;
+            case 0x00a3:
+                push_status_ack(0x01a3);
+                baud = pending_baud;
+                config_mode = false;
+                hung = false;
+                ++restarts;
+                break;
+        }
+    }
+
+    void parse_input() {
+        while(m_input.size() >= 10) {
+            if (u32_at(m_input, 0) != ld2410::CommandHeader) {
+                m_input.erase(m_input.begin());
+                continue;
+            }
+
+            size_t data_size = u16_at(m_input, 4);
+            if (m_input.size() < 10 + data_size) return;
+
+            std::vector<uint8_t> payload(m_input.begin() + 8, m_input.begin() + 6 + data_size);
+            uint16_t type = u16_at(m_input, 6);
+            m_input.erase(m_input.begin(), m_input.begin() + 10 + data_size);
+            handle_command(type, payload);
+        }
+    }
+
+public:
+    ld2410::BaudRate baud = ld2410::BaudRate::BaudRate_256000;
+    ld2410::BaudRate pending_baud = ld2410::BaudRate::BaudRate_256000;
+    uint32_t local_bps = 256000;
+    uint32_t max_clean_bps = 460800;
+
+    bool config_mode = false;
+    bool engineering_mode = false;
+    // a wedged module still answers commands but stops reporting until restarted
+    bool hung = false;
+    // sensitivity writes for this gate are refused with a failure status
+    int rejected_gate = -1;
+    // the enable configuration command with this index, counted from 0, goes unanswered
+    int ignored_enable_config = -1;
+    // commands are neither answered nor carried out, reports go on
+    bool deaf = false;
+
+    uint8_t max_moving_gate = 8;
+    uint8_t max_static_gate = 8;
+    uint16_t no_one_duration = 5;
+    std::array<uint8_t, 9> motion_sensitivity{50, 50, 40, 30, 20, 15, 15, 15, 15};
+    std::array<uint8_t, 9> static_sensitivity{0, 0, 40, 40, 30, 30, 20, 20, 20};
+
+    uint8_t target_state = 1;
+    uint16_t movement_distance = 120;
+    uint8_t movement_energy = 60;
+    uint16_t static_distance = 0;
+    uint8_t static_energy = 0;
+    uint16_t detection_distance = 120;
+    std::array<uint8_t, 9> moving_gate_energy{60, 34, 5, 3, 3, 4, 3, 6, 5};
+    std::array<uint8_t, 9> static_gate_energy{0, 0, 57, 16, 19, 6, 6, 8, 4};
+
+    size_t frames_sent = 0;
+    size_t parameter_writes = 0;
+    size_t restarts = 0;
+    int enable_config_count = 0;
+    std::vector<uint16_t> received_commands;
+
+    class Reader {
+        SimulatedSensor *m_sensor;
+
+    public:
+        explicit Reader(SimulatedSensor &sensor): m_sensor(&sensor) {
+
+        }
+
+        uint8_t operator()() {
+            return m_sensor->read();
+        }
+    };
+
+    class Writer {
+        SimulatedSensor *m_sensor;
+
+    public:
+        explicit Writer(SimulatedSensor &sensor): m_sensor(&sensor) {
+
+        }
+
+        void operator()(const uint8_t *data, size_t size) {
+            m_sensor->write(data, size);
+        }
+    };
+
+    Reader reader() {
+        return Reader{*this};
+    }
+
+    Writer writer() {
+        return Writer{*this};
+    }
+
+    void set_local_baud(uint32_t bps) {
+        local_bps = bps;
+    }
+
+    // bytes queued for the host, read() adds a report only if there are none
+    size_t pending() const {
+        return m_output.size();
+    }
+
+    uint8_t read() {
+        if (m_output.empty() && !config_mode && !hung) push_report();
+        if (m_output.empty()) return 0;
+
+        auto b = m_output.front();
+        m_output.pop_front();
+        // a byte sent at a different rate arrives as garbage
+        return b.second == local_bps ? b.first : (uint8_t)(b.first ^ 0xa5);
+    }
+
+    void write(const uint8_t *data, size_t size) {
+        if (local_bps != sensor_bps()) return;
+
+        m_input.insert(m_input.end(), data, data + size);
+        parse_input();
+    }
+};
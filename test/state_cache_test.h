@@ -0,0 +1,111 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "ld2410_state_cache.h"
+#include "simulated_sensor.h"
+
+using namespace ld2410;
+
+TEST(StateCacheTest, PopulatesOnce) {
+    SimulatedSensor sensor;
+    auto w = sensor.writer();
+    SensorStateCache cache;
+    EXPECT_EQ(false, cache.populated());
+
+    EXPECT_EQ(true, cache.populate(w, sensor.reader()));
+    EXPECT_EQ((std::vector<uint16_t>{0x00ff, 0x0061, 0x00a0, 0x00fe}), sensor.received_commands);
+    EXPECT_EQ(8, cache.parameters()->maximum_moving_distance_gate);
+    EXPECT_EQ(5, cache.parameters()->no_one_duration);
+    EXPECT_EQ(40, cache.parameters()->static_sensitivity[2]);
+    EXPECT_EQ(0x0102, cache.firmware()->major_version_number());
+    EXPECT_EQ(false, sensor.config_mode);
+
+    // answered from the cache
+    EXPECT_EQ(true, cache.populate(w, sensor.reader()));
+    EXPECT_EQ(4, sensor.received_commands.size());
+}
+
+TEST(StateCacheTest, FollowsConfigurationAcks) {
+    SimulatedSensor sensor;
+    auto w = sensor.writer();
+    SensorStateCache cache;
+    cache.populate(w, sensor.reader());
+
+    EnableConfigurationCommand enable_config;
+    enable_config.value(1);
+    cache.command(w, sensor.reader(), enable_config);
+
+    RangeSensitivityConfigurationCommand range;
+    range.distance_gate_word(0x0000);
+    range.distance_gate_value(3);
+    range.motion_sensitivity_word(0x0001);
+    range.motion_sensitivity_value(45);
+    range.static_sensitivity_word(0x0002);
+    range.static_sensitivity_value(55);
+    EXPECT_EQ(true, cache.command(w, sensor.reader(), range).has_value());
+
+    MaximumDistanceGateandUnmannedDurationParameterConfigurationCommand distances;
+    distances.maximum_moving_distance_word(0x0000);
+    distances.maximum_moving_distance_parameter(6);
+    distances.maximum_static_distance_door_word(0x0001);
+    distances.maximum_static_distance_door_parameter(7);
+    distances.no_person_duration(0x0002);
+    distances.section_unattended_duration(20);
+    EXPECT_EQ(true, cache.command(w, sensor.reader(), distances).has_value());
+
+    cache.command(w, sensor.reader(), EnableEngineeringModeCommand{});
+    cache.command(w, sensor.reader(), EndConfigurationCommand{});
+
+    EXPECT_EQ(45, cache.parameters()->motion_sensitivity[3]);
+    EXPECT_EQ(55, cache.parameters()->static_sensitivity[3]);
+    EXPECT_EQ(6, cache.parameters()->maximum_moving_distance_gate);
+    EXPECT_EQ(7, cache.parameters()->maximum_static_distance_gate);
+    EXPECT_EQ(20, cache.parameters()->no_one_duration);
+    EXPECT_EQ(true, *cache.engineering_mode());
+
+    // the cache matches what the sensor reports
+    SensorStateCache fresh;
+    fresh.populate(w, sensor.reader());
+    EXPECT_EQ(*fresh.parameters(), *cache.parameters());
+}
+
+TEST(StateCacheTest, IgnoresFailedAcks) {
+    SensorStateCache cache;
+    SensorConfig config;
+    cache.store(config);
+
+    RangeSensitivityConfigurationCommand range;
+    range.distance_gate_value(0xffff);
+    range.motion_sensitivity_value(10);
+    range.static_sensitivity_value(20);
+    RangeSensitivityConfigurationCommandAck failed;
+    failed.status(1);
+    cache.apply(range, failed);
+    EXPECT_EQ(config, *cache.parameters());
+
+    RangeSensitivityConfigurationCommandAck ok;
+    ok.status(0);
+    cache.apply(range, ok);
+    EXPECT_EQ(10, cache.parameters()->motion_sensitivity[0]);
+    EXPECT_EQ(10, cache.parameters()->motion_sensitivity[8]);
+}
+
+TEST(StateCacheTest, RestartInvalidates) {
+    SimulatedSensor sensor;
+    auto w = sensor.writer();
+    SensorStateCache cache;
+    cache.populate(w, sensor.reader());
+
+    EnableConfigurationCommand enable_config;
+    enable_config.value(1);
+    cache.command(w, sensor.reader(), enable_config);
+    cache.command(w, sensor.reader(), FactoryReset{});
+    EXPECT_EQ(false, cache.populated());
+
+    cache.populate(w, sensor.reader());
+    EXPECT_EQ(true, cache.populated());
+    cache.command(w, sensor.reader(), enable_config);
+    cache.command(w, sensor.reader(), RestartModule{});
+    EXPECT_EQ(false, cache.parameters().has_value());
+    EXPECT_EQ(false, cache.firmware().has_value());
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ld2410_subscription.h"
+#include "ld2410_arrival_stats.h"
+#include "ld2410_metrics.h"
+#include "helpers.h"
+
+using namespace ld2410;
+
+static void append_reporting_frame(std::vector<uint8_t> &bytes, uint8_t target_state, uint16_t movement_distance, uint8_t movement_energy, uint16_t detection_distance) {
+    const uint8_t frame[] = {0xF4, 0xF3, 0xF2, 0xF1, 0x0D, 0x00, 0x02, 0xAA,
+        target_state, (uint8_t)movement_distance, (uint8_t)(movement_distance >> 8), movement_energy,
+        0x00, 0x00, 0x00, (uint8_t)detection_distance, (uint8_t)(detection_distance >> 8), 0x55, 0x00,
+        0xF8, 0xF7, 0xF6, 0xF5};
+    bytes.insert(bytes.end(), frame, frame + sizeof(frame));
+}
+
+static void append_engineering_frame(std::vector<uint8_t> &bytes, uint8_t gate_energy) {
+    const uint8_t frame[] = {0xF4, 0xF3, 0xF2, 0xF1, 0x11, 0x00, 0x01, 0xAA,
+        0x01, 0x10, 0x00, 0x20, 0x00, 0x00, 0x00, 0x10, 0x00, 0x01, 0x01,
+        0x20, gate_energy, 0x00, 0x00,
+        0xF8, 0xF7, 0xF6, 0xF5};
+    bytes.insert(bytes.end(), frame, frame + sizeof(frame));
+}
+
+class RawFrameCounter: public NullDecoderObserver {
+public:
+    uint32_t frames = 0;
+
+    void frame_received(const RawFrame &) {
+        ++frames;
+    }
+};
+
+// number of frames delivered when frame i arrives at i * spacing
+static size_t count_delivered(const std::vector<uint8_t> &bytes, FrameSubscription &subscription, uint32_t spacing = 100) {
+    BufferReader r{bytes.data(), bytes.size()};
+    RawFrameCounter counter;
+    size_t delivered = 0;
+    while(r.position() < bytes.size()) {
+        if (read_subscribed<ReportingDataFrame, EngineeringModeDataFrame>(r, subscription, counter.frames * spacing, counter).has_value()) ++delivered;
+    }
+    return delivered;
+}
+
+TEST(SubscriptionTest, RawFrameDecodesLikeFullDecode) {
+    std::vector<uint8_t> bytes;
+    append_reporting_frame(bytes, 2, 300, 45, 310);
+    BufferReader raw_reader{bytes.data(), bytes.size()};
+    BufferReader full_reader{bytes.data(), bytes.size()};
+
+    auto raw = read_raw_frame<EngineeringModeDataFrame, ReportingDataFrame>(raw_reader);
+    auto full = read_from_reader<ReportingDataFrame>(full_reader);
+    EXPECT_EQ(true, raw.has_value());
+    EXPECT_EQ(true, raw->is<ReportingDataFrame>());
+    EXPECT_EQ(11, raw->size);
+
+    auto decoded = raw->decode<ReportingDataFrame>();
+    EXPECT_EQ(full->target_state(), decoded.target_state());
+    EXPECT_EQ(full->movement_target_distance(), decoded.movement_target_distance());
+    EXPECT_EQ(full->detection_distance(), decoded.detection_distance());
+    EXPECT_EQ(true, std::holds_alternative<ReportingDataFrame>(*decode_raw_frame<EngineeringModeDataFrame, ReportingDataFrame>(*raw)));
+}
+
+TEST(SubscriptionTest, ObserversSeeRawFrames) {
+    std::vector<uint8_t> bytes;
+    append_reporting_frame(bytes, 1, 100, 50, 100);
+    BufferReader r{bytes.data(), bytes.size()};
+    ArrivalTracker<> tracker;
+    DecoderMetrics metrics;
+    auto observers = observe_all(tracker, metrics);
+
+    EXPECT_EQ(true, read_raw_frame<ReportingDataFrame>(r, observers).has_value());
+    EXPECT_EQ(1, tracker.frames());
+#ifdef LD2410_METRICS
+    EXPECT_EQ(1, metrics.snapshot().frames[packet_kind_index(ReportingDataFrame::definition_type.val.val)]);
+#endif
+}
+
+TEST(SubscriptionTest, EveryFrameByDefault) {
+    std::vector<uint8_t> bytes;
+    for(int i = 0; i < 5; ++i) append_reporting_frame(bytes, 1, 100, 50, 100);
+    FrameSubscription subscription;
+
+    EXPECT_EQ(5, count_delivered(bytes, subscription));
+    EXPECT_EQ(0, subscription.suppressed());
+}
+
+TEST(SubscriptionTest, OnChangeDropsIdenticalFrames) {
+    std::vector<uint8_t> bytes;
+    for(int i = 0; i < 3; ++i) append_reporting_frame(bytes, 1, 100, 50, 100);
+    append_reporting_frame(bytes, 2, 100, 50, 100);
+    append_reporting_frame(bytes, 2, 100, 50, 100);
+    DeliveryPolicy policy;
+    policy.on_change = true;
+    FrameSubscription subscription{policy};
+
+    EXPECT_EQ(2, count_delivered(bytes, subscription));
+    EXPECT_EQ(3, subscription.suppressed());
+}
+
+TEST(SubscriptionTest, Tolerances) {
+    std::vector<uint8_t> bytes;
+    append_reporting_frame(bytes, 1, 100, 50, 100);
+    // within tolerance of the delivered frame
+    append_reporting_frame(bytes, 1, 103, 52, 97);
+    append_reporting_frame(bytes, 1, 105, 47, 95);
+    // distance drifted too far from the delivered frame
+    append_reporting_frame(bytes, 1, 106, 50, 100);
+    // energy changed too much
+    append_reporting_frame(bytes, 1, 106, 54, 100);
+    DeliveryPolicy policy;
+    policy.on_change = true;
+    policy.distance_tolerance = 5;
+    policy.energy_tolerance = 3;
+    FrameSubscription subscription{policy};
+
+    EXPECT_EQ(3, count_delivered(bytes, subscription));
+}
+
+TEST(SubscriptionTest, GateEnergyTolerance) {
+    std::vector<uint8_t> bytes;
+    append_engineering_frame(bytes, 10);
+    append_engineering_frame(bytes, 14);
+    append_engineering_frame(bytes, 16);
+    DeliveryPolicy policy;
+    policy.on_change = true;
+    policy.gate_energy_tolerance = 5;
+    FrameSubscription subscription{policy};
+
+    EXPECT_EQ(2, count_delivered(bytes, subscription));
+}
+
+TEST(SubscriptionTest, AtMostHz) {
+    std::vector<uint8_t> bytes;
+    for(int i = 0; i < 50; ++i) append_reporting_frame(bytes, 1, 100 + i, 50, 100);
+    DeliveryPolicy policy;
+    policy.at_most_hz(10);
+    FrameSubscription subscription{policy};
+
+    // a frame every 20 ms for one second
+    EXPECT_EQ(10, count_delivered(bytes, subscription, 20));
+    EXPECT_EQ(40, subscription.suppressed());
+}
+
+TEST(SubscriptionTest, MaxIntervalDeliversUnchangedFrames) {
+    std::vector<uint8_t> bytes;
+    for(int i = 0; i < 10; ++i) append_reporting_frame(bytes, 1, 100, 50, 100);
+    DeliveryPolicy policy;
+    policy.on_change = true;
+    policy.max_interval = 300;
+    FrameSubscription subscription{policy};
+
+    // delivered at 0, 300 and 600 ms
+    EXPECT_EQ(4, count_delivered(bytes, subscription));
+}
+
+TEST(SubscriptionTest, AcksAlwaysPass) {
+    InMemoryReader r{{0xFD, 0xFC, 0xFB, 0xFA, 0x04, 0x00, 0xFE, 0x01, 0x00, 0x00, 0x04, 0x03, 0x02, 0x01,
+        0xFD, 0xFC, 0xFB, 0xFA, 0x04, 0x00, 0xFE, 0x01, 0x00, 0x00, 0x04, 0x03, 0x02, 0x01}};
+    DeliveryPolicy policy;
+    policy.on_change = true;
+    FrameSubscription subscription{policy};
+
+    size_t delivered = 0;
+    for(int i = 0; i < 6; ++i) {
+        if (read_subscribed<EndConfigurationCommandAck>(r, subscription, 0).has_value()) ++delivered;
+    }
+    EXPECT_EQ(2, delivered);
+}
@@ -9,6 +9,16 @@
 #include "packet_reader_test.h"
 #include "packet_writer_test.h"
 #include "packet_write_and_read_ack.h"
+#include "metrics_test.h"
+#include "arrival_stats_test.h"
+#include "subscription_test.h"
+#include "packet_views_test.h"
+#include "round_trip_test.h"
+#include "gate_bounds_test.h"
+#include "frame_assembler_test.h"
+#include "dispatch_test.h"
+#include "window_test.h"
+#include "zones_test.h"
 
 void setup()
 {
@@ -33,6 +43,32 @@ void loop()
 }
 
 #else
+#include "decode_pipeline_test.h"
+#include "broadcast_ring_test.h"
+#include "zero_alloc_test.h"
+#include "baud_negotiation_test.h"
+#include "metrics_test.h"
+#include "openmetrics_test.h"
+#include "serialize_test.h"
+#include "arrival_stats_test.h"
+#include "watchdog_test.h"
+#include "config_sync_test.h"
+#include "state_cache_test.h"
+#include "subscription_test.h"
+#include "packet_views_test.h"
+#include "round_trip_test.h"
+#include "gate_bounds_test.h"
+#include "shared_frames_test.h"
+#include "frame_assembler_test.h"
+#include "serial_transport_test.h"
+#include "sharded_runtime_test.h"
+#include "fleet_config_test.h"
+#include "discovery_test.h"
+#include "dispatch_test.h"
+#include "window_test.h"
+#include "calibration_test.h"
+#include "zones_test.h"
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
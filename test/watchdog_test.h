@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+#include "ld2410_watchdog.h"
+#include "simulated_sensor.h"
+
+using namespace ld2410;
+
+// decodes whatever the sensor sends and polls the watchdog every 10 ms until `until`
+template <typename TWatchdog>
+void run_watchdog(SimulatedSensor &sensor, TWatchdog &watchdog, uint32_t &now, uint32_t until) {
+    auto r = sensor.reader();
+    for(; now < until; now += 10) {
+        for(int i = 0; i < 4; ++i) {
+            read_from_reader<ReportingDataFrame, EngineeringModeDataFrame>(r, watchdog);
+        }
+        watchdog.poll(now);
+    }
+}
+
+static bool watchdog_sent(const SimulatedSensor &sensor, uint16_t type) {
+    return std::find(sensor.received_commands.begin(), sensor.received_commands.end(), type) != sensor.received_commands.end();
+}
+
+TEST(WatchdogTest, StaysHealthyWhileFramesArrive) {
+    SimulatedSensor sensor;
+    auto w = sensor.writer();
+    uint32_t now = 0;
+    SensorWatchdog watchdog{w, [&](uint32_t bps) { sensor.set_local_baud(bps); }, BaudRate::BaudRate_256000, now};
+
+    run_watchdog(sensor, watchdog, now, 5000);
+
+    EXPECT_EQ(WatchdogState::healthy, watchdog.state());
+    EXPECT_EQ(0, watchdog.recoveries());
+    EXPECT_EQ(true, sensor.received_commands.empty());
+}
+
+TEST(WatchdogTest, EndsStuckConfiguration) {
+    SimulatedSensor sensor;
+    sensor.config_mode = true;
+    auto w = sensor.writer();
+    uint32_t now = 0;
+    SensorWatchdog watchdog{w, [&](uint32_t bps) { sensor.set_local_baud(bps); }, BaudRate::BaudRate_256000, now};
+
+    run_watchdog(sensor, watchdog, now, 990);
+    EXPECT_EQ(WatchdogState::healthy, watchdog.state());
+    EXPECT_EQ(true, sensor.received_commands.empty());
+
+    run_watchdog(sensor, watchdog, now, 1500);
+    EXPECT_EQ(WatchdogState::healthy, watchdog.state());
+    EXPECT_EQ(1, watchdog.recoveries());
+    EXPECT_EQ(std::vector<uint16_t>{0x00fe}, sensor.received_commands);
+    EXPECT_EQ(0, sensor.restarts);
+}
+
+TEST(WatchdogTest, RestartsHungModule) {
+    SimulatedSensor sensor;
+    sensor.hung = true;
+    auto w = sensor.writer();
+    uint32_t now = 0;
+    SensorWatchdog watchdog{w, [&](uint32_t bps) { sensor.set_local_baud(bps); }, BaudRate::BaudRate_256000, now};
+
+    run_watchdog(sensor, watchdog, now, 3000);
+
+    EXPECT_EQ(WatchdogState::healthy, watchdog.state());
+    EXPECT_EQ(1, watchdog.recoveries());
+    EXPECT_EQ(1, sensor.restarts);
+    EXPECT_EQ(false, sensor.hung);
+}
+
+TEST(WatchdogTest, RescansBaudRate) {
+    SimulatedSensor sensor;
+    sensor.baud = BaudRate::BaudRate_115200;
+    auto w = sensor.writer();
+    uint32_t now = 0;
+    SensorWatchdog watchdog{w, [&](uint32_t bps) { sensor.set_local_baud(bps); }, BaudRate::BaudRate_256000, now};
+
+    run_watchdog(sensor, watchdog, now, 5000);
+
+    EXPECT_EQ(WatchdogState::healthy, watchdog.state());
+    EXPECT_EQ(BaudRate::BaudRate_115200, watchdog.baud_rate());
+    EXPECT_EQ(115200, sensor.local_bps);
+    EXPECT_EQ(0, sensor.restarts);
+    EXPECT_EQ(false, watchdog_sent(sensor, 0x00a3));
+}
+
+TEST(WatchdogTest, BacksOffExponentially) {
+    class NullWriter {
+    public:
+        void operator()(const uint8_t *, size_t) {}
+    } w;
+    uint32_t local_bps = 256000;
+    WatchdogOptions options;
+    options.backoff_max = 3000;
+    SensorWatchdog watchdog{w, [&](uint32_t bps) { local_bps = bps; }, BaudRate::BaudRate_256000, 0, options};
+
+    EXPECT_EQ(WatchdogState::healthy, watchdog.poll(999));
+    EXPECT_EQ(WatchdogState::ending_config, watchdog.poll(1000));
+    EXPECT_EQ(WatchdogState::restarting, watchdog.poll(1500));
+    EXPECT_EQ(WatchdogState::rescanning, watchdog.poll(3000));
+    EXPECT_EQ(256000, local_bps);
+    EXPECT_EQ(WatchdogState::rescanning, watchdog.poll(3500));
+    EXPECT_EQ(115200, local_bps);
+
+    uint32_t now = 3500;
+    while(watchdog.poll(now) == WatchdogState::rescanning) now += 500;
+    EXPECT_EQ(7000, now);
+    EXPECT_EQ(WatchdogState::backing_off, watchdog.state());
+    // no rate worked, back to the last one that did
+    EXPECT_EQ(256000, local_bps);
+
+    EXPECT_EQ(WatchdogState::backing_off, watchdog.poll(7999));
+    EXPECT_EQ(WatchdogState::ending_config, watchdog.poll(8000));
+    EXPECT_EQ(2000, watchdog.backoff());
+
+    // the second round waits twice as long, the third is capped
+    for(now = 8000; watchdog.poll(now) != WatchdogState::backing_off; now += 10);
+    EXPECT_EQ(14000, now);
+    EXPECT_EQ(WatchdogState::backing_off, watchdog.poll(15999));
+    EXPECT_EQ(WatchdogState::ending_config, watchdog.poll(16000));
+    EXPECT_EQ(3000, watchdog.backoff());
+
+    watchdog.feed();
+    EXPECT_EQ(WatchdogState::healthy, watchdog.poll(16010));
+    EXPECT_EQ(1000, watchdog.backoff());
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ld2410_window.h"
+
+using namespace ld2410;
+
+inline ReportingDataFrame window_reporting_frame(uint8_t target_state, uint16_t distance) {
+    ReportingDataFrame frame{};
+    frame.target_state(target_state);
+    frame.detection_distance(distance);
+    return frame;
+}
+
+TEST(WindowTest, EnergySketchPercentilesAndMerge) {
+    EnergySketch<> low, high, all;
+    for(uint8_t v = 0; v <= 100; ++v) {
+        (v < 50 ? low : high).add(v);
+        all.add(v);
+    }
+    low.merge(high);
+
+    for(uint8_t p : {0, 10, 50, 90, 100}) {
+        EXPECT_EQ(all.percentile(p), low.percentile(p));
+        EXPECT_NEAR(p, all.percentile(p), 2);
+    }
+    EXPECT_EQ(0, all.percentile(0));
+    EXPECT_EQ(100, all.percentile(100));
+    EXPECT_EQ(101, low.count());
+
+    EnergySketch<> constant;
+    for(int i = 0; i < 10; ++i) constant.add(0);
+    EXPECT_EQ(0, constant.percentile(50));
+    EXPECT_EQ(0, EnergySketch<>{}.percentile(50));
+}
+
+TEST(WindowTest, EnergySketchHalvesFullBuckets) {
+    // three quarters 20, one quarter 80, more than a bucket holds
+    EnergySketch<> sketch;
+    for(uint32_t i = 0; i < 100000; ++i) {
+        sketch.add(i % 4 != 0 ? 20 : 80);
+    }
+    EXPECT_GT(sketch.count(), 0xffff / 2);
+    EXPECT_LT(sketch.count(), 100000);
+    EXPECT_NEAR(20, sketch.percentile(75), 2);
+    EXPECT_NEAR(80, sketch.percentile(76), 2);
+
+    EnergySketch<> merged = sketch;
+    merged.merge(sketch);
+    EXPECT_EQ(sketch.percentile(75), merged.percentile(75));
+    EXPECT_EQ(sketch.percentile(76), merged.percentile(76));
+    EXPECT_EQ(20, merged.lowest());
+    EXPECT_EQ(80, merged.highest());
+}
+
+TEST(WindowTest, WindowsHoldOnlyTheirPanes) {
+    EXPECT_EQ(60, sizeof(EnergySketch<>));
+    EXPECT_EQ(36 + 18 * sizeof(EnergySketch<>), sizeof(WindowSummary));
+    EXPECT_GE(sizeof(WindowSummary) + 32, sizeof(TumblingWindow));
+    EXPECT_GE(6 * sizeof(WindowSummary) + 32, sizeof(SlidingWindow<6>));
+}
+
+TEST(WindowTest, TumblingWindows) {
+    TumblingWindow window{1000};
+    std::vector<WindowSummary> closed;
+    auto on_window = [&](const WindowSummary &summary) { closed.push_back(summary); };
+
+    // 10 Hz, a target at 100 to 190 cm during the first second only
+    for(uint32_t now = 0; now < 2500; now += 100) {
+        bool present = now < 1000;
+        window.add(now, window_reporting_frame(present ? 1 : 0, present ? 100 + now / 10 : 0), on_window);
+    }
+
+    ASSERT_EQ(2, closed.size());
+    EXPECT_EQ(0, closed[0].start());
+    EXPECT_EQ(1000, closed[0].end());
+    EXPECT_EQ(10, closed[0].frames());
+    EXPECT_EQ(1000, closed[0].occupied_permille());
+    EXPECT_EQ(10, closed[0].moving_frames());
+    EXPECT_EQ(100, closed[0].min_distance());
+    EXPECT_EQ(145, closed[0].mean_distance());
+    EXPECT_EQ(190, closed[0].max_distance());
+
+    EXPECT_EQ(10, closed[1].frames());
+    EXPECT_EQ(0, closed[1].occupied_permille());
+    EXPECT_EQ(0, closed[1].min_distance());
+}
+
+TEST(WindowTest, SlidingWindowsMergePanes) {
+    // more than a few KB, too much for the loop stack of an ESP8266
+    std::unique_ptr<SlidingWindow<3>> window{new SlidingWindow<3>{1000}};
+    std::vector<WindowSummary> closed;
+    auto on_window = [&](const WindowSummary &summary) { closed.push_back(summary); };
+
+    // one stationary frame per second with a target, the clock wraps half way
+    uint32_t start = 0xffffffff - 2500;
+    for(uint32_t i = 0; i < 6; ++i) {
+        window->add(start + i * 1000, window_reporting_frame(2, 100 * (i + 1)), on_window);
+        window->add(start + i * 1000 + 500, window_reporting_frame(0, 0), on_window);
+    }
+    window->advance(start + 6000, on_window);
+
+    // panes close at 1000 to 6000, windows from the third pane on
+    ASSERT_EQ(4, closed.size());
+    for(size_t i = 0; i < closed.size(); ++i) {
+        EXPECT_EQ(start + (uint32_t)i * 1000, closed[i].start());
+        EXPECT_EQ(start + (uint32_t)(i + 3) * 1000, closed[i].end());
+        EXPECT_EQ(6, closed[i].frames());
+        EXPECT_EQ(3, closed[i].stationary_frames());
+        EXPECT_EQ(500, closed[i].occupied_permille());
+        EXPECT_EQ(100 * (i + 1), closed[i].min_distance());
+        EXPECT_EQ(100 * (i + 3), closed[i].max_distance());
+    }
+}
+
+TEST(WindowTest, GateEnergiesAndIdleGaps) {
+    TumblingWindow window{1000};
+    std::vector<WindowSummary> closed;
+    auto on_window = [&](const WindowSummary &summary) { closed.push_back(summary); };
+
+    EngineeringModeDataFrame frame{};
+    frame.target_state(1);
+    frame.maximum_moving_distance_gate_n(1);
+    frame.maximum_static_distance_gate_n(1);
+    for(uint8_t i = 0; i < 10; ++i) {
+        frame.movement_distance_gate_energy_value({(uint8_t)(i * 10), 100});
+        frame.static_distance_gate_energy_value({0, 0});
+        window.add(i * 100, frame, on_window);
+    }
+
+    // no frames for a minute, then one more
+    window.add(61000, window_reporting_frame(0, 0), on_window);
+    window.advance(62000, on_window);
+
+    ASSERT_EQ(2, closed.size());
+    EXPECT_EQ(10, closed[0].engineering_frames());
+    EXPECT_NEAR(40, closed[0].movement_energy(0).percentile(50), 2);
+    EXPECT_EQ(90, closed[0].movement_energy(0).highest());
+    EXPECT_EQ(100, closed[0].movement_energy(1).percentile(10));
+    EXPECT_EQ(0, closed[0].static_energy(1).percentile(90));
+    EXPECT_EQ(0, closed[0].movement_energy(2).count());
+
+    // the gap is not reported, panes stay aligned to the first frame
+    EXPECT_EQ(61000, closed[1].start());
+    EXPECT_EQ(62000, closed[1].end());
+    EXPECT_EQ(1, closed[1].frames());
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#ifdef LD2410_ZERO_ALLOC
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ld2410.h"
+#include "ld2410_serialize.h"
+
+using namespace ld2410;
+
+// Global allocation hook, only counts while a test has armed it.
+static std::atomic<bool> allocation_hook_armed{false};
+static std::atomic<size_t> allocation_hook_count{0};
+
+void *operator new(size_t size) {
+    if (allocation_hook_armed.load()) allocation_hook_count.fetch_add(1);
+    void *p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) throw std::bad_alloc{};
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+class AllocationGuard {
+public:
+    AllocationGuard() {
+        allocation_hook_count = 0;
+        allocation_hook_armed = true;
+    }
+
+    ~AllocationGuard() {
+        allocation_hook_armed = false;
+    }
+
+    size_t count() const {
+        return allocation_hook_count.load();
+    }
+};
+
+class FixedBufferWriter {
+public:
+    std::array<uint8_t, 64> m_data{};
+    size_t m_size = 0;
+
+    void operator()(const uint8_t *data, size_t size) {
+        for(size_t i = 0; i < size && m_size < m_data.size(); i++) {
+            m_data[m_size++] = data[i];
+        }
+    }
+};
+
+TEST(ZeroAllocTest, DecodeFrames) {
+    const std::vector<uint8_t> data{0xF4, 0xF3, 0xF2, 0xF1, 0x0D, 0x00, 0x02, 0xAA, 0x02, 0x51, 0x01, 0x00, 0x00, 0x00, 0x3B, 0x00, 0x00, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5,
+        0xF4, 0xF3, 0xF2, 0xF1, 0x23, 0x00, 0x01, 0xAA, 0x03, 0x1E, 0x00, 0x3C, 0x00, 0x00, 0x39, 0x00, 0x00, 0x08, 0x08, 0x3C, 0x22, 0x05, 0x03, 0x03, 0x04, 0x03, 0x06, 0x05, 0x00, 0x00, 0x39, 0x10, 0x13, 0x06, 0x06, 0x08, 0x04, 0x03, 0x05, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5};
+    BufferReader r{data.data(), data.size()};
+    size_t decoded = 0;
+
+    AllocationGuard guard;
+    for(size_t i = 0; i < 20; ++i) {
+        auto packet = read_from_reader<EngineeringModeDataFrame, ReportingDataFrame>(r);
+        if (packet.has_value()) ++decoded;
+    }
+    size_t allocations = guard.count();
+
+    EXPECT_EQ(2, decoded);
+    EXPECT_EQ(0, allocations);
+}
+
+TEST(ZeroAllocTest, EncodeCommands) {
+    FixedBufferWriter w;
+
+    AllocationGuard guard;
+    RangeSensitivityConfigurationCommand range;
+    range.distance_gate_value(3);
+    write_to_writer(w, range);
+    write_to_writer(w, EndConfigurationCommand{});
+    size_t allocations = guard.count();
+
+    EXPECT_EQ(42, w.m_size);
+    EXPECT_EQ(0, allocations);
+}
+
+TEST(ZeroAllocTest, WriteAndReadAck) {
+    const std::vector<uint8_t> data{0xFD, 0xFC, 0xFB, 0xFA, 0x08, 0x00, 0xFF, 0x01, 0x00, 0x00, 0x01, 0x00, 0x40, 0x00, 0x04, 0x03, 0x02, 0x01};
+    BufferReader r{data.data(), data.size()};
+    FixedBufferWriter w;
+    EnableConfigurationCommand enable_config;
+    enable_config.value(1);
+
+    AllocationGuard guard;
+    auto ack = write_and_read_ack(w, r, enable_config, 100);
+    size_t allocations = guard.count();
+
+    EXPECT_EQ(true, ack.has_value());
+    EXPECT_EQ(0, allocations);
+}
+
+TEST(ZeroAllocTest, SerializeFrames) {
+    EngineeringModeDataFrame frame{};
+    frame.maximum_moving_distance_gate_n(8);
+    frame.maximum_static_distance_gate_n(8);
+    frame.movement_distance_gate_energy_value({1, 2, 3, 4, 5, 6, 7, 8, 9});
+    frame.static_distance_gate_energy_value({9, 8, 7, 6, 5, 4, 3, 2, 1});
+    char json[512];
+    uint8_t msgpack[512];
+
+    AllocationGuard guard;
+    size_t json_size = write_json(frame, json, sizeof(json));
+    size_t msgpack_size = write_msgpack(frame, msgpack, sizeof(msgpack));
+    size_t allocations = guard.count();
+
+    EXPECT_NE(0, json_size);
+    EXPECT_NE(0, msgpack_size);
+    EXPECT_EQ(0, allocations);
+}
+
+#endif
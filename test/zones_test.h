@@ -0,0 +1,105 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ld2410_zones.h"
+
+using namespace ld2410;
+
+using ZoneTransitions = std::vector<std::pair<size_t, bool>>;
+
+inline EngineeringModeDataFrame zone_frame(std::initializer_list<uint8_t> movement, std::initializer_list<uint8_t> stationary) {
+    EngineeringModeDataFrame frame{};
+    frame.maximum_moving_distance_gate_n(movement.size() - 1);
+    frame.maximum_static_distance_gate_n(stationary.size() - 1);
+    frame.movement_distance_gate_energy_value(movement);
+    frame.static_distance_gate_energy_value(stationary);
+    return frame;
+}
+
+inline SensorConfig zone_thresholds() {
+    SensorConfig thresholds;
+    thresholds.motion_sensitivity = {50, 50, 40, 30, 20, 15, 15, 15, 15};
+    thresholds.static_sensitivity = {0, 0, 40, 40, 30, 30, 20, 20, 20};
+    return thresholds;
+}
+
+TEST(ZonesTest, ReportsTransitionsOnly) {
+    Zone desk;
+    desk.first_gate = 0;
+    desk.last_gate = 1;
+    Zone couch = zone_from_distances(150, 299);
+    couch.moving = false;
+    Zone door = zone_from_distances(375, 600);
+
+    ZoneMap map{{desk, couch, door}, zone_thresholds()};
+    ZoneTracker tracker{map};
+    ZoneTransitions transitions;
+    auto on_transition = [&](size_t zone, bool occupied) { transitions.push_back({zone, occupied}); };
+
+    // quiet room
+    tracker.update(zone_frame({10, 10, 10, 10, 10, 10, 10, 10, 10}, {0, 0, 10, 10, 10, 10, 10, 10, 10}), on_transition);
+    EXPECT_EQ(ZoneTransitions{}, transitions);
+
+    // someone walks in at the door, twice the same frame
+    auto walking = zone_frame({10, 10, 10, 10, 10, 60, 10, 10, 10}, {0, 0, 10, 10, 10, 10, 10, 10, 10});
+    tracker.update(walking, on_transition);
+    tracker.update(walking, on_transition);
+    EXPECT_EQ((ZoneTransitions{{2, true}}), transitions);
+
+    // and sits down on the couch, moving energy there does not count
+    transitions.clear();
+    tracker.update(zone_frame({10, 10, 90, 10, 10, 10, 10, 10, 10}, {0, 0, 10, 70, 10, 10, 10, 10, 10}), on_transition);
+    EXPECT_EQ((ZoneTransitions{{1, true}, {2, false}}), transitions);
+    EXPECT_EQ(false, tracker.occupied(0));
+    EXPECT_EQ(true, tracker.occupied(1));
+    EXPECT_EQ(false, tracker.occupied(2));
+}
+
+TEST(ZonesTest, ReportingFramesUseTargetDistances) {
+    ZoneMap map{{zone_from_distances(0, 149), zone_from_distances(150, 674)}, zone_thresholds()};
+    ZoneTracker tracker{map};
+    ZoneTransitions transitions;
+    auto on_transition = [&](size_t zone, bool occupied) { transitions.push_back({zone, occupied}); };
+
+    ReportingDataFrame frame{};
+    frame.target_state(2);
+    frame.stationary_target_distance(100);
+    tracker.update(frame, on_transition);
+
+    frame.target_state(1);
+    frame.movement_target_distance(400);
+    tracker.update(frame, on_transition);
+
+    frame.target_state(0);
+    tracker.update(frame, on_transition);
+
+    EXPECT_EQ((ZoneTransitions{{0, true}, {0, false}, {1, true}, {1, false}}), transitions);
+}
+
+TEST(ZonesTest, ManyZonesAcrossWords) {
+    // zone z covers gate z % 9 only
+    std::vector<Zone> zones(1000);
+    for(size_t z = 0; z < zones.size(); ++z) {
+        zones[z].first_gate = z % 9;
+        zones[z].last_gate = z % 9;
+    }
+    ZoneMap map{zones, zone_thresholds()};
+    EXPECT_EQ(16, map.words());
+
+    ZoneTracker tracker{map};
+    std::vector<size_t> occupied;
+    tracker.update(zone_frame({10, 10, 10, 10, 10, 10, 10, 99, 10}, {0, 0, 0, 0, 0, 0, 0, 0, 0}), [&](size_t zone, bool state) {
+        EXPECT_EQ(true, state);
+        occupied.push_back(zone);
+    });
+
+    ASSERT_EQ(111, occupied.size());
+    for(size_t zone : occupied) {
+        EXPECT_EQ(7, zone % 9);
+    }
+    EXPECT_EQ(true, tracker.occupied(997));
+    EXPECT_EQ(false, tracker.occupied(998));
+}